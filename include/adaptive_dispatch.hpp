@@ -0,0 +1,263 @@
+// Adaptive dispatch over heterogeneous RuntimeBase populations. A dispatcher
+// represents one call site: it samples the dynamic types it sees and switches
+// between plain virtual calls, a guarded fast path that inlines the dominant
+// type, and sort-then-batch execution.
+
+#pragma once
+
+#include "concepts_polymorphism.hpp"
+#include "crtp_polymorphism.hpp"
+#include "runtime_polymorphism.hpp"
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace adaptive_dispatch {
+
+using runtime_polymorphism::RuntimeBase;
+
+// One call: an object and its argument
+struct DispatchItem {
+  const RuntimeBase *object;
+  double x;
+};
+
+enum class Strategy { kVirtual, kGuarded, kSortedBatch };
+
+std::string StrategyName(Strategy strategy);
+
+// Maps a runtime type to a header-inline value type with the same Compute,
+// which the guarded and batched paths call directly so it can be inlined.
+template <typename T>
+struct StaticCounterpart;
+
+template <>
+struct StaticCounterpart<runtime_polymorphism::PolyFMA> {
+  using type = crtp_polymorphism::PolyFMA;
+};
+
+template <>
+struct StaticCounterpart<runtime_polymorphism::PolyExpensive> {
+  using type = crtp_polymorphism::PolyExpensive;
+};
+
+template <typename T>
+concept Devirtualizable =
+    std::derived_from<T, RuntimeBase> &&
+    requires { typename StaticCounterpart<T>::type; } &&
+    concepts_polymorphism::Computable<typename StaticCounterpart<T>::type>;
+
+template <Devirtualizable T>
+inline double StaticCompute(double x) {
+  return typename StaticCounterpart<T>::type{}.Compute(x);
+}
+
+// Type checks compare vtable pointers rather than typeid: on libstdc++ a
+// typeid mismatch can fall back to comparing the mangled names with strcmp.
+// Itanium ABI: the vptr is the first word of the object.
+inline const void *VptrOf(const RuntimeBase &object) {
+  return *reinterpret_cast<const void *const *>(&object);
+}
+
+// T's vtable, read once from a default-constructed T
+template <Devirtualizable T>
+const void *VtableOf() {
+  static const void *const vtable = [] {
+    T object;
+    return VptrOf(object);
+  }();
+  return vtable;
+}
+
+template <size_t N>
+using VtableList = std::array<const void *, N>;
+
+template <Devirtualizable... Ts>
+VtableList<sizeof...(Ts)> VtablesOf() {
+  return {VtableOf<Ts>()...};
+}
+
+// Index of the object's vtable in vtables, or N if not listed
+template <size_t N>
+size_t TypeIndex(const VtableList<N> &vtables, const RuntimeBase &object) {
+  const void *vptr = VptrOf(object);
+  size_t index = 0;
+  while (index < N && vtables[index] != vptr) {
+    ++index;
+  }
+  return index;
+}
+
+// Index of the object's dynamic type in Ts, or sizeof...(Ts) if not listed
+template <Devirtualizable... Ts>
+size_t TypeIndex(const RuntimeBase &object) {
+  return TypeIndex(VtablesOf<Ts...>(), object);
+}
+
+// Calls visit.template operator()<T>() for the index-th type of Ts
+template <Devirtualizable... Ts, typename Visitor>
+void VisitTypeAt(size_t index, Visitor &&visit) {
+  [&]<size_t... Is>(std::index_sequence<Is...>) {
+    ((Is == index ? (visit.template operator()<Ts>(), 0) : 0), ...);
+  }(std::index_sequence_for<Ts...>{});
+}
+
+// ===========================
+// STATIC STRATEGIES
+// ===========================
+
+double EvaluateVirtual(std::span<const DispatchItem> items);
+
+// Inlines T behind a type check, everything else goes through the vtable
+template <Devirtualizable T>
+double EvaluateGuarded(std::span<const DispatchItem> items) {
+  const void *guard = VtableOf<T>();
+  double sum = 0.0;
+  for (const auto &item : items) {
+    if (VptrOf(*item.object) == guard) {
+      sum += StaticCompute<T>(item.x);
+    } else {
+      sum += item.object->Compute(item.x);
+    }
+  }
+  return sum;
+}
+
+// Buckets items by dynamic type, then runs one inlined loop per type
+template <Devirtualizable... Ts>
+class SortedBatcher {
+public:
+  double Evaluate(std::span<const DispatchItem> items) {
+    for (auto &bucket : buckets_) {
+      bucket.clear();
+    }
+    others_.clear();
+    for (const auto &item : items) {
+      size_t index = TypeIndex(vtables_, *item.object);
+      if (index < sizeof...(Ts)) {
+        buckets_[index].push_back(item.x);
+      } else {
+        others_.push_back(item);
+      }
+    }
+
+    double sum = 0.0;
+    [&]<size_t... Is>(std::index_sequence<Is...>) {
+      ((sum += SumBucket<Ts>(buckets_[Is])), ...);
+    }(std::index_sequence_for<Ts...>{});
+    return sum + EvaluateVirtual(others_);
+  }
+
+private:
+  template <Devirtualizable T>
+  static double SumBucket(const std::vector<double> &xs) {
+    double sum = 0.0;
+    for (double x : xs) {
+      sum += StaticCompute<T>(x);
+    }
+    return sum;
+  }
+
+  VtableList<sizeof...(Ts)> vtables_ = VtablesOf<Ts...>();
+  std::array<std::vector<double>, sizeof...(Ts)> buckets_;
+  std::vector<DispatchItem> others_;
+};
+
+// ===========================
+// ADAPTIVE DISPATCHER
+// ===========================
+
+struct AdaptiveConfig {
+  size_t sample_stride = 61; // sample every Nth item (prime avoids aliasing)
+  size_t samples_per_decision = 512;
+  double guard_threshold = 0.9; // dominant share that selects kGuarded
+  double batch_threshold = 0.5; // listed-type share that selects kSortedBatch
+};
+
+template <Devirtualizable... Ts>
+class AdaptiveDispatcher {
+public:
+  explicit AdaptiveDispatcher(AdaptiveConfig config = {}) : config_(config) {}
+
+  double Evaluate(std::span<const DispatchItem> items) {
+    Sample(items);
+
+    switch (strategy_) {
+    case Strategy::kGuarded: {
+      double sum = 0.0;
+      VisitTypeAt<Ts...>(dominant_index_, [&]<typename T>() {
+        sum = EvaluateGuarded<T>(items);
+      });
+      return sum;
+    }
+    case Strategy::kSortedBatch:
+      return batcher_.Evaluate(items);
+    case Strategy::kVirtual:
+      break;
+    }
+    return EvaluateVirtual(items);
+  }
+
+  Strategy strategy() const { return strategy_; }
+  size_t dominant_index() const { return dominant_index_; }
+  size_t num_switches() const { return num_switches_; }
+
+private:
+  void Sample(std::span<const DispatchItem> items) {
+    for (; next_sample_ < items.size(); next_sample_ += config_.sample_stride) {
+      ++histogram_[TypeIndex(vtables_, *items[next_sample_].object)];
+      if (++num_samples_ == config_.samples_per_decision) {
+        Decide();
+      }
+    }
+    next_sample_ -= items.size();
+  }
+
+  void Decide() {
+    size_t dominant = 0;
+    size_t listed = 0;
+    for (size_t i = 0; i < sizeof...(Ts); ++i) {
+      listed += histogram_[i];
+      if (histogram_[i] > histogram_[dominant]) {
+        dominant = i;
+      }
+    }
+
+    auto total = static_cast<double>(num_samples_);
+    Strategy next = Strategy::kVirtual;
+    if (histogram_[dominant] >= config_.guard_threshold * total) {
+      next = Strategy::kGuarded;
+    } else if (listed >= config_.batch_threshold * total) {
+      next = Strategy::kSortedBatch;
+    }
+
+    if (next != strategy_ ||
+        (next == Strategy::kGuarded && dominant != dominant_index_)) {
+      ++num_switches_;
+    }
+    strategy_ = next;
+    dominant_index_ = dominant;
+    histogram_.fill(0);
+    num_samples_ = 0;
+  }
+
+  AdaptiveConfig config_;
+  VtableList<sizeof...(Ts)> vtables_ = VtablesOf<Ts...>();
+  Strategy strategy_ = Strategy::kVirtual;
+  size_t dominant_index_ = 0;
+  size_t num_switches_ = 0;
+  std::array<size_t, sizeof...(Ts) + 1> histogram_{};
+  size_t num_samples_ = 0;
+  size_t next_sample_ = 0;
+  SortedBatcher<Ts...> batcher_;
+};
+
+// Benchmarks static strategies against AdaptiveDispatcher while the type mix
+// of a FMA/Expensive population shifts between phases
+void RunAdaptiveDispatchBenchmark(size_t iterations);
+
+} // namespace adaptive_dispatch
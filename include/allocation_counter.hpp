@@ -0,0 +1,34 @@
+// Counts of global operator new calls. The replacement operator new/delete
+// in allocation_counter.cpp is linked into every binary built from
+// SRC_FILES, but it only counts on a thread while a ScopedAllocationCounting
+// is alive there. Other code pays one thread-local check per allocation and
+// never touches shared counters.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+struct AllocationCounters {
+  uint64_t allocations;
+  uint64_t bytes_requested;
+};
+
+// Counts the calling thread's allocations for the lifetime of the object.
+// Nests: the outer scope keeps counting after an inner one ends.
+class ScopedAllocationCounting {
+public:
+  ScopedAllocationCounting();
+  ~ScopedAllocationCounting();
+
+  ScopedAllocationCounting(const ScopedAllocationCounting &) = delete;
+  ScopedAllocationCounting &
+  operator=(const ScopedAllocationCounting &) = delete;
+
+private:
+  bool was_counting_;
+};
+
+// The calling thread's totals over every counting scope so far (take deltas
+// around the work)
+AllocationCounters GetAllocationCounters();
@@ -0,0 +1,322 @@
+// Tunable-precision approximations of sin, log and sqrt used by the
+// ComputeExpensiveApprox kernels. Lookup tables and polynomial coefficients
+// are generated at compile time (consteval), so every accuracy level is a
+// set of constants that the compiler can inline and fold.
+//
+// Polynomials are interpolants at Chebyshev nodes, which are within a small
+// factor of the true minimax error for the low degrees used here.
+//
+// Domains: ApproxSin is accurate for |x| up to ~1e5, ApproxLog needs a
+// positive normal x, and ApproxSqrt needs x >= 0.
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <utility>
+
+enum class Accuracy { kLow, kMedium, kHigh };
+
+std::string AccuracyName(Accuracy accuracy);
+
+// Table sizes (log2 of entries), polynomial degrees and Newton steps for each
+// accuracy level. kHigh targets 1e-7 error in ComputeExpensiveApprox.
+template <Accuracy A>
+struct ApproxConfig;
+
+template <>
+struct ApproxConfig<Accuracy::kLow> {
+  static constexpr int kSinTableBits = 3;
+  static constexpr size_t kSinDegree = 3;
+  static constexpr size_t kCosDegree = 2;
+  static constexpr int kLogTableBits = 3;
+  static constexpr size_t kLogDegree = 2;
+  static constexpr int kSqrtNewtonSteps = 1;
+};
+
+template <>
+struct ApproxConfig<Accuracy::kMedium> {
+  static constexpr int kSinTableBits = 4;
+  static constexpr size_t kSinDegree = 3;
+  static constexpr size_t kCosDegree = 2;
+  static constexpr int kLogTableBits = 4;
+  static constexpr size_t kLogDegree = 2;
+  static constexpr int kSqrtNewtonSteps = 2;
+};
+
+template <>
+struct ApproxConfig<Accuracy::kHigh> {
+  static constexpr int kSinTableBits = 5;
+  static constexpr size_t kSinDegree = 3;
+  static constexpr size_t kCosDegree = 4;
+  static constexpr int kLogTableBits = 5;
+  static constexpr size_t kLogDegree = 3;
+  static constexpr int kSqrtNewtonSteps = 3;
+};
+
+namespace approx_detail {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kLn2 = 0.69314718055994530942;
+
+// Compile-time reference implementations (series expansions), only used to
+// build tables and coefficients.
+
+consteval double ConstSin(double x) {
+  while (x > kPi) {
+    x -= 2 * kPi;
+  }
+  while (x < -kPi) {
+    x += 2 * kPi;
+  }
+  double term = x;
+  double sum = x;
+  for (int n = 1; n < 30; ++n) {
+    term *= -x * x / ((2 * n) * (2 * n + 1));
+    sum += term;
+  }
+  return sum;
+}
+
+consteval double ConstCos(double x) { return ConstSin(x + kPi / 2); }
+
+// log(x) = e * ln2 + 2 * atanh((m - 1) / (m + 1)), m in [1, 2)
+consteval double ConstLog(double x) {
+  int exponent = 0;
+  while (x >= 2.0) {
+    x /= 2.0;
+    ++exponent;
+  }
+  while (x < 1.0) {
+    x *= 2.0;
+    --exponent;
+  }
+  double z = (x - 1) / (x + 1);
+  double term = z;
+  double sum = 0.0;
+  for (int n = 0; n < 60; ++n) {
+    sum += term / (2 * n + 1);
+    term *= z * z;
+  }
+  return exponent * kLn2 + 2 * sum;
+}
+
+consteval double ConstLog1p(double r) { return ConstLog(1.0 + r); }
+
+// Monomial coefficients (c[0] + c[1] r + ...) of the polynomial interpolating
+// f at Degree + 1 Chebyshev nodes on [-half_width, half_width].
+template <size_t Degree, typename F>
+consteval std::array<double, Degree + 1> ChebyshevFit(F f, double half_width) {
+  constexpr size_t kN = Degree + 1;
+  // Solve the Vandermonde system in t = r / half_width (well conditioned on
+  // [-1, 1]), then rescale coefficients to r.
+  std::array<std::array<double, kN + 1>, kN> system{};
+  for (size_t j = 0; j < kN; ++j) {
+    double t = ConstCos(kPi * (j + 0.5) / kN);
+    double power = 1.0;
+    for (size_t i = 0; i < kN; ++i) {
+      system[j][i] = power;
+      power *= t;
+    }
+    system[j][kN] = f(t * half_width);
+  }
+
+  // Gaussian elimination with partial pivoting
+  for (size_t col = 0; col < kN; ++col) {
+    size_t pivot = col;
+    for (size_t row = col + 1; row < kN; ++row) {
+      double candidate = system[row][col] < 0 ? -system[row][col]
+                                              : system[row][col];
+      double best = system[pivot][col] < 0 ? -system[pivot][col]
+                                           : system[pivot][col];
+      if (candidate > best) {
+        pivot = row;
+      }
+    }
+    std::swap(system[col], system[pivot]);
+    for (size_t row = col + 1; row < kN; ++row) {
+      double factor = system[row][col] / system[col][col];
+      for (size_t k = col; k <= kN; ++k) {
+        system[row][k] -= factor * system[col][k];
+      }
+    }
+  }
+
+  std::array<double, kN> coefficients{};
+  for (size_t i = kN; i-- > 0;) {
+    double sum = system[i][kN];
+    for (size_t k = i + 1; k < kN; ++k) {
+      sum -= system[i][k] * coefficients[k];
+    }
+    coefficients[i] = sum / system[i][i];
+  }
+
+  double scale = 1.0;
+  for (size_t i = 0; i < kN; ++i) {
+    coefficients[i] /= scale;
+    scale *= half_width;
+  }
+  return coefficients;
+}
+
+template <size_t N>
+inline double Horner(const std::array<double, N> &coefficients, double r) {
+  double result = coefficients[N - 1];
+  for (size_t i = N - 1; i-- > 0;) {
+    result = result * r + coefficients[i];
+  }
+  return result;
+}
+
+// sin/cos at 2 pi k / 2^Bits
+template <int Bits>
+struct SinCosTable {
+  static constexpr size_t kSize = size_t{1} << Bits;
+  static constexpr double kStep = 2 * kPi / kSize;
+
+  static consteval std::array<double, kSize> MakeSin() {
+    std::array<double, kSize> table{};
+    for (size_t k = 0; k < kSize; ++k) {
+      table[k] = ConstSin(kStep * k);
+    }
+    return table;
+  }
+  static consteval std::array<double, kSize> MakeCos() {
+    std::array<double, kSize> table{};
+    for (size_t k = 0; k < kSize; ++k) {
+      table[k] = ConstCos(kStep * k);
+    }
+    return table;
+  }
+
+  static constexpr std::array<double, kSize> kSin = MakeSin();
+  static constexpr std::array<double, kSize> kCos = MakeCos();
+};
+
+// 1 / c_k and log(c_k) for the bucket centres c_k = 1 + (k + 0.5) / 2^Bits
+template <int Bits>
+struct LogTable {
+  static constexpr size_t kSize = size_t{1} << Bits;
+
+  static consteval double Center(size_t k) {
+    return 1.0 + (k + 0.5) / static_cast<double>(kSize);
+  }
+  static consteval std::array<double, kSize> MakeInverse() {
+    std::array<double, kSize> table{};
+    for (size_t k = 0; k < kSize; ++k) {
+      table[k] = 1.0 / Center(k);
+    }
+    return table;
+  }
+  static consteval std::array<double, kSize> MakeLog() {
+    std::array<double, kSize> table{};
+    for (size_t k = 0; k < kSize; ++k) {
+      table[k] = ConstLog(Center(k));
+    }
+    return table;
+  }
+
+  static constexpr std::array<double, kSize> kInverse = MakeInverse();
+  static constexpr std::array<double, kSize> kLog = MakeLog();
+};
+
+template <Accuracy A>
+struct ApproxCoefficients {
+  using Config = ApproxConfig<A>;
+  static constexpr double kSinHalfWidth =
+      kPi / (size_t{1} << Config::kSinTableBits);
+  static constexpr double kLogHalfWidth =
+      0.5 / (size_t{1} << Config::kLogTableBits);
+
+  static constexpr auto kSin = ChebyshevFit<Config::kSinDegree>(
+      [](double r) consteval { return ConstSin(r); },
+      kSinHalfWidth
+  );
+  static constexpr auto kCos = ChebyshevFit<Config::kCosDegree>(
+      [](double r) consteval { return ConstCos(r); },
+      kSinHalfWidth
+  );
+  static constexpr auto kLog1p = ChebyshevFit<Config::kLogDegree>(
+      [](double r) consteval { return ConstLog1p(r); },
+      kLogHalfWidth
+  );
+};
+
+} // namespace approx_detail
+
+// sin(x) = sin(a_k) cos(r) + cos(a_k) sin(r), with a_k from a table and
+// |r| <= pi / 2^kSinTableBits
+template <Accuracy A>
+inline double ApproxSin(double x) {
+  using Table = approx_detail::SinCosTable<ApproxConfig<A>::kSinTableBits>;
+  using Coefficients = approx_detail::ApproxCoefficients<A>;
+
+  // Cody-Waite reduction: kStep split so k * kStepHi is exact
+  constexpr double kStepHi = static_cast<float>(Table::kStep);
+  constexpr double kStepLo = Table::kStep - kStepHi;
+  double k = std::nearbyint(x * (1.0 / Table::kStep));
+  double r = (x - k * kStepHi) - k * kStepLo;
+  size_t index = static_cast<size_t>(static_cast<int64_t>(k)) &
+                 (Table::kSize - 1);
+
+  return Table::kSin[index] * approx_detail::Horner(Coefficients::kCos, r) +
+         Table::kCos[index] * approx_detail::Horner(Coefficients::kSin, r);
+}
+
+// log(x) = e ln2 + log(c_k) + log1p(m / c_k - 1), where x = m 2^e and c_k is
+// the table bucket containing m
+template <Accuracy A>
+inline double ApproxLog(double x) {
+  constexpr int kBits = ApproxConfig<A>::kLogTableBits;
+  using Table = approx_detail::LogTable<kBits>;
+  using Coefficients = approx_detail::ApproxCoefficients<A>;
+
+  auto bits = std::bit_cast<uint64_t>(x);
+  auto exponent = static_cast<int64_t>(bits >> 52) - 1023;
+  uint64_t mantissa_bits = bits & ((uint64_t{1} << 52) - 1);
+  double m = std::bit_cast<double>(mantissa_bits | (uint64_t{1023} << 52));
+  size_t index = mantissa_bits >> (52 - kBits);
+
+  double r = m * Table::kInverse[index] - 1.0;
+  return static_cast<double>(exponent) * approx_detail::kLn2 +
+         Table::kLog[index] +
+         approx_detail::Horner(Coefficients::kLog1p, r);
+}
+
+// sqrt(x) = x / sqrt(x), with 1 / sqrt(x) from the bit-level initial guess
+// refined by Newton steps
+template <Accuracy A>
+inline double ApproxSqrt(double x) {
+  auto bits = std::bit_cast<uint64_t>(x);
+  double y = std::bit_cast<double>(0x5FE6EB50C7B537A9ULL - (bits >> 1));
+  for (int step = 0; step < ApproxConfig<A>::kSqrtNewtonSteps; ++step) {
+    y *= 1.5 - 0.5 * x * y * y;
+  }
+  return x * y;
+}
+
+// Worst-case and mean error of an approximation against a reference over
+// [low, high]. Errors are relative where |reference| >= 1 and absolute below
+// (so zeros of sin or log don't blow up the figures).
+struct AccuracyStats {
+  double max_error;
+  double mean_error;
+  double worst_input;
+};
+
+AccuracyStats MeasureAccuracy(
+    double (*approximation)(double),
+    double (*reference)(double),
+    double low,
+    double high,
+    size_t num_samples
+);
+
+// Prints a markdown table of ApproxSin/Log/Sqrt and ComputeExpensiveApprox
+// errors against libm for every accuracy level
+void PrintAccuracyReport(std::ostream &out);
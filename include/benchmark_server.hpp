@@ -0,0 +1,90 @@
+// Persistent benchmark server. Keeps one warm process that reads job specs,
+// one per line, from stdin or a Unix domain socket, runs them in order from a
+// queue and streams one JSON result line back per job. Hardware counters are
+// read around each job, so drivers get per-job counts without respawning
+// the benchmark under `perf stat`.
+//
+// Job specs are space-separated key=value pairs:
+//   id=7 mode=run category=runtime computation=fma iterations=1000000 run=2
+//   id=8 mode=scenario scenario=footprint iterations=10000000
+// `mode` defaults to "run" and `iterations` to the server's -n value.
+// With "--cache [dir]", results are reused from a result cache (see
+// result_cache.hpp) while fresh.
+// "quit" stops the server; blank lines and lines starting with '#' are
+// skipped.
+
+#pragma once
+
+#include "perf_counters.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace benchmark_server {
+
+struct JobSpec {
+  std::string id;
+  std::string mode = "run"; // "run" or "scenario"
+  std::string category;
+  std::string computation;
+  std::string scenario;
+  size_t iterations = 0;
+  // Repetition of an otherwise identical job. Only part of the cache key, so
+  // repeated runs are separate samples rather than one cached result.
+  size_t run = 1;
+};
+
+// Parses and validates one job spec line. Throws std::invalid_argument for
+// unknown keys, bad values or tests/scenarios that don't exist.
+JobSpec ParseJobSpec(const std::string &line, size_t default_iterations);
+
+// The job without its id, plus the command-line options that affect it
+// (streaming, footprint and cold-start settings): the job part of its
+// result-cache key
+std::string JobCacheKey(const JobSpec &job);
+
+// Runs a job and returns its JSON result line (without the newline). With a
+// result cache directory set in result_cache::GetResultCacheOptions(), a
+// fresh cached result is returned instead, marked "cached":true, and new
+// successful results are stored.
+std::string RunJob(const JobSpec &job, PerfCounters &counters);
+
+// Returns the JSON error line for a job that failed to parse or run
+std::string ErrorResult(const std::string &id, const std::string &error);
+
+// First line of every session: compiler flags, binary hash, CPU model and
+// available counters
+std::string ReadyMessage(const PerfCounters &counters);
+
+// Unbounded queue of job lines between the reader and the runner
+class JobQueue {
+public:
+  void Push(std::string line);
+  // Blocks until a line is available; nullopt once closed and drained
+  std::optional<std::string> Pop();
+  void Close();
+
+private:
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::deque<std::string> lines_;
+  bool closed_ = false;
+};
+
+// Serves one session: reads job lines from input_fd on a reader thread and
+// writes results to output_fd. Returns true if the session ended with
+// "quit" (as opposed to end of input).
+bool ServeSession(int input_fd, int output_fd, size_t default_iterations);
+
+// Serves stdin/stdout. Benchmark output that would normally go to stdout is
+// redirected to stderr so that stdout carries only results.
+int RunServerOnStdin(size_t default_iterations);
+
+// Listens on a Unix domain socket and serves one connection at a time until
+// a client sends "quit"
+int RunServerOnSocket(const std::string &path, size_t default_iterations);
+
+} // namespace benchmark_server
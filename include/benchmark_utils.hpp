@@ -1,24 +1,51 @@
 #pragma once
 
+#include "math_functions.hpp"
+#include "sampling_profiler.hpp"
+#include "trace.hpp"
 #include <chrono>
 #include <fstream>
 #include <iostream>
 #include <string>
 
+class PerfCounters;
+
 struct TestCase {
   std::string name;
   void (*function)(size_t);
+  // Setup that RunTestCase runs before starting its clock, or null
+  void (*prepare)() = nullptr;
 };
 
 // External declaration for preventing compiler optimizations
 extern volatile double prevent_optimization;
 
+// How RunBenchmark and RunStreamBenchmark run on the calling thread. By
+// default they use the plain loop and store the final sum to
+// prevent_optimization once per run. The multi-threaded mode branches once
+// to a loop that publishes the running sum to the thread's own `target` on
+// every call, so slots that share a cache line visibly contend.
+struct BenchmarkSink {
+  volatile double *target = &prevent_optimization; // store_every_iteration
+  bool store_every_iteration = false;
+  bool print_time = true;
+  // RunBenchmark passes its constant argument through OpaqueValue on every
+  // call, so kernels inlined into the loop can't be folded (calibration)
+  bool opaque_argument = false;
+};
+
+// The calling thread's sink (thread-local, starts out as the default)
+BenchmarkSink &GetThreadBenchmarkSink();
+
 // Utility function to print elapsed time
 void PrintTime(const std::string &label, std::chrono::duration<double> elapsed);
 
+// Runs prepare, then times function. If counters is given, its window
+// covers the same timed region as the returned duration.
 std::chrono::duration<double> RunTestCase(
     const TestCase &test_case,
-    size_t iterations
+    size_t iterations,
+    PerfCounters *counters = nullptr
 );
 
 std::string GenerateTimestampBasedFile(std::string output_dir);
@@ -53,15 +80,67 @@ std::chrono::duration<double> RunBenchmark(
     size_t n,
     Callable &&compute_func
 ) {
+  TRACE_SCOPE("RunBenchmark");
+  PROFILE_SCOPE(label);
+  const BenchmarkSink &sink = GetThreadBenchmarkSink();
   auto start = std::chrono::high_resolution_clock::now();
   double sum = 0.0;
-  for (size_t i = 0; i < n; ++i) {
-    sum += compute_func(2.0);
+  if (sink.store_every_iteration) {
+    for (size_t i = 0; i < n; ++i) {
+      sum += compute_func(2.0);
+      *sink.target = sum;
+    }
+  } else if (sink.opaque_argument) {
+    for (size_t i = 0; i < n; ++i) {
+      sum += compute_func(OpaqueValue(2.0));
+    }
+    prevent_optimization = sum;
+  } else {
+    for (size_t i = 0; i < n; ++i) {
+      sum += compute_func(2.0);
+    }
+    prevent_optimization = sum; // don't let compiler optimize out our test loop
   }
-  prevent_optimization = sum; // don't let compiler optimize out our test loop
   auto end = std::chrono::high_resolution_clock::now();
   auto elapsed = end - start;
-  PrintTime(label, elapsed);
+  if (sink.print_time) {
+    PrintTime(label, elapsed);
+  }
+
+  return elapsed;
+}
+
+// Benchmarking function for the memory-bound kernels. Passes the element
+// index (wrapped with `mask`) rather than a constant argument so that each
+// call touches the next element of the streamed arrays.
+template <typename Callable>
+std::chrono::duration<double> RunStreamBenchmark(
+    const std::string &label,
+    size_t n,
+    size_t mask,
+    Callable &&compute_func
+) {
+  TRACE_SCOPE("RunStreamBenchmark");
+  PROFILE_SCOPE(label);
+  const BenchmarkSink &sink = GetThreadBenchmarkSink();
+  auto start = std::chrono::high_resolution_clock::now();
+  double sum = 0.0;
+  if (sink.store_every_iteration) {
+    for (size_t i = 0; i < n; ++i) {
+      sum += compute_func(i & mask);
+      *sink.target = sum;
+    }
+  } else {
+    for (size_t i = 0; i < n; ++i) {
+      sum += compute_func(i & mask);
+    }
+    prevent_optimization = sum; // don't let compiler optimize out our test loop
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  auto elapsed = end - start;
+  if (sink.print_time) {
+    PrintTime(label, elapsed);
+  }
 
   return elapsed;
 }
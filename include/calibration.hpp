@@ -0,0 +1,95 @@
+// Harness calibration: every time RunBenchmark reports includes the loop, the
+// `sum +=` accumulation and the timer. Calibration runs the same harness with
+// an empty kernel and with each kernel called directly (inlined, no
+// polymorphism), then reports each category's net cost per call in ns and
+// cycles. Every calibrated run passes RunBenchmark's argument through
+// OpaqueValue, so neither the direct kernels nor the ones inlined through
+// CRTP/Concepts are folded away. Measurements are repeated and carry their
+// standard error, which is propagated through the subtraction.
+
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace calibration {
+
+// Repetitions behind every estimate
+constexpr int kRepetitions = 5;
+
+// A mean with its standard error
+struct Estimate {
+  double value = 0.0;
+  double uncertainty = 0.0;
+};
+
+// Mean and standard error of the mean (0 for fewer than two samples)
+Estimate FromSamples(const std::vector<double> &samples);
+
+// a - b, with independent errors added in quadrature
+Estimate Difference(const Estimate &a, const Estimate &b);
+
+// a * b, with independent relative errors added in quadrature
+Estimate Product(const Estimate &a, const Estimate &b);
+
+// Computations with a direct-inline baseline: "fma", "expensive",
+// "approx_low", "approx_medium" and "approx_high"
+const std::vector<std::string> &CalibratedComputations();
+
+struct Calibration {
+  size_t calls = 0;  // per run
+  Estimate empty_ns; // ns per call with an empty kernel
+  // ns per call with each kernel called directly, by computation
+  std::map<std::string, Estimate> inline_ns;
+  std::optional<Estimate> cycles_per_ns;
+  std::string clock_source; // how cycles_per_ns was measured
+};
+
+// ns per call of RunBenchmark with an empty kernel, over kRepetitions runs
+// of `calls` calls
+Estimate MeasureEmptyKernel(size_t calls);
+
+// Same with the computation's kernel called directly. Throws
+// std::invalid_argument for a computation without a baseline.
+Estimate MeasureInlineKernel(const std::string &computation, size_t calls);
+
+// Core cycles per ns: from the cycles counter when perf events are allowed,
+// otherwise from a chain of dependent one-cycle adds (x86 only)
+std::optional<Estimate> MeasureCyclesPerNs(std::string *source);
+
+Calibration Calibrate(size_t calls);
+
+struct NetCost {
+  std::string category;
+  std::string computation;
+  Estimate raw_ns;       // the test case per call, argument opaque
+  Estimate net_ns;       // raw minus the empty-kernel harness
+  Estimate dispatch_ns;  // raw minus the direct-inline kernel
+  std::optional<Estimate> net_cycles;
+  std::optional<Estimate> dispatch_cycles;
+};
+
+// Runs the category's test case kRepetitions times with calibration.calls
+// calls. Throws std::invalid_argument for an unknown category or a
+// computation without a baseline.
+NetCost MeasureNetCost(
+    const Calibration &calibration,
+    const std::string &category,
+    const std::string &computation
+);
+
+// Baselines, then one row per result with "value ± error" cells
+void WriteNetCostTable(
+    std::ostream &out,
+    const Calibration &calibration,
+    const std::vector<NetCost> &results
+);
+
+// Every measurement uses iterations / kRepetitions calls per run
+void RunCalibrationBenchmark(size_t iterations);
+
+} // namespace calibration
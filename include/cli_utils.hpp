@@ -3,6 +3,7 @@
 #include "test_runner.hpp"
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
 // Forward declaration
@@ -23,6 +24,9 @@ bool IsValidComputation(
     const std::string &computation
 );
 
+// Validates a "--scenario" name
+bool IsValidScenario(const std::string &scenario);
+
 // Parses an optional "-n [iterations]" argument
 std::optional<size_t>
 ParseIterationCount(int argc, char **argv, int &remaining_argc);
@@ -30,6 +34,46 @@ ParseIterationCount(int argc, char **argv, int &remaining_argc);
 // Parses the "-s" flag to enable saving execution time data
 bool ParseSaveExecutionTimesFlag(int argc, char **argv, int &remaining_argc);
 
+// Parses a boolean flag, removing it from args if present
+bool ParseFlag(char **argv, int &remaining_argc, std::string_view flag);
+
+// Parses a "flag value" pair, removing both from args if present
+std::optional<std::string> ParseFlagValue(
+    char **argv,
+    int &remaining_argc,
+    std::string_view flag
+);
+
+// Parses a positive (or, if allow_zero, non-negative) integer argument value
+std::optional<size_t> ParseCount(const std::string &text, bool allow_zero);
+
+// Parses "--huge-pages", "--prefetch" and "--stream-length" into
+// GetStreamOptions(). Returns false if a value is invalid.
+bool ParseStreamOptions(char **argv, int &remaining_argc);
+
+// Parses "--population" into footprint::GetFootprintOptions(). Returns false
+// if the value is invalid.
+bool ParseFootprintOptions(char **argv, int &remaining_argc);
+
+// Parses "--cold-samples", "--cold-batch" and "--evict-mib" into
+// cold_start::GetColdStartOptions(). Returns false if a value is invalid.
+bool ParseColdStartOptions(char **argv, int &remaining_argc);
+
+// Parses "-t [threads]" and "--shared-sink" into GetThreadScalingOptions().
+// Returns false if a value is invalid.
+bool ParseThreadScalingOptions(char **argv, int &remaining_argc);
+
+// Parses "--profile", "--profile-top" and "--profile-hz" into
+// GetProfilerOptions(). Returns false if a value is invalid.
+bool ParseProfilerOptions(char **argv, int &remaining_argc);
+
+// Parses "--cache" and "--cache-max-age" into
+// result_cache::GetResultCacheOptions(). Returns false if a value is invalid.
+bool ParseResultCacheOptions(char **argv, int &remaining_argc);
+
+// Writes the Chrome trace requested with "--trace [file]"
+void WriteTraceFile(const std::string &filepath);
+
 // Handles command-line arguments and runs tests
 int RunFromCLI(int argc, char **argv);
 
@@ -46,3 +90,9 @@ int RunAppropriateTests(
     size_t iterations,
     bool save_execution_times
 );
+int RunScenarioFromCLI(
+    const std::string &scenario,
+    int remaining_argc,
+    char **argv,
+    size_t iterations
+);
@@ -0,0 +1,73 @@
+// Cold-call latency: each measured call (or small batch) runs after the
+// caches have been evicted by streaming through a buffer larger than the
+// LLC, the call's code and vtable lines have been flushed with clflush where
+// the target supports it, and the branch predictors have been scrambled by
+// random direct and indirect branches.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace cold_start {
+
+// Cold samples are expensive (each sweeps the eviction buffer), so the count
+// is independent of -n
+constexpr size_t kDefaultColdSamples = 200;
+
+struct ColdStartOptions {
+  size_t samples = kDefaultColdSamples;
+  size_t batch = 1;        // calls per measured sample
+  size_t evict_bytes = 0;  // 0 = 1.5x the detected LLC size
+};
+
+// Options used by the cold-start scenario (set from the command line)
+ColdStartOptions &GetColdStartOptions();
+
+// Detected last-level cache size in bytes, or a 32 MiB guess
+size_t LastLevelCacheSize();
+
+// Touches every cache line of `buffer` (read-modify-write), evicting
+// everything else from the data caches and TLBs
+void EvictCaches(std::vector<uint64_t> &buffer);
+
+// clflushes the cache lines spanning [address, address + num_bytes). No-op
+// where clflush isn't available.
+void FlushLines(const void *address, size_t num_bytes);
+
+// Runs pseudo-random conditional and indirect branches to overwrite the
+// branch history and BTB entries. `state` is an xorshift seed.
+void ScrambleBranchHistory(uint64_t &state);
+
+// p in [0, 1], nearest-rank
+double Percentile(std::vector<double> values, double p);
+
+struct ColdStartResult {
+  std::string category;
+  std::string computation;
+  double cold_median_ns; // per call, timer overhead removed
+  double cold_p90_ns;
+  double cold_median_ticks; // timestamp-counter ticks (reference cycles)
+  double warm_median_ns;
+};
+
+// Measures one category ("runtime", "crtp", "concepts") and computation
+// ("fma", "expensive"). Throws std::invalid_argument for anything else.
+ColdStartResult MeasureColdStart(
+    const std::string &category,
+    const std::string &computation,
+    const ColdStartOptions &options
+);
+
+void WriteColdStartTable(
+    std::ostream &out,
+    const std::vector<ColdStartResult> &results
+);
+
+// Measures every category for fma and expensive with GetColdStartOptions()
+void RunColdStartBenchmark(size_t iterations);
+
+} // namespace cold_start
@@ -22,6 +22,76 @@ public:
   double Compute(double x) const;
 };
 
+// PolyFMA and PolyExpensive with Compute defined here, for code that calls
+// Compute from its own loops: the classes above only inline through the
+// TestConcepts* instantiations in concepts_polymorphism.cpp
+class InlinePolyFMA {
+public:
+  double Compute(double x) const { return ComputeFMA(x); }
+};
+
+class InlinePolyExpensive {
+public:
+  double Compute(double x) const { return ComputeExpensive(x); }
+};
+
+// ComputeExpensive with approximate sin/log/sqrt (see approx_math.hpp)
+template <Accuracy A>
+class PolyExpensiveApprox {
+public:
+  double Compute(double x) const;
+};
+
+// K dependent FMAs per call (see ComputeChain)
+template <size_t K>
+class PolyChain {
+public:
+  double Compute(double x) const;
+};
+
+// Memory-bound kernels take an element index instead of a value
+
+template <typename T>
+concept StreamComputable = requires(T t, size_t i) {
+  { t.Compute(i) } -> std::convertible_to<double>;
+};
+
+class PolyTriad {
+public:
+  explicit PolyTriad(const StreamArrays &arrays) : arrays_(arrays) {}
+  double Compute(size_t i) const;
+
+private:
+  StreamArrays arrays_;
+};
+
+class PolyDot {
+public:
+  explicit PolyDot(const StreamArrays &arrays) : arrays_(arrays) {}
+  double Compute(size_t i) const;
+
+private:
+  StreamArrays arrays_;
+};
+
+class PolyStencil {
+public:
+  explicit PolyStencil(const StreamArrays &arrays) : arrays_(arrays) {}
+  double Compute(size_t i) const;
+
+private:
+  StreamArrays arrays_;
+};
+
+class PolyGather {
+public:
+  explicit PolyGather(const StreamArrays &arrays) : arrays_(arrays) {}
+  double Compute(size_t i) const;
+
+private:
+  StreamArrays arrays_;
+};
+
 template <Computable T>
 void TestConceptsPolymorphism(const std::string &label, size_t n, T &obj) {
   RunBenchmark(label + " C++20 Concepts Polymorphism", n, [&](double x) {
@@ -29,4 +99,136 @@ void TestConceptsPolymorphism(const std::string &label, size_t n, T &obj) {
   });
 }
 
+template <StreamComputable T>
+void TestConceptsStreamPolymorphism(
+    const std::string &label,
+    size_t n,
+    size_t mask,
+    T &obj
+) {
+  RunStreamBenchmark(
+      label + " C++20 Concepts Polymorphism",
+      n,
+      mask,
+      [&](size_t i) { return obj.Compute(i); }
+  );
+}
+
+// Instantiated in concepts_polymorphism.cpp next to the Compute definitions,
+// so the kernels inline into the benchmark loop. Without these declarations
+// another translation unit may instantiate its own copy, which can only call
+// Compute out of line.
+
+extern template void TestConceptsPolymorphism<PolyFMA>(
+    const std::string &label,
+    size_t n,
+    PolyFMA &obj
+);
+
+extern template void TestConceptsPolymorphism<PolyExpensive>(
+    const std::string &label,
+    size_t n,
+    PolyExpensive &obj
+);
+
+extern template void TestConceptsPolymorphism<PolyExpensiveApprox<Accuracy::kLow>>(
+    const std::string &label,
+    size_t n,
+    PolyExpensiveApprox<Accuracy::kLow> &obj
+);
+
+extern template void TestConceptsPolymorphism<PolyExpensiveApprox<Accuracy::kMedium>>(
+    const std::string &label,
+    size_t n,
+    PolyExpensiveApprox<Accuracy::kMedium> &obj
+);
+
+extern template void TestConceptsPolymorphism<PolyExpensiveApprox<Accuracy::kHigh>>(
+    const std::string &label,
+    size_t n,
+    PolyExpensiveApprox<Accuracy::kHigh> &obj
+);
+
+extern template void TestConceptsPolymorphism<PolyChain<1>>(
+    const std::string &label,
+    size_t n,
+    PolyChain<1> &obj
+);
+
+extern template void TestConceptsPolymorphism<PolyChain<2>>(
+    const std::string &label,
+    size_t n,
+    PolyChain<2> &obj
+);
+
+extern template void TestConceptsPolymorphism<PolyChain<4>>(
+    const std::string &label,
+    size_t n,
+    PolyChain<4> &obj
+);
+
+extern template void TestConceptsPolymorphism<PolyChain<8>>(
+    const std::string &label,
+    size_t n,
+    PolyChain<8> &obj
+);
+
+extern template void TestConceptsPolymorphism<PolyChain<16>>(
+    const std::string &label,
+    size_t n,
+    PolyChain<16> &obj
+);
+
+extern template void TestConceptsPolymorphism<PolyChain<32>>(
+    const std::string &label,
+    size_t n,
+    PolyChain<32> &obj
+);
+
+extern template void TestConceptsPolymorphism<PolyChain<64>>(
+    const std::string &label,
+    size_t n,
+    PolyChain<64> &obj
+);
+
+extern template void TestConceptsPolymorphism<PolyChain<128>>(
+    const std::string &label,
+    size_t n,
+    PolyChain<128> &obj
+);
+
+extern template void TestConceptsPolymorphism<PolyChain<256>>(
+    const std::string &label,
+    size_t n,
+    PolyChain<256> &obj
+);
+
+extern template void TestConceptsStreamPolymorphism<PolyTriad>(
+    const std::string &label,
+    size_t n,
+    size_t mask,
+    PolyTriad &obj
+);
+
+extern template void TestConceptsStreamPolymorphism<PolyDot>(
+    const std::string &label,
+    size_t n,
+    size_t mask,
+    PolyDot &obj
+);
+
+extern template void TestConceptsStreamPolymorphism<PolyStencil>(
+    const std::string &label,
+    size_t n,
+    size_t mask,
+    PolyStencil &obj
+);
+
+extern template void TestConceptsStreamPolymorphism<PolyGather>(
+    const std::string &label,
+    size_t n,
+    size_t mask,
+    PolyGather &obj
+);
+
 } // namespace concepts_polymorphism
\ No newline at end of file
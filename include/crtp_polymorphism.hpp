@@ -25,6 +25,59 @@ class PolyExpensive : public CRTPBase<PolyExpensive> {
   double ComputeImpl(double x) const { return ComputeExpensive(x); }
 };
 
+// ComputeExpensive with approximate sin/log/sqrt (see approx_math.hpp)
+template <Accuracy A>
+class PolyExpensiveApprox : public CRTPBase<PolyExpensiveApprox<A>> {
+ public:
+  double ComputeImpl(double x) const { return ComputeExpensiveApprox<A>(x); }
+};
+
+// K dependent FMAs per call (see ComputeChain)
+template <size_t K>
+class PolyChain : public CRTPBase<PolyChain<K>> {
+ public:
+  double ComputeImpl(double x) const { return ComputeChain<K>(x); }
+};
+
+// Memory-bound kernels take an element index instead of a value
+
+template <typename Derived>
+class CRTPStreamBase {
+ public:
+  explicit CRTPStreamBase(const StreamArrays &arrays) : arrays_(arrays) {}
+
+  double Compute(size_t i) const {
+    return static_cast<const Derived*>(this)->ComputeImpl(i);
+  }
+
+ protected:
+  StreamArrays arrays_;
+};
+
+class PolyTriad : public CRTPStreamBase<PolyTriad> {
+ public:
+  using CRTPStreamBase::CRTPStreamBase;
+  double ComputeImpl(size_t i) const { return ComputeTriad(arrays_, i); }
+};
+
+class PolyDot : public CRTPStreamBase<PolyDot> {
+ public:
+  using CRTPStreamBase::CRTPStreamBase;
+  double ComputeImpl(size_t i) const { return ComputeDot(arrays_, i); }
+};
+
+class PolyStencil : public CRTPStreamBase<PolyStencil> {
+ public:
+  using CRTPStreamBase::CRTPStreamBase;
+  double ComputeImpl(size_t i) const { return ComputeStencil(arrays_, i); }
+};
+
+class PolyGather : public CRTPStreamBase<PolyGather> {
+ public:
+  using CRTPStreamBase::CRTPStreamBase;
+  double ComputeImpl(size_t i) const { return ComputeGather(arrays_, i); }
+};
+
 template <typename T>
 void TestCRTPPolymorphism(const std::string &label, size_t n, T &obj) {
   RunBenchmark(label + " CRTP Polymorphism", n, [&](double x) {
@@ -32,4 +85,16 @@ void TestCRTPPolymorphism(const std::string &label, size_t n, T &obj) {
   });
 }
 
+template <typename T>
+void TestCRTPStreamPolymorphism(
+    const std::string &label,
+    size_t n,
+    size_t mask,
+    T &obj
+) {
+  RunStreamBenchmark(label + " CRTP Polymorphism", n, mask, [&](size_t i) {
+    return obj.Compute(i);
+  });
+}
+
 } // namespace crtp_polymorphism
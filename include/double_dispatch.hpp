@@ -0,0 +1,287 @@
+// Double dispatch over an N x M type matrix: every call picks a (left, right)
+// pair of types at random and runs the kernel for that pair. Compares the
+// classic virtual visitor, std::visit over two variants, a 2D function
+// pointer table and CRTP/Concepts overload resolution on bucketed pairs.
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace double_dispatch {
+
+// The kernel for the (I, J) pair. Constants differ per pair so the compiler
+// can't merge cases.
+template <size_t I, size_t J>
+inline double Interact(double x) {
+  return std::fma(x, 1.0 + I * 0.125, 0.5 + J * 0.25);
+}
+
+// One call: the pair's type indices and the argument
+struct PairCall {
+  uint8_t left;
+  uint8_t right;
+  double x;
+};
+
+// Uniformly random pairs from a num_left x num_right matrix, x in [0, 1)
+std::vector<PairCall> MakePairSequence(
+    size_t length,
+    size_t num_left,
+    size_t num_right,
+    uint64_t seed
+);
+
+// ===========================
+// VIRTUAL VISITOR
+// ===========================
+
+template <size_t I>
+using LeftTag = std::integral_constant<size_t, I>;
+
+// One Visit overload per left type; the visitor base inherits all N
+template <size_t I>
+class VisitorSlot {
+public:
+  virtual ~VisitorSlot() = default;
+  virtual double Visit(LeftTag<I>, double x) const = 0;
+};
+
+template <typename Sequence>
+class VisitorRightBase;
+
+template <size_t... Is>
+class VisitorRightBase<std::index_sequence<Is...>>
+    : public VisitorSlot<Is>... {
+public:
+  using VisitorSlot<Is>::Visit...;
+};
+
+template <size_t N>
+using VisitorRight = VisitorRightBase<std::make_index_sequence<N>>;
+
+template <size_t N>
+class VisitorLeft {
+public:
+  virtual ~VisitorLeft() = default;
+  virtual double Accept(const VisitorRight<N> &right, double x) const = 0;
+};
+
+// First dispatch: the left type calls the overload for its own index
+template <size_t N, size_t I>
+class VisitorLeftImpl final : public VisitorLeft<N> {
+public:
+  double Accept(const VisitorRight<N> &right, double x) const override {
+    return right.Visit(LeftTag<I>{}, x);
+  }
+};
+
+// Second dispatch: right type J overrides Visit for every left type, one
+// level of the chain per left index
+template <size_t N, size_t J, size_t I = N>
+class VisitorRightImpl : public VisitorRightImpl<N, J, I - 1> {
+public:
+  using VisitorRightImpl<N, J, I - 1>::Visit;
+  double Visit(LeftTag<I - 1>, double x) const override {
+    return Interact<I - 1, J>(x);
+  }
+};
+
+template <size_t N, size_t J>
+class VisitorRightImpl<N, J, 0> : public VisitorRight<N> {};
+
+// ===========================
+// STD::VISIT OVER TWO VARIANTS
+// ===========================
+
+template <size_t I>
+struct VariantLeft {
+  static constexpr size_t kIndex = I;
+};
+
+template <size_t J>
+struct VariantRight {
+  static constexpr size_t kIndex = J;
+};
+
+template <template <size_t> class T, typename Sequence>
+struct VariantOver;
+
+template <template <size_t> class T, size_t... Is>
+struct VariantOver<T, std::index_sequence<Is...>> {
+  using type = std::variant<T<Is>...>;
+};
+
+template <size_t N>
+using LeftVariant =
+    typename VariantOver<VariantLeft, std::make_index_sequence<N>>::type;
+
+template <size_t M>
+using RightVariant =
+    typename VariantOver<VariantRight, std::make_index_sequence<M>>::type;
+
+template <size_t N, size_t M>
+inline double
+VisitPair(const LeftVariant<N> &left, const RightVariant<M> &right, double x) {
+  return std::visit(
+      [x](auto l, auto r) {
+        return Interact<decltype(l)::kIndex, decltype(r)::kIndex>(x);
+      },
+      left,
+      right
+  );
+}
+
+// ===========================
+// 2D FUNCTION POINTER TABLE
+// ===========================
+
+using InteractFunction = double (*)(double);
+
+template <size_t N, size_t M>
+using InteractionTable = std::array<std::array<InteractFunction, M>, N>;
+
+template <size_t N, size_t M>
+constexpr InteractionTable<N, M> MakeInteractionTable() {
+  InteractionTable<N, M> table{};
+  // Flat index K covers the pair (K / M, K % M)
+  [&]<size_t... Ks>(std::index_sequence<Ks...>) {
+    ((table[Ks / M][Ks % M] = &Interact<Ks / M, Ks % M>), ...);
+  }(std::make_index_sequence<N * M>{});
+  return table;
+}
+
+// ===========================
+// CRTP / CONCEPTS OVERLOAD RESOLUTION
+// ===========================
+
+template <typename T>
+concept LeftShape = requires {
+  { T::kLeftIndex } -> std::convertible_to<size_t>;
+};
+
+template <typename T>
+concept RightShape = requires {
+  { T::kRightIndex } -> std::convertible_to<size_t>;
+};
+
+template <typename Derived>
+class StaticLeftBase {
+public:
+  template <RightShape R>
+  double Collide(const R &right, double x) const {
+    return static_cast<const Derived &>(*this).CollideWith(right, x);
+  }
+};
+
+template <size_t I>
+class StaticLeft : public StaticLeftBase<StaticLeft<I>> {
+public:
+  static constexpr size_t kLeftIndex = I;
+
+  template <RightShape R>
+  double CollideWith(const R &, double x) const {
+    return Interact<I, R::kRightIndex>(x);
+  }
+};
+
+template <size_t J>
+struct StaticRight {
+  static constexpr size_t kRightIndex = J;
+};
+
+// The pair's types are only known statically, so random pairs are first
+// bucketed by (left, right), then each bucket runs the resolved overload
+template <size_t N, size_t M>
+class StaticBatcher {
+public:
+  double Evaluate(std::span<const PairCall> calls) {
+    for (auto &bucket : buckets_) {
+      bucket.clear();
+    }
+    for (const auto &call : calls) {
+      buckets_[call.left * M + call.right].push_back(call.x);
+    }
+
+    double sum = 0.0;
+    [&]<size_t... Is>(std::index_sequence<Is...>) {
+      ((sum += SumRow<Is>(std::make_index_sequence<M>{})), ...);
+    }(std::make_index_sequence<N>{});
+    return sum;
+  }
+
+private:
+  template <size_t I, size_t... Js>
+  double SumRow(std::index_sequence<Js...>) const {
+    return (SumBucket(StaticLeft<I>{}, StaticRight<Js>{}) + ...);
+  }
+
+  template <LeftShape L, RightShape R>
+  double SumBucket(const L &left, const R &right) const {
+    double sum = 0.0;
+    for (double x : buckets_[L::kLeftIndex * M + R::kRightIndex]) {
+      sum += left.Collide(right, x);
+    }
+    return sum;
+  }
+
+  std::array<std::vector<double>, N * M> buckets_;
+};
+
+// ===========================
+// BENCHMARK
+// ===========================
+
+enum class Approach {
+  kVirtualVisitor,
+  kVariantVisit,
+  kFunctionTable,
+  kStaticOverload
+};
+
+std::string ApproachName(Approach approach);
+
+const std::vector<Approach> &AllApproaches();
+
+// (N, M) sizes with compiled-in type matrices
+const std::vector<std::pair<size_t, size_t>> &MatrixSizes();
+
+struct DoubleDispatchResult {
+  size_t num_left;
+  size_t num_right;
+  Approach approach;
+  double ns_per_call;
+  double sum; // equal across approaches up to summation order
+};
+
+// Runs `calls` through the approach `passes` times. Throws
+// std::invalid_argument if the size isn't one of MatrixSizes() or a call
+// indexes outside it.
+DoubleDispatchResult MeasureDoubleDispatch(
+    size_t num_left,
+    size_t num_right,
+    Approach approach,
+    std::span<const PairCall> calls,
+    size_t passes
+);
+
+// Scaling is ns per call relative to the same approach on the smallest
+// matrix
+void WriteDoubleDispatchTable(
+    std::ostream &out,
+    const std::vector<DoubleDispatchResult> &results
+);
+
+void RunDoubleDispatchBenchmark(size_t iterations);
+
+} // namespace double_dispatch
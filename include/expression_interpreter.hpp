@@ -0,0 +1,344 @@
+// Expression-interpreter benchmark: random expression trees over the
+// math_functions.hpp kernels, evaluated for every element of an input array
+// by the ways an interpreter can dispatch on node type:
+// - virtual nodes (RuntimeBase-style AST, one heap object per node)
+// - static trees whose shape is a CRTP or Concepts type (compiled-in trees)
+// - std::variant nodes in a contiguous arena, visited recursively
+// - flat postfix bytecode run by a switch loop or a threaded-dispatch loop
+// Trees are generated with an exact node count and depth so size and depth
+// can be scaled independently.
+
+#pragma once
+
+#include "math_functions.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace expression_interpreter {
+
+enum class Op : uint8_t {
+  kInput,      // x
+  kConstant,   // node constant
+  kFMA,        // ComputeFMA(a)
+  kExpensive,  // ComputeExpensive(|a|), kept inside the kernel's domain
+  kAverage,    // (a + b) / 2
+  kDifference, // a - b
+};
+
+constexpr bool IsLeaf(Op op) { return op == Op::kInput || op == Op::kConstant; }
+constexpr bool IsUnary(Op op) { return op == Op::kFMA || op == Op::kExpensive; }
+
+inline double ApplyUnary(Op op, double a) {
+  return op == Op::kFMA ? ComputeFMA(a) : ComputeExpensive(std::fabs(a));
+}
+
+inline double ApplyBinary(Op op, double a, double b) {
+  return op == Op::kAverage ? (a + b) * 0.5 : a - b;
+}
+
+// Largest tree the generator builds
+constexpr size_t kMaxTreeNodes = 1023;
+
+struct ExprNode {
+  Op op = Op::kInput;
+  uint32_t left = 0;  // child of unary nodes
+  uint32_t right = 0;
+  double constant = 0.0;
+};
+
+// Nodes in post-order (children before parents, left subtree first), so the
+// root is the last node and the order is also the postfix program
+struct ExprTree {
+  std::array<ExprNode, kMaxTreeNodes> nodes{};
+  uint32_t size = 0;
+  uint32_t depth = 0; // nodes on the longest root-to-leaf path
+
+  constexpr uint32_t root() const { return size - 1; }
+};
+
+// Most nodes a tree of the given depth can hold
+constexpr uint64_t MaxNodesForDepth(uint64_t depth) {
+  return depth >= 63 ? UINT64_MAX : (uint64_t{1} << depth) - 1;
+}
+
+// Builds random trees with an exact size and depth (usable in constant
+// expressions, which is how the static trees get their shapes)
+class TreeBuilder {
+public:
+  explicit constexpr TreeBuilder(uint64_t seed) : state_(seed) {}
+
+  // Throws std::invalid_argument unless depth <= size <= MaxNodesForDepth
+  // (depth) and size <= kMaxTreeNodes
+  constexpr ExprTree Build(size_t size, size_t depth) {
+    if (depth == 0 || size < depth || size > MaxNodesForDepth(depth) ||
+        size > kMaxTreeNodes) {
+      throw std::invalid_argument("No tree with that size and depth");
+    }
+    tree_ = ExprTree{};
+    BuildExact(size, depth);
+    tree_.depth = static_cast<uint32_t>(depth);
+    return tree_;
+  }
+
+private:
+  // splitmix64
+  constexpr uint64_t Next() {
+    uint64_t z = (state_ += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+  }
+
+  // Uniform in [low, high]
+  constexpr uint64_t Uniform(uint64_t low, uint64_t high) {
+    return low + Next() % (high - low + 1);
+  }
+
+  constexpr uint32_t Append(ExprNode node) {
+    tree_.nodes[tree_.size] = node;
+    return tree_.size++;
+  }
+
+  // Subtree of exactly `size` nodes whose longest path has `depth` nodes
+  constexpr uint32_t BuildExact(uint64_t size, uint64_t depth) {
+    if (depth == 1) {
+      if (Next() % 2 == 0) {
+        return Append({Op::kInput});
+      }
+      double constant = 0.5 + static_cast<double>(Next() >> 11) * 0x1.0p-53;
+      return Append({Op::kConstant, 0, 0, constant});
+    }
+
+    // Unary: the child takes the rest. Binary: one child has depth - 1 and
+    // the other at most that, splitting size - 1 nodes.
+    uint64_t child_max = MaxNodesForDepth(depth - 1);
+    bool unary_fits = size - 1 <= child_max;
+    uint64_t low =
+        std::max(depth - 1, size - 1 > child_max ? size - 1 - child_max : 1);
+    uint64_t high = size >= 2 ? std::min(child_max, size - 2) : 0;
+    bool binary_fits = size >= 3 && low <= high;
+
+    // Weights: FMA 3, Expensive 1, Average 2, Difference 2
+    uint64_t roll = Next() % 8;
+    bool binary = binary_fits && (!unary_fits || roll >= 4);
+    if (!binary) {
+      Op op = roll % 4 == 3 ? Op::kExpensive : Op::kFMA;
+      uint32_t child = BuildExact(size - 1, depth - 1);
+      return Append({op, child});
+    }
+
+    Op op = roll % 2 == 0 ? Op::kAverage : Op::kDifference;
+    uint64_t deep_size = Uniform(low, high);
+    uint64_t other_size = size - 1 - deep_size;
+    uint64_t other_depth =
+        Uniform(MinDepth(other_size), std::min(other_size, depth - 1));
+    uint32_t left = 0;
+    uint32_t right = 0;
+    if (Next() % 2 == 0) {
+      left = BuildExact(deep_size, depth - 1);
+      right = BuildExact(other_size, other_depth);
+    } else {
+      left = BuildExact(other_size, other_depth);
+      right = BuildExact(deep_size, depth - 1);
+    }
+    return Append({op, left, right});
+  }
+
+  static constexpr uint64_t MinDepth(uint64_t size) {
+    uint64_t depth = 1;
+    while (MaxNodesForDepth(depth) < size) {
+      ++depth;
+    }
+    return depth;
+  }
+
+  uint64_t state_;
+  ExprTree tree_{};
+};
+
+constexpr ExprTree MakeRandomTree(size_t size, size_t depth, uint64_t seed) {
+  return TreeBuilder(seed).Build(size, depth);
+}
+
+// Straightforward post-order evaluation, used to check the interpreters
+double EvaluateReference(const ExprTree &tree, double x);
+
+// ===========================
+// VIRTUAL NODES
+// ===========================
+
+class VirtualNode {
+public:
+  virtual ~VirtualNode() = default;
+  virtual double Evaluate(double x) const = 0;
+};
+
+std::unique_ptr<VirtualNode> BuildVirtualTree(const ExprTree &tree);
+
+// ===========================
+// VARIANT ARENA
+// ===========================
+
+struct InputTerm {};
+struct ConstantTerm {
+  double value;
+};
+template <Op kOp>
+struct UnaryTerm {
+  static constexpr Op op = kOp;
+  uint32_t child;
+};
+template <Op kOp>
+struct BinaryTerm {
+  static constexpr Op op = kOp;
+  uint32_t left;
+  uint32_t right;
+};
+
+using VariantNode = std::variant<
+    InputTerm,
+    ConstantTerm,
+    UnaryTerm<Op::kFMA>,
+    UnaryTerm<Op::kExpensive>,
+    BinaryTerm<Op::kAverage>,
+    BinaryTerm<Op::kDifference>>;
+
+// All nodes in one vector, children referenced by index
+class VariantArena {
+public:
+  explicit VariantArena(const ExprTree &tree);
+
+  double Evaluate(double x) const { return Evaluate(root_, x); }
+
+private:
+  double Evaluate(uint32_t index, double x) const;
+
+  std::vector<VariantNode> nodes_;
+  uint32_t root_;
+};
+
+// ===========================
+// BYTECODE
+// ===========================
+
+enum class Opcode : uint8_t {
+  kPushInput,
+  kPushConstant,
+  kFMA,
+  kExpensive,
+  kAverage,
+  kDifference,
+  kReturn,
+};
+
+struct Instruction {
+  Opcode opcode;
+  double constant;
+};
+
+// Postfix program for a value stack, compiled from the post-order nodes
+class Bytecode {
+public:
+  explicit Bytecode(const ExprTree &tree);
+
+  // One switch in a loop: every instruction goes back through the same
+  // indirect branch
+  double RunSwitch(double x) const;
+
+  // Each handler jumps straight to the next one (computed goto on GCC and
+  // Clang, RunSwitch elsewhere), so the branch predictor sees one indirect
+  // branch per handler
+  double RunThreaded(double x) const;
+
+  const std::vector<Instruction> &code() const { return code_; }
+  size_t max_stack() const { return max_stack_; }
+
+private:
+  std::vector<Instruction> code_;
+  size_t max_stack_ = 0;
+};
+
+// ===========================
+// BENCHMARK
+// ===========================
+
+enum class Approach {
+  kVirtualNodes,
+  kCRTPStatic,
+  kConceptsStatic,
+  kVariantArena,
+  kBytecodeSwitch,
+  kBytecodeThreaded,
+};
+
+std::string ApproachName(Approach approach);
+
+const std::vector<Approach> &AllApproaches();
+
+struct TreeShape {
+  size_t size;
+  size_t depth;
+};
+
+// Compiled-in tree shapes: a size sweep at near-balanced depth, then a depth
+// sweep at a fixed size
+constexpr std::array<TreeShape, 10> kTreeShapes = {{
+    {7, 4},
+    {31, 7},
+    {127, 10},
+    {511, 13},
+    {1023, 15},
+    {255, 8},
+    {255, 16},
+    {255, 32},
+    {255, 64},
+    {255, 128},
+}};
+
+constexpr uint64_t kTreeSeed = 2024;
+
+// The tree used for kTreeShapes[shape_index]
+const ExprTree &ShapeTree(size_t shape_index);
+
+struct ExpressionResult {
+  size_t size;
+  size_t depth;
+  Approach approach;
+  size_t evaluations;
+  double ns_per_evaluation;
+  double sum;
+
+  double EvaluationsPerSecond() const { return 1e9 / ns_per_evaluation; }
+};
+
+// Evaluates ShapeTree(shape_index) once per input, `passes` times. Throws
+// std::invalid_argument for a shape index outside kTreeShapes.
+ExpressionResult MeasureExpression(
+    size_t shape_index,
+    Approach approach,
+    const std::vector<double> &inputs,
+    size_t passes
+);
+
+// Inputs in [0, 1)
+std::vector<double> MakeInputs(size_t length, uint64_t seed);
+
+// Evaluations per second and ns per node, with speedup over virtual nodes
+// for the same tree
+void WriteExpressionTable(
+    std::ostream &out,
+    const std::vector<ExpressionResult> &results
+);
+
+// Every tree gets about `iterations` node evaluations per approach
+void RunExpressionBenchmark(size_t iterations);
+
+} // namespace expression_interpreter
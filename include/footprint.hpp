@@ -0,0 +1,73 @@
+// Memory footprint of large heterogeneous FMA/Expensive populations under
+// each dispatch model: per-object size, heap allocations, resident memory and
+// page faults, next to the time of a sweep over the same population.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace footprint {
+
+// Default objects per population: large enough that per-object overheads
+// (vptr, padding, allocator headers) dominate the resident set
+constexpr size_t kDefaultPopulation = 10'000'000;
+
+struct FootprintOptions {
+  size_t population = kDefaultPopulation;
+};
+
+// Options used by the footprint scenario (set from the command line)
+FootprintOptions &GetFootprintOptions();
+
+struct MemoryUsage {
+  size_t rss_bytes;      // VmRSS
+  size_t peak_rss_bytes; // VmHWM, or ru_maxrss if /proc is unavailable
+  uint64_t minor_faults;
+  uint64_t major_faults;
+};
+
+MemoryUsage ReadMemoryUsage();
+
+// Resets the kernel's peak RSS (VmHWM) to the current RSS via
+// /proc/self/clear_refs. Returns false if that isn't supported, in which
+// case peak figures are process-wide high-water marks.
+bool ResetPeakRss();
+
+struct FootprintResult {
+  std::string model;
+  size_t element_size;               // sizeof one container element
+  double requested_bytes_per_object; // operator new bytes / population
+  double resident_bytes_per_object;  // peak RSS growth / population
+  uint64_t allocations;
+  size_t peak_rss_growth_bytes;
+  uint64_t minor_faults;
+  uint64_t major_faults;
+  double ns_per_call;
+};
+
+// "runtime", "crtp", "concepts", "variant" and "type_erased"
+const std::vector<std::string> &FootprintModels();
+
+// Builds a population of half PolyFMA, half PolyExpensive objects under the
+// given model, sweeps it `sweeps` times and frees it. Throws
+// std::invalid_argument for an unknown model.
+FootprintResult MeasureFootprint(
+    const std::string &model,
+    size_t population,
+    size_t sweeps
+);
+
+void WriteFootprintTable(
+    std::ostream &out,
+    const std::vector<FootprintResult> &results
+);
+
+// Measures every model with GetFootprintOptions().population objects and
+// enough sweeps to make `iterations` calls per model
+void RunFootprintBenchmark(size_t iterations);
+
+} // namespace footprint
@@ -0,0 +1,51 @@
+// Large, page-aligned memory regions that can be backed by transparent or
+// explicit (hugetlbfs) huge pages. Used by the memory-bound kernels.
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+enum class HugePageMode {
+  kNone,        // regular 4 KiB pages (THP explicitly disabled for the region)
+  kTransparent, // madvise(MADV_HUGEPAGE)
+  kExplicit     // mmap(MAP_HUGETLB), needs pages reserved in vm.nr_hugepages
+};
+
+// Size of the huge pages requested by HugePageMode::kTransparent/kExplicit
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+std::optional<HugePageMode> ParseHugePageMode(const std::string &name);
+std::string HugePageModeName(HugePageMode mode);
+
+// Owns an anonymous mmap region. If explicit huge pages are requested but
+// none are available, falls back to transparent huge pages and reports the
+// mode actually obtained through mode().
+class HugePageBuffer {
+public:
+  HugePageBuffer(size_t num_bytes, HugePageMode mode);
+  ~HugePageBuffer();
+
+  HugePageBuffer(const HugePageBuffer &) = delete;
+  HugePageBuffer &operator=(const HugePageBuffer &) = delete;
+  HugePageBuffer(HugePageBuffer &&other) noexcept;
+  HugePageBuffer &operator=(HugePageBuffer &&other) noexcept;
+
+  template <typename T>
+  T *As() const {
+    return static_cast<T *>(data_);
+  }
+
+  void *data() const { return data_; }
+  size_t size_bytes() const { return num_bytes_; }
+  HugePageMode mode() const { return mode_; }
+
+private:
+  void Release();
+
+  void *data_ = nullptr;
+  size_t num_bytes_ = 0;
+  size_t mapped_bytes_ = 0;
+  HugePageMode mode_ = HugePageMode::kNone;
+};
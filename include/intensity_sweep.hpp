@@ -0,0 +1,67 @@
+// Arithmetic-intensity sweep: runs ComputeChain<K> (K dependent FMAs per
+// call) through every dispatch model for each K in kChainLengths, and finds
+// the work per call from which a model's dispatch overhead stops mattering.
+
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace intensity_sweep {
+
+// Overhead is measured against this model (static dispatch, inlined)
+inline const std::string kReferenceModel = "crtp";
+
+// Overhead levels reported by the crossover table
+constexpr double kCrossoverThresholds[] = {0.25, 0.10, 0.05};
+
+// "runtime", "crtp", "concepts", "variant" and "type_erased"
+const std::vector<std::string> &SweepModels();
+
+struct SweepResult {
+  std::string model;
+  size_t chain_length;
+  size_t calls;
+  double ns_per_call;
+};
+
+// Makes `calls` calls of ComputeChain<chain_length> through `model` (fastest
+// of a few runs). Throws std::invalid_argument for an unknown model or a
+// length not in kChainLengths.
+SweepResult
+MeasureChain(const std::string &model, size_t chain_length, size_t calls);
+
+// (model time - reference time) / reference time at the same chain length,
+// if the reference was measured
+std::optional<double> RelativeOverhead(
+    const std::vector<SweepResult> &results,
+    const SweepResult &result
+);
+
+// Smallest chain length from which the model's overhead stays below
+// `threshold` for every longer chain in results
+std::optional<size_t> CrossoverChainLength(
+    const std::vector<SweepResult> &results,
+    const std::string &model,
+    double threshold
+);
+
+void WriteSweepTable(
+    std::ostream &out,
+    const std::vector<SweepResult> &results
+);
+
+// One row per model: the crossover chain length and reference ns per call
+// there, for each of kCrossoverThresholds
+void WriteCrossoverReport(
+    std::ostream &out,
+    const std::vector<SweepResult> &results
+);
+
+// Every chain length gets about iterations FMAs (iterations / K calls)
+void RunIntensitySweepBenchmark(size_t iterations);
+
+} // namespace intensity_sweep
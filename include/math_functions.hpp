@@ -3,7 +3,11 @@
 
 #pragma once
 
+#include "approx_math.hpp"
+#include <array>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 
 // Fused Multiply-Add: x * 1.414 + 2.718 (Approximates sqrt(2) and e)
 inline double ComputeFMA(double x) { return x * 1.414 + 2.718; }
@@ -12,3 +16,99 @@ inline double ComputeFMA(double x) { return x * 1.414 + 2.718; }
 inline double ComputeExpensive(double x) {
   return std::sin(x) * std::log(x + 1) + std::sqrt(x);
 }
+
+// ComputeExpensive built from the table/polynomial approximations in
+// approx_math.hpp instead of libm
+template <Accuracy A>
+inline double ComputeExpensiveApprox(double x) {
+  return ApproxSin<A>(x) * ApproxLog<A>(x + 1) + ApproxSqrt<A>(x);
+}
+
+// ===========================
+// ARITHMETIC-INTENSITY KERNELS
+// ===========================
+
+// Chain lengths instantiated for the intensity sweep
+constexpr std::array<size_t, 9> kChainLengths = {
+    1, 2, 4, 8, 16, 32, 64, 128, 256
+};
+
+// Hides x's value from the optimizer. Call sites pass a constant argument,
+// which would otherwise let inlined kernels be folded at compile time.
+inline double OpaqueValue(double x) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  asm volatile("" : "+x"(x));
+#elif defined(__GNUC__) && defined(__aarch64__)
+  asm volatile("" : "+w"(x));
+#elif defined(__GNUC__)
+  asm volatile("" : "+m"(x));
+#endif
+  return x;
+}
+
+// K dependent FMAs. The step contracts towards 1, so any K stays finite.
+template <size_t K>
+inline double ComputeChain(double x) {
+  x = OpaqueValue(x);
+  for (size_t k = 0; k < K; ++k) {
+    x = x * 0.999 + 0.001;
+  }
+  return x;
+}
+
+// ===========================
+// MEMORY-BOUND (STREAMING) KERNELS
+// ===========================
+
+// Views of the large arrays read/written by the streaming kernels. Array
+// lengths are a power of two so that indices wrap with `mask`. `b` holds
+// mask + 3 elements so the stencil can read b[i + 2] without a bounds check.
+struct StreamArrays {
+  double *a;
+  const double *b;
+  const double *c;
+  const uint32_t *index;
+  size_t mask;
+  size_t prefetch_distance; // 0 disables software prefetch
+};
+
+constexpr double kTriadScalar = 3.0;
+
+// Issues a software prefetch `prefetch_distance` elements ahead of i
+inline void
+PrefetchAhead(const StreamArrays &arrays, const double *base, size_t i) {
+  if (arrays.prefetch_distance != 0) {
+    size_t ahead = (i + arrays.prefetch_distance) & arrays.mask;
+    __builtin_prefetch(base + ahead);
+  }
+}
+
+// STREAM triad: a[i] = b[i] + s * c[i]
+inline double ComputeTriad(const StreamArrays &arrays, size_t i) {
+  PrefetchAhead(arrays, arrays.b, i);
+  PrefetchAhead(arrays, arrays.c, i);
+  arrays.a[i] = arrays.b[i] + kTriadScalar * arrays.c[i];
+  return arrays.a[i];
+}
+
+// One term of the dot product b . c
+inline double ComputeDot(const StreamArrays &arrays, size_t i) {
+  PrefetchAhead(arrays, arrays.b, i);
+  PrefetchAhead(arrays, arrays.c, i);
+  return arrays.b[i] * arrays.c[i];
+}
+
+// Three-point 1D smoothing stencil centred on b[i + 1]
+inline double ComputeStencil(const StreamArrays &arrays, size_t i) {
+  PrefetchAhead(arrays, arrays.b, i);
+  return 0.25 * arrays.b[i] + 0.5 * arrays.b[i + 1] + 0.25 * arrays.b[i + 2];
+}
+
+// Gather b[index[i]] through a random permutation
+inline double ComputeGather(const StreamArrays &arrays, size_t i) {
+  if (arrays.prefetch_distance != 0) {
+    size_t ahead = (i + arrays.prefetch_distance) & arrays.mask;
+    __builtin_prefetch(&arrays.b[arrays.index[ahead]]);
+  }
+  return arrays.b[arrays.index[i]];
+}
@@ -0,0 +1,95 @@
+// Object layout and alignment: a RuntimeBase object is only a vptr, but real
+// objects carry state. Here every object has a hot field that Compute reads
+// and a cold payload it never touches, and the variants differ in
+//  - payload size (kPayloadSizes),
+//  - alignas (kAlignments: natural, or one cache line),
+//  - placement: hot field first (next to the vptr), hot field after the
+//    cold payload, or the payload split into a side array (hot/cold split).
+// Each variant is built for runtime, CRTP and Concepts, and a population of
+// it is swept in sequential and in shuffled order. The report gives the
+// cache lines each call touches (from the objects' real addresses) and, where
+// perf events are allowed, last-level cache misses per call.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace object_layout {
+
+constexpr size_t kCacheLineSize = 64;
+
+// Cold bytes per object. With the vptr and the hot field, a naturally
+// aligned runtime object is 32, 64, 128 or 256 bytes.
+constexpr std::array<size_t, 4> kPayloadSizes = {16, 48, 112, 240};
+
+// alignas of each object: natural (that of the vptr and a double) and one
+// cache line
+constexpr std::array<size_t, 2> kAlignments = {8, kCacheLineSize};
+
+// Objects per population: half a million, so the largest layouts (128 MiB)
+// are far past the last-level cache while the smallest still span 8 MiB
+constexpr size_t kDefaultLayoutPopulation = size_t{1} << 19;
+
+enum class Placement { kHotFirst, kHotLast, kSplit };
+
+// Sequential lets the hardware prefetcher stream the objects in; shuffled
+// makes every call land on an unpredictable object
+enum class Order { kSequential, kShuffled };
+
+std::string PlacementName(Placement placement);
+std::string OrderName(Order order);
+
+const std::vector<Placement> &AllPlacements();
+
+// "runtime", "crtp" and "concepts"
+const std::vector<std::string> &LayoutModels();
+
+struct LayoutConfig {
+  std::string model;
+  size_t payload = kPayloadSizes[0];
+  size_t alignment = kAlignments[0];
+  Placement placement = Placement::kHotFirst;
+  Order order = Order::kSequential;
+};
+
+struct LayoutResult {
+  LayoutConfig config;
+  size_t object_size; // sizeof one object, the array stride
+  size_t hot_offset;  // of the hot field from the start of the object
+  double lines_per_call; // distinct cache lines each call reads, on average
+  size_t calls;
+  double ns_per_call;
+  std::optional<double> cache_misses_per_call; // if counters are available
+};
+
+// Distinct cache lines covered by the 8-byte fields at `field_offsets` of an
+// object at `address`
+size_t
+LinesTouched(uintptr_t address, const std::vector<size_t> &field_offsets);
+
+// Builds `population` objects (half FMA, half ComputeChain<4>, both scaled
+// by the hot field), sweeps them in config.order until at least `calls`
+// calls are made and frees them. Throws std::invalid_argument for an
+// unknown model, payload size or alignment, or an empty population.
+LayoutResult MeasureLayout(
+    const LayoutConfig &config,
+    size_t population,
+    size_t calls
+);
+
+void WriteLayoutTable(
+    std::ostream &out,
+    const std::vector<LayoutResult> &results
+);
+
+// Every combination of order, payload, alignment, placement and model,
+// splitting `iterations` calls between them (at least one sweep each)
+void RunObjectLayoutBenchmark(size_t iterations);
+
+} // namespace object_layout
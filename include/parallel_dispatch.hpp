@@ -0,0 +1,62 @@
+// Parallel evaluation of a large heterogeneous FMA/Expensive population
+// through each dispatch model. Compares static splitting (OpenMP-style
+// schedule(static)), the work-stealing pool and std::execution::par, from one
+// thread up to every available CPU.
+
+#pragma once
+
+#include "work_stealing_pool.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace parallel_dispatch {
+
+constexpr size_t kPopulation = size_t{1} << 20;
+constexpr size_t kDefaultChunkSize = 256;
+
+enum class Executor { kStatic, kWorkStealing, kStdPar };
+
+std::string ExecutorName(Executor executor);
+
+// Which items are PolyExpensive. The chance ramps from 0 at the first item
+// to 1 at the last (as when objects are created in phases), so equal index
+// ranges carry very different amounts of work.
+std::vector<uint8_t> MakeExpensiveMask(size_t population, uint64_t seed);
+
+// "runtime", "crtp", "concepts", "variant" and "type_erased"
+const std::vector<std::string> &ParallelModels();
+
+struct ParallelResult {
+  std::string model;
+  Executor executor;
+  size_t threads;
+  double calls_per_second;
+  double mean_idle_fraction; // idle / wall, averaged over workers
+  double max_idle_fraction;
+  size_t steals;
+  double sum; // identical for every executor and thread count
+};
+
+// Evaluates the population `passes` times. std::execution::par rows report
+// no idle time (the backend doesn't expose it). Throws
+// std::invalid_argument for an unknown model.
+ParallelResult MeasureParallel(
+    const std::string &model,
+    Executor executor,
+    WorkStealingPool &pool,
+    const std::vector<uint8_t> &expensive_mask,
+    size_t passes
+);
+
+// Speedup is relative to the same model and executor on one thread
+void WriteParallelTable(
+    std::ostream &out,
+    const std::vector<ParallelResult> &results
+);
+
+void RunParallelDispatchBenchmark(size_t iterations);
+
+} // namespace parallel_dispatch
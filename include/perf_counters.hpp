@@ -0,0 +1,60 @@
+// Hardware counters for the calling thread, and for threads it creates after
+// the counters are opened, via perf_event_open, so a window of work (e.g. one
+// server job, including a scenario's worker threads) can be measured from
+// inside the process. Threads that already existed are not counted.
+// Events the kernel or CPU refuse (VMs, perf_event_paranoid) are skipped.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct CounterReading {
+  std::string name;
+  uint64_t value;
+};
+
+// Independent events, not a perf group: the PMU may schedule each one on
+// its own when there are more events than hardware counters, so each count
+// is scaled by its own enabled/running time over the window
+class PerfCounters {
+public:
+  // Opens the default events: cycles, instructions, branches,
+  // branch-misses, cache-references and cache-misses (user space only)
+  PerfCounters();
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+  // Opens a window: enables every opened counter and snapshots it
+  void Start();
+  // Closes the window: snapshots and disables every counter
+  void Stop();
+
+  // Counts between the last Start() and Stop(), each scaled by the time it
+  // was enabled over the time it ran within that window (the kernel
+  // multiplexes events that don't fit on the PMU). All zero before the
+  // first window.
+  std::vector<CounterReading> Read() const;
+
+  bool available() const { return !counters_.empty(); }
+
+private:
+  // As returned by read(): the count and the time enabled and running, all
+  // cumulative over the fd's lifetime
+  struct Sample {
+    uint64_t value = 0;
+    uint64_t enabled = 0;
+    uint64_t running = 0;
+  };
+
+  struct Counter {
+    std::string name;
+    int fd;
+    Sample start;
+    Sample window; // Stop() minus Start()
+  };
+  std::vector<Counter> counters_;
+};
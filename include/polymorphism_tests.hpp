@@ -18,4 +18,36 @@ void TestCRTPExpensive(size_t iterations);
 void TestConceptsFMA(size_t iterations);
 void TestConceptsExpensive(size_t iterations);
 
+// Approximate (table + polynomial) ComputeExpensive kernels
+template <Accuracy A>
+void TestRuntimeExpensiveApprox(size_t iterations);
+template <Accuracy A>
+void TestCRTPExpensiveApprox(size_t iterations);
+template <Accuracy A>
+void TestConceptsExpensiveApprox(size_t iterations);
+
+// K dependent FMAs per call, for each K in kChainLengths
+template <size_t K>
+void TestRuntimeChain(size_t iterations);
+template <size_t K>
+void TestCRTPChain(size_t iterations);
+template <size_t K>
+void TestConceptsChain(size_t iterations);
+
+// Memory-bound (streaming) kernels
+void TestRuntimeTriad(size_t iterations);
+void TestRuntimeDot(size_t iterations);
+void TestRuntimeStencil(size_t iterations);
+void TestRuntimeGather(size_t iterations);
+
+void TestCRTPTriad(size_t iterations);
+void TestCRTPDot(size_t iterations);
+void TestCRTPStencil(size_t iterations);
+void TestCRTPGather(size_t iterations);
+
+void TestConceptsTriad(size_t iterations);
+void TestConceptsDot(size_t iterations);
+void TestConceptsStencil(size_t iterations);
+void TestConceptsGather(size_t iterations);
+
 }  // namespace polymorphism_tests
@@ -0,0 +1,93 @@
+// Content-addressed cache of benchmark results. An entry is keyed on
+// everything that can change a measurement: a hash of this binary, its
+// COMPILER_FLAGS, the CPU model and the job (including the command-line
+// options it runs with). Entries older than the freshness window are treated
+// as missing and re-measured.
+//
+// Each entry is <dir>/<digest>.entry, where digest is the FNV-1a hash of the
+// key. The first line is the key itself (checked on lookup, so a hash
+// collision reads as a miss) and the rest is the payload. The Python drivers
+// use the same layout (test/profiling/result_cache.py) and the same
+// directory.
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace result_cache {
+
+constexpr int64_t kDefaultMaxAgeSeconds = 7 * 24 * 60 * 60;
+
+struct ResultCacheOptions {
+  std::string dir; // caching is off while empty
+  int64_t max_age_seconds = kDefaultMaxAgeSeconds;
+};
+
+// Options used by the benchmark server (set from the command line)
+ResultCacheOptions &GetResultCacheOptions();
+
+constexpr uint64_t kFnvOffset = 0xcbf29ce484222325ULL;
+constexpr uint64_t kFnvPrime = 0x100000001b3ULL;
+
+// 64-bit FNV-1a, continuing from `hash`
+constexpr uint64_t Fnv1a(std::string_view data, uint64_t hash = kFnvOffset) {
+  for (char c : data) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= kFnvPrime;
+  }
+  return hash;
+}
+
+// 16 lowercase hex digits
+std::string ToHex(uint64_t value);
+
+// FNV-1a of a file's contents. Throws std::runtime_error if it can't be read.
+std::string HashFile(const std::string &path);
+
+// "model name" from /proc/cpuinfo, or "unknown"
+std::string CpuModel();
+
+// What a result depends on besides the job
+struct Identity {
+  std::string binary_hash;
+  std::string compiler_flags;
+  std::string cpu_model;
+};
+
+// This process: hash of /proc/self/exe, COMPILER_FLAGS and CpuModel().
+// Computed on first use.
+const Identity &GetIdentity();
+
+// {"binary_hash":...,"compiler_flags":...,"cpu_model":...}
+std::string IdentityJson(const Identity &identity);
+
+// One line: a format version, the identity fields and the job, separated by
+// tabs
+std::string MakeKey(const Identity &identity, const std::string &job);
+
+// Hex FNV-1a of the key, used as the entry's file name
+std::string Digest(const std::string &key);
+
+class ResultCache {
+public:
+  ResultCache(std::string dir, int64_t max_age_seconds);
+
+  // Payload of the entry for `key`, if it exists, matches the key exactly and
+  // is no older than the freshness window
+  std::optional<std::string> Lookup(const std::string &key) const;
+
+  // Writes the entry through a temporary file and a rename, so concurrent
+  // readers never see half an entry. Returns false if it couldn't be written.
+  bool Store(const std::string &key, const std::string &payload) const;
+
+  std::string EntryPath(const std::string &key) const;
+
+private:
+  std::string dir_;
+  int64_t max_age_seconds_;
+};
+
+} // namespace result_cache
@@ -23,6 +23,71 @@ public:
   double Compute(double x) const override;
 };
 
+// ComputeExpensive with approximate sin/log/sqrt (see approx_math.hpp)
+template <Accuracy A>
+class PolyExpensiveApprox : public RuntimeBase {
+public:
+  double Compute(double x) const override;
+};
+
+// K dependent FMAs per call (see ComputeChain)
+template <size_t K>
+class PolyChain : public RuntimeBase {
+public:
+  double Compute(double x) const override;
+};
+
 void TestRuntimePolymorphism(const std::string &label, size_t n, RuntimeBase &obj);
 
+// Memory-bound kernels take an element index instead of a value
+
+class RuntimeStreamBase {
+public:
+  virtual double Compute(size_t i) const = 0;
+  virtual ~RuntimeStreamBase() = default;
+};
+
+class PolyTriad : public RuntimeStreamBase {
+public:
+  explicit PolyTriad(const StreamArrays &arrays) : arrays_(arrays) {}
+  double Compute(size_t i) const override;
+
+private:
+  StreamArrays arrays_;
+};
+
+class PolyDot : public RuntimeStreamBase {
+public:
+  explicit PolyDot(const StreamArrays &arrays) : arrays_(arrays) {}
+  double Compute(size_t i) const override;
+
+private:
+  StreamArrays arrays_;
+};
+
+class PolyStencil : public RuntimeStreamBase {
+public:
+  explicit PolyStencil(const StreamArrays &arrays) : arrays_(arrays) {}
+  double Compute(size_t i) const override;
+
+private:
+  StreamArrays arrays_;
+};
+
+class PolyGather : public RuntimeStreamBase {
+public:
+  explicit PolyGather(const StreamArrays &arrays) : arrays_(arrays) {}
+  double Compute(size_t i) const override;
+
+private:
+  StreamArrays arrays_;
+};
+
+void TestRuntimeStreamPolymorphism(
+    const std::string &label,
+    size_t n,
+    size_t mask,
+    RuntimeStreamBase &obj
+);
+
 } // namespace runtime_polymorphism
@@ -0,0 +1,149 @@
+// In-binary sampling profiler for the timed region of a benchmark case.
+// Samples the calling thread's user-space stack with perf_event_open (CPU
+// cycles, or the cpu-clock software event where there's no PMU) and falls
+// back to a SIGPROF timer on the thread's CPU-time clock when perf events
+// aren't permitted. Samples are symbolized from the binary's own symbol table
+// and debug info, then written as a pprof profile and a top-N text report.
+// Instrumentation uses PROFILE_SCOPE, which compiles to nothing unless
+// ENABLE_PROFILING is defined.
+
+#pragma once
+
+#include "symbolizer.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sampling_profiler {
+
+// Frames kept per sample (leaf first)
+constexpr size_t kMaxFrames = 32;
+
+// Samples kept per profile; later samples are counted as lost
+constexpr size_t kMaxSamples = size_t{1} << 15;
+
+struct ProfilerOptions {
+  std::string output_dir; // profiling is off while empty
+  size_t top = 10;        // rows in the text report
+  int frequency_hz = 1000;
+};
+
+ProfilerOptions &GetProfilerOptions();
+
+enum class Backend { kPerfCycles, kPerfCpuClock, kSignal };
+
+std::string BackendName(Backend backend);
+
+// Call stacks collected between Start() and Stop(). stacks[i][0] is the
+// sampled instruction; the frames after it are return addresses.
+struct Profile {
+  Backend backend = Backend::kSignal;
+  int frequency_hz = 0;
+  std::vector<std::vector<uint64_t>> stacks;
+  uint64_t lost = 0;
+
+  // Nominal time per sample
+  int64_t PeriodNs() const {
+    return frequency_hz > 0 ? 1'000'000'000 / frequency_hz : 0;
+  }
+};
+
+class SamplingProfiler {
+public:
+  // allow_perf_event = false goes straight to the SIGPROF fallback
+  explicit SamplingProfiler(int frequency_hz, bool allow_perf_event = true);
+  ~SamplingProfiler();
+
+  SamplingProfiler(const SamplingProfiler &) = delete;
+  SamplingProfiler &operator=(const SamplingProfiler &) = delete;
+
+  // Starts sampling the calling thread. Returns false if no backend could be
+  // started or another profiler is running.
+  bool Start();
+
+  // Stops sampling (from the thread that called Start) and returns the
+  // samples
+  Profile Stop();
+
+  Backend backend() const { return backend_; }
+
+private:
+  bool StartPerfEvent(uint32_t type, uint64_t config);
+  bool StartSignal();
+  void DrainRingBuffer();
+  void ReadRingBufferLoop();
+
+  int frequency_hz_;
+  bool allow_perf_event_;
+  bool running_ = false;
+  Backend backend_ = Backend::kSignal;
+  Profile profile_;
+
+  // perf_event_open backend: ring buffer drained by a reader thread
+  int perf_fd_ = -1;
+  void *ring_ = nullptr;
+  size_t ring_bytes_ = 0;
+  std::atomic<bool> stop_reader_{false};
+  std::thread reader_;
+};
+
+// Encodes the profile as an (uncompressed) pprof profile.proto, with
+// samples/count and cpu/nanoseconds values
+std::string EncodePprof(const Profile &profile, const Symbolizer &symbolizer);
+
+// Functions ranked by self samples (leaf frame), with cumulative samples
+// (anywhere on the stack) and each function's hottest source line
+void WriteTopReport(
+    std::ostream &out,
+    const std::string &label,
+    const Profile &profile,
+    const Symbolizer &symbolizer,
+    size_t top
+);
+
+// Symbol tables of this process, loaded on first use
+const Symbolizer &GetSymbolizer();
+
+// Profiles [construction, destruction) of a scope if GetProfilerOptions()
+// has an output directory. The destructor only stops sampling and queues the
+// profile; symbolizing and output wait for FlushProfiles(), so they stay out
+// of whatever the caller is timing. Nested or concurrent scopes are ignored
+// while one is running.
+class ScopedProfile {
+public:
+  explicit ScopedProfile(const std::string &label);
+  ~ScopedProfile();
+
+  ScopedProfile(const ScopedProfile &) = delete;
+  ScopedProfile &operator=(const ScopedProfile &) = delete;
+
+private:
+  std::string label_;
+  std::unique_ptr<SamplingProfiler> profiler_;
+};
+
+// Profiles queued by ScopedProfile and not yet flushed
+size_t PendingProfileCount();
+
+// Writes <dir>/<label>.pb and <dir>/<label>.txt for every queued profile and
+// prints its report. RunTestCase calls it after stopping its clock.
+void FlushProfiles();
+
+} // namespace sampling_profiler
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef ENABLE_PROFILING
+#define PROFILE_SCOPE(label)                                                   \
+  ::sampling_profiler::ScopedProfile PROFILE_CONCAT(profile_scope_, __LINE__)( \
+      label                                                                    \
+  )
+#else
+#define PROFILE_SCOPE(label) ((void)0)
+#endif
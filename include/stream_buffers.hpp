@@ -0,0 +1,54 @@
+// Owning storage and run-time options for the memory-bound kernels in
+// math_functions.hpp.
+
+#pragma once
+
+#include "huge_page_buffer.hpp"
+#include "math_functions.hpp"
+#include <cstddef>
+
+// Default elements per array: 2^24 doubles = 128 MiB, well beyond the LLC
+constexpr size_t kDefaultStreamLength = size_t{1} << 24;
+
+struct StreamOptions {
+  size_t length = kDefaultStreamLength; // must be a power of two
+  HugePageMode huge_pages = HugePageMode::kTransparent;
+  size_t prefetch_distance = 0; // elements ahead, 0 = no software prefetch
+};
+
+// Options used by the streaming test cases (set from the command line)
+StreamOptions &GetStreamOptions();
+
+bool IsPowerOfTwo(size_t value);
+
+// Allocates and initializes the arrays behind a StreamArrays view. All pages
+// are touched during construction so that page faults stay out of the timed
+// loop.
+class StreamBuffers {
+public:
+  explicit StreamBuffers(const StreamOptions &options);
+
+  const StreamOptions &options() const { return options_; }
+  const StreamArrays &arrays() const { return arrays_; }
+  size_t length() const { return arrays_.mask + 1; }
+  HugePageMode mode() const { return a_.mode(); }
+
+private:
+  StreamOptions options_;
+  HugePageBuffer a_;
+  HugePageBuffer b_;
+  HugePageBuffer c_;
+  HugePageBuffer index_;
+  StreamArrays arrays_;
+};
+
+void PrintStreamBuffersInfo(const StreamBuffers &buffers);
+
+// Buffers for GetStreamOptions(), shared by the streaming test cases and
+// kept between runs. Built on first use and rebuilt when the options have
+// changed since.
+const StreamBuffers &SharedStreamBuffers();
+
+// Builds SharedStreamBuffers() ahead of a timed run (TestCase::prepare), so
+// that mapping, faulting and shuffling stay out of the measurement
+void PrepareStreamBuffers();
@@ -0,0 +1,69 @@
+// Resolves code addresses of the running process to function names and
+// source lines without external tools. Functions in the executable come from
+// its ELF symbol table and lines from its DWARF .debug_line section (present
+// with -g, e.g. -DENABLE_PROFILING=ON); addresses in shared libraries fall
+// back to dladdr, which only sees exported symbols.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct SourceLocation {
+  std::string function; // demangled, or "module+0xoffset" if unknown
+  std::string file;     // empty without line info
+  uint32_t line = 0;
+};
+
+class Symbolizer {
+public:
+  // Loads the symbol and line tables of /proc/self/exe
+  Symbolizer();
+
+  // Resolves an address. Pass the exact instruction address; for return
+  // addresses from a stack walk, pass the address minus one so the line is
+  // the call's rather than the next statement's.
+  SourceLocation Resolve(uint64_t address) const;
+
+  // Whether the address lies in the executable (rather than a library)
+  bool InExecutable(uint64_t address) const;
+
+  bool has_symbols() const { return !symbols_.empty(); }
+  bool has_line_info() const { return !rows_.empty(); }
+
+  uint64_t executable_start() const { return executable_start_; }
+  uint64_t executable_end() const { return executable_end_; }
+  const std::string &executable_path() const { return executable_path_; }
+
+private:
+  struct Symbol {
+    uint64_t start; // link-time addresses (runtime address - load bias)
+    uint64_t end;
+    std::string name;
+  };
+
+  struct LineRow {
+    uint64_t address;
+    uint32_t file; // index into files_
+    uint32_t line; // 0 marks the end of a sequence
+  };
+
+  void LoadElf(const std::vector<char> &image);
+  void LoadLineTable(
+      const char *data,
+      size_t size,
+      const char *line_strings,
+      size_t line_strings_size,
+      const char *strings,
+      size_t strings_size
+  );
+
+  std::vector<Symbol> symbols_; // sorted by start
+  std::vector<LineRow> rows_;   // sorted by address
+  std::vector<std::string> files_;
+  uint64_t load_bias_ = 0;
+  uint64_t executable_start_ = 0;
+  uint64_t executable_end_ = 0;
+  std::string executable_path_;
+};
@@ -23,6 +23,14 @@ std::chrono::duration<double> RunSingleTest(
     bool write_to_file
 );
 
+// Scenarios are self-contained benchmarks that don't fit the
+// category x computation grid (they compare several dispatch strategies in
+// one run and print their own report)
+const std::unordered_map<std::string, TestCase> &GetScenarioMap();
+const TestCase &GetScenarioTestCase(const std::string &scenario);
+std::chrono::duration<double>
+RunScenario(const std::string &scenario, size_t iterations);
+
 void RunAllTests(size_t iterations, bool save_execution_times);
 void RunAndSaveAllTests(size_t iterations);
 void RunAllTestsWithoutSaving(size_t iterations);
@@ -0,0 +1,69 @@
+// Multi-threaded scaling mode ("-t N"): runs one category/computation test
+// case on 1, 2, 4, ... N pinned threads at once. Each thread publishes its
+// running sum to its own cache-line-padded slot, or, with "--shared-sink", to
+// adjacent slots in shared cache lines to expose false sharing.
+
+#pragma once
+
+#include "benchmark_utils.hpp"
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace thread_scaling {
+
+enum class SinkLayout { kPadded, kShared };
+
+std::string SinkLayoutName(SinkLayout layout);
+
+struct ThreadScalingOptions {
+  size_t threads = 0; // 0 = single-threaded mode
+  bool shared_sink = false;
+};
+
+ThreadScalingOptions &GetThreadScalingOptions();
+
+struct ScalingResult {
+  size_t threads;
+  SinkLayout layout;
+  size_t calls; // over all threads
+  double wall_seconds; // first thread released to last thread done
+  double fastest_thread_seconds;
+  double slowest_thread_seconds;
+  bool pinned; // every thread got its own CPU pin
+
+  double CallsPerSecond() const { return calls / wall_seconds; }
+};
+
+// False for test cases with shared setup (TestCase::prepare), i.e. the
+// streaming kernels: their buffers are too large to give every thread its
+// own, and sharing them would have the threads race on the written array
+bool SupportsThreadScaling(const TestCase &test_case);
+
+// Releases `threads` pinned threads together; each runs test_case with
+// `iterations` calls. Throws std::invalid_argument if the test case doesn't
+// support thread scaling.
+ScalingResult RunConcurrently(
+    const TestCase &test_case,
+    size_t iterations,
+    size_t threads,
+    SinkLayout layout
+);
+
+// Scaling efficiency is throughput / (threads x one-thread throughput) for
+// the same sink layout
+void WriteScalingTable(
+    std::ostream &out,
+    const std::vector<ScalingResult> &results
+);
+
+// Sweeps 1, 2, 4, ... options.threads threads (padded sinks, plus shared
+// sinks if requested) and prints the scaling table
+void RunThreadScaling(
+    const TestCase &test_case,
+    size_t iterations,
+    const ThreadScalingOptions &options
+);
+
+} // namespace thread_scaling
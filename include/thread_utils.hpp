@@ -0,0 +1,69 @@
+// Helpers shared by the multi-threaded benchmarks: CPU pinning and
+// cache-line padding for per-thread data.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Assumed destructive interference size (std::hardware_destructive_
+// interference_size is not ABI-stable across GCC versions)
+constexpr size_t kCacheLineSize = 64;
+
+// Keeps each T on its own cache line(s), so per-thread slots in an array
+// don't false-share
+template <typename T>
+struct alignas(kCacheLineSize) CacheLinePadded {
+  T value{};
+};
+
+// The process's affinity mask as a list of CPUs, captured on first use.
+// Every pin below goes through it first, so it is taken before any thread
+// is narrowed down; a thread created by a pinned thread would otherwise
+// inherit the one-CPU mask and see a single CPU. Empty if affinity isn't
+// supported.
+const std::vector<int> &ProcessCpus();
+
+// Logical CPUs available to this process (at least 1)
+size_t HardwareThreadCount();
+
+// Pins the calling thread to one logical CPU, the cpu_index-th of
+// ProcessCpus() (modulo their count). Returns false if pinning isn't
+// supported or fails.
+bool PinCurrentThread(size_t cpu_index);
+
+// Pins the calling thread for the lifetime of the object and then restores
+// the affinity it had before
+class ScopedThreadPin {
+public:
+  explicit ScopedThreadPin(size_t cpu_index);
+  ~ScopedThreadPin();
+
+  ScopedThreadPin(const ScopedThreadPin &) = delete;
+  ScopedThreadPin &operator=(const ScopedThreadPin &) = delete;
+
+  bool pinned() const { return pinned_; }
+
+private:
+  std::vector<int> previous_cpus_;
+  bool pinned_ = false;
+};
+
+// Widens the calling thread to all of ProcessCpus() for the lifetime of the
+// object and then restores the affinity it had before. Threads created in
+// the meantime (e.g. by TBB) inherit the wide mask.
+class ScopedProcessAffinity {
+public:
+  ScopedProcessAffinity();
+  ~ScopedProcessAffinity();
+
+  ScopedProcessAffinity(const ScopedProcessAffinity &) = delete;
+  ScopedProcessAffinity &operator=(const ScopedProcessAffinity &) = delete;
+
+private:
+  std::vector<int> previous_cpus_;
+  bool widened_ = false;
+};
+
+// 1, 2, 4, ... up to max_threads, always ending with max_threads
+std::vector<size_t> ThreadCountSweep(size_t max_threads);
@@ -0,0 +1,108 @@
+// Low-overhead in-process tracing of scoped events, exported as Chrome /
+// Perfetto trace JSON. Each thread records into its own lock-free ring
+// buffer, so recording never blocks. Instrumentation uses TRACE_SCOPE, which
+// compiles to nothing unless ENABLE_TRACING is defined.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace trace {
+
+struct TraceEvent {
+  const char *name; // must outlive the trace (string literal or static)
+  uint64_t start_ns;
+  uint64_t end_ns;
+};
+
+// Events kept per thread; once full, the oldest events are overwritten
+constexpr size_t kRingCapacity = size_t{1} << 14;
+
+// Single-producer ring buffer owned by one thread. Readers only run after the
+// traced work is done (e.g. when writing the trace file).
+class ThreadTraceBuffer {
+public:
+  explicit ThreadTraceBuffer(uint32_t thread_id) : thread_id_(thread_id) {}
+
+  void Record(const char *name, uint64_t start_ns, uint64_t end_ns) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    events_[head & (kRingCapacity - 1)] = TraceEvent{name, start_ns, end_ns};
+    head_.store(head + 1, std::memory_order_release);
+  }
+
+  void Clear() { head_.store(0, std::memory_order_release); }
+
+  uint64_t total_recorded() const {
+    return head_.load(std::memory_order_acquire);
+  }
+  uint64_t dropped() const {
+    uint64_t total = total_recorded();
+    return total > kRingCapacity ? total - kRingCapacity : 0;
+  }
+  uint32_t thread_id() const { return thread_id_; }
+
+  // Visits the retained events from oldest to newest
+  template <typename Visitor>
+  void ForEach(Visitor &&visit) const {
+    uint64_t head = total_recorded();
+    uint64_t first = head > kRingCapacity ? head - kRingCapacity : 0;
+    for (uint64_t i = first; i < head; ++i) {
+      visit(events_[i & (kRingCapacity - 1)]);
+    }
+  }
+
+private:
+  std::array<TraceEvent, kRingCapacity> events_{};
+  std::atomic<uint64_t> head_{0};
+  uint32_t thread_id_;
+};
+
+// Nanoseconds since the first call in this process (steady clock)
+uint64_t NowNs();
+
+// Returns a pointer to a process-lifetime copy of `name`, for event names
+// built at run time
+const char *Intern(const std::string &name);
+
+// Buffer for the calling thread, created and registered on first use
+ThreadTraceBuffer &GetThreadBuffer();
+
+// Discards all recorded events (buffers stay registered). Must not race
+// with recording threads.
+void ResetTrace();
+
+// Writes every thread's retained events as Chrome trace JSON. Returns false
+// if the file can't be opened.
+bool WriteChromeTrace(const std::string &filepath);
+
+// Records [construction, destruction) of a scope
+class ScopedEvent {
+public:
+  explicit ScopedEvent(const char *name)
+      : buffer_(GetThreadBuffer()), name_(name), start_ns_(NowNs()) {}
+  ~ScopedEvent() { buffer_.Record(name_, start_ns_, NowNs()); }
+
+  ScopedEvent(const ScopedEvent &) = delete;
+  ScopedEvent &operator=(const ScopedEvent &) = delete;
+
+private:
+  ThreadTraceBuffer &buffer_;
+  const char *name_;
+  uint64_t start_ns_;
+};
+
+} // namespace trace
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef ENABLE_TRACING
+#define TRACE_SCOPE(name)                                                      \
+  ::trace::ScopedEvent TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#endif
@@ -0,0 +1,116 @@
+// Value-semantic dispatch models: a closed std::variant over the CRTP types,
+// and an open type-erased wrapper with a small-buffer optimization (SBO).
+// Both hold heterogeneous objects in contiguous storage without a heap
+// allocation per object.
+
+#pragma once
+
+#include "concepts_polymorphism.hpp"
+#include "crtp_polymorphism.hpp"
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace value_polymorphism {
+
+using concepts_polymorphism::Computable;
+
+// ===========================
+// VARIANT
+// ===========================
+
+using PolyVariant =
+    std::variant<crtp_polymorphism::PolyFMA, crtp_polymorphism::PolyExpensive>;
+
+inline double Compute(const PolyVariant &object, double x) {
+  return std::visit([x](const auto &held) { return held.Compute(x); }, object);
+}
+
+// ===========================
+// TYPE-ERASED WITH SBO
+// ===========================
+
+// Holds any Computable. Types that fit kInlineSize bytes live inside the
+// wrapper; larger ones fall back to a heap allocation. Move-only.
+class PolyAny {
+public:
+  static constexpr size_t kInlineSize = 2 * sizeof(void *);
+
+  template <typename T>
+  static constexpr bool kFitsInline =
+      sizeof(T) <= kInlineSize && alignof(T) <= alignof(void *) &&
+      std::is_nothrow_move_constructible_v<T>;
+
+  template <Computable T>
+    requires(!std::is_same_v<std::decay_t<T>, PolyAny>)
+  explicit PolyAny(T value) {
+    if constexpr (kFitsInline<T>) {
+      ::new (storage_) T(std::move(value));
+      ops_ = &kInlineOps<T>;
+    } else {
+      ::new (storage_) T *(new T(std::move(value)));
+      ops_ = &kHeapOps<T>;
+    }
+  }
+
+  PolyAny(PolyAny &&other) noexcept : ops_(other.ops_) {
+    ops_->move(storage_, other.storage_);
+  }
+  PolyAny &operator=(PolyAny &&other) noexcept {
+    if (this != &other) {
+      ops_->destroy(storage_);
+      ops_ = other.ops_;
+      ops_->move(storage_, other.storage_);
+    }
+    return *this;
+  }
+  PolyAny(const PolyAny &) = delete;
+  PolyAny &operator=(const PolyAny &) = delete;
+  ~PolyAny() { ops_->destroy(storage_); }
+
+  double Compute(double x) const { return ops_->compute(storage_, x); }
+  bool is_inline() const { return ops_->is_inline; }
+
+private:
+  // Hand-rolled vtable, one static instance per held type and storage kind
+  struct Ops {
+    double (*compute)(const void *storage, double x);
+    void (*move)(void *destination, void *source) noexcept;
+    void (*destroy)(void *storage) noexcept;
+    bool is_inline;
+  };
+
+  template <typename T>
+  static constexpr Ops kInlineOps = {
+      [](const void *storage, double x) {
+        return static_cast<const T *>(storage)->Compute(x);
+      },
+      [](void *destination, void *source) noexcept {
+        ::new (destination) T(std::move(*static_cast<T *>(source)));
+      },
+      [](void *storage) noexcept { static_cast<T *>(storage)->~T(); },
+      true,
+  };
+
+  // Storage holds a T*; a moved-from wrapper keeps a null pointer
+  template <typename T>
+  static constexpr Ops kHeapOps = {
+      [](const void *storage, double x) {
+        return (*static_cast<T *const *>(storage))->Compute(x);
+      },
+      [](void *destination, void *source) noexcept {
+        auto **from = static_cast<T **>(source);
+        ::new (destination) T *(*from);
+        *from = nullptr;
+      },
+      [](void *storage) noexcept { delete *static_cast<T **>(storage); },
+      false,
+  };
+
+  const Ops *ops_;
+  alignas(void *) unsigned char storage_[kInlineSize];
+};
+
+} // namespace value_polymorphism
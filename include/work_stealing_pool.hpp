@@ -0,0 +1,86 @@
+// Fixed-size thread pool for parallel loops over index ranges. The range is
+// cut into chunks that are dealt out as contiguous blocks, one block per
+// worker, so that kStatic reproduces OpenMP's schedule(static). With
+// kWorkStealing, a worker that runs out takes chunks from the far end of
+// another worker's block, which rebalances uneven per-item costs.
+
+#pragma once
+
+#include "thread_utils.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+enum class Schedule { kStatic, kWorkStealing };
+
+struct WorkerStats {
+  double busy_ns = 0.0; // inside the loop body
+  double idle_ns = 0.0; // rest of the ParallelFor call
+  size_t chunks = 0;
+  size_t steals = 0;
+};
+
+struct ParallelForStats {
+  double wall_ns = 0.0;
+  std::vector<WorkerStats> workers;
+};
+
+class WorkStealingPool {
+public:
+  // body(begin, end, worker_index) runs one chunk
+  using Body = std::function<void(size_t, size_t, size_t)>;
+
+  // num_threads includes the calling thread, which runs as worker 0. Worker
+  // i is pinned to CPU i when pin_threads is set (the calling thread only
+  // while the pool exists).
+  explicit WorkStealingPool(size_t num_threads, bool pin_threads = true);
+  ~WorkStealingPool();
+
+  WorkStealingPool(const WorkStealingPool &) = delete;
+  WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+  // Runs body over [0, n) in chunks of chunk_size and returns once every
+  // chunk is done. Not reentrant.
+  ParallelForStats
+  ParallelFor(size_t n, size_t chunk_size, Schedule schedule, const Body &body);
+
+  size_t num_threads() const { return queues_.size(); }
+
+private:
+  struct Range {
+    size_t begin;
+    size_t end;
+  };
+
+  struct alignas(kCacheLineSize) WorkerQueue {
+    std::mutex mutex;
+    std::deque<Range> ranges;
+  };
+
+  void WorkerLoop(size_t worker);
+  void RunWorker(size_t worker);
+  bool PopOwn(size_t worker, Range &range);
+  bool Steal(size_t thief, Range &range);
+
+  std::vector<WorkerQueue> queues_;
+  std::vector<CacheLinePadded<WorkerStats>> stats_;
+  std::vector<std::thread> threads_;
+  std::unique_ptr<ScopedThreadPin> caller_pin_; // worker 0, undone on exit
+
+  // Current job, published under mutex_ by bumping generation_
+  std::mutex mutex_;
+  std::condition_variable job_ready_;
+  std::condition_variable job_done_;
+  size_t generation_ = 0;
+  size_t workers_finished_ = 0;
+  bool stopping_ = false;
+  const Body *body_ = nullptr;
+  Schedule schedule_ = Schedule::kStatic;
+  std::chrono::steady_clock::time_point job_start_;
+};
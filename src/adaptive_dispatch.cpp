@@ -0,0 +1,194 @@
+#include "adaptive_dispatch.hpp"
+#include "benchmark_utils.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+
+namespace adaptive_dispatch {
+
+namespace {
+
+using runtime_polymorphism::PolyExpensive;
+using runtime_polymorphism::PolyFMA;
+
+// Items handed to the call site per Evaluate() call
+constexpr size_t kBatchSize = 4096;
+
+// Distinct items generated per phase (cycled until the phase's share of the
+// iterations is used up)
+constexpr size_t kPoolSize = size_t{1} << 16;
+
+// Heap-allocated objects of each type the items point into
+constexpr size_t kObjectsPerType = 1024;
+
+struct Phase {
+  const char *name;
+  double fma_share;
+};
+
+constexpr Phase kPhases[] = {
+    {"95% fma", 0.95},
+    {"50/50", 0.50},
+    {"95% expensive", 0.05},
+};
+constexpr size_t kNumPhases = std::size(kPhases);
+
+struct Population {
+  std::vector<std::unique_ptr<RuntimeBase>> fma_objects;
+  std::vector<std::unique_ptr<RuntimeBase>> expensive_objects;
+  std::array<std::vector<DispatchItem>, kNumPhases> phase_items;
+};
+
+Population BuildPopulation() {
+  Population population;
+  for (size_t i = 0; i < kObjectsPerType; ++i) {
+    population.fma_objects.push_back(std::make_unique<PolyFMA>());
+    population.expensive_objects.push_back(std::make_unique<PolyExpensive>());
+  }
+
+  std::mt19937_64 rng{42};
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  std::uniform_int_distribution<size_t> pick(0, kObjectsPerType - 1);
+  for (size_t p = 0; p < kNumPhases; ++p) {
+    auto &items = population.phase_items[p];
+    items.reserve(kPoolSize);
+    for (size_t i = 0; i < kPoolSize; ++i) {
+      const auto &objects = unit(rng) < kPhases[p].fma_share
+                                ? population.fma_objects
+                                : population.expensive_objects;
+      items.push_back({objects[pick(rng)].get(), 1.0 + unit(rng)});
+    }
+  }
+  return population;
+}
+
+// Runs `evaluate` over every phase and returns the elapsed time per phase
+template <typename Evaluate>
+std::array<std::chrono::duration<double>, kNumPhases> TimePhases(
+    const Population &population,
+    size_t calls_per_phase,
+    Evaluate &&evaluate
+) {
+  std::array<std::chrono::duration<double>, kNumPhases> elapsed{};
+  for (size_t p = 0; p < kNumPhases; ++p) {
+    std::span<const DispatchItem> pool(population.phase_items[p]);
+    double sum = 0.0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t done = 0; done < calls_per_phase; done += kBatchSize) {
+      size_t offset = done % kPoolSize;
+      sum += evaluate(pool.subspan(offset, kBatchSize), p);
+    }
+    prevent_optimization = sum;
+    elapsed[p] = std::chrono::high_resolution_clock::now() - start;
+  }
+  return elapsed;
+}
+
+void WriteRow(
+    const std::string &label,
+    const std::array<std::chrono::duration<double>, kNumPhases> &elapsed
+) {
+  std::chrono::duration<double> total{0};
+  std::cout << "| " << label << " |";
+  for (const auto &phase_time : elapsed) {
+    std::cout << " " << phase_time.count() << " |";
+    total += phase_time;
+  }
+  std::cout << " " << total.count() << " |\n";
+}
+
+} // namespace
+
+std::string StrategyName(Strategy strategy) {
+  switch (strategy) {
+  case Strategy::kVirtual:
+    return "virtual";
+  case Strategy::kGuarded:
+    return "guarded";
+  case Strategy::kSortedBatch:
+    return "sorted batch";
+  }
+  return "unknown";
+}
+
+double EvaluateVirtual(std::span<const DispatchItem> items) {
+  double sum = 0.0;
+  for (const auto &item : items) {
+    sum += item.object->Compute(item.x);
+  }
+  return sum;
+}
+
+void RunAdaptiveDispatchBenchmark(size_t iterations) {
+  static_assert(kPoolSize % kBatchSize == 0);
+  auto population = BuildPopulation();
+  size_t calls_per_phase =
+      std::max(iterations / kNumPhases / kBatchSize, size_t{1}) * kBatchSize;
+
+  std::cout << "Calls per Phase: " << calls_per_phase << "\n\n";
+  std::cout << "| Strategy |";
+  for (const auto &phase : kPhases) {
+    std::cout << " " << phase.name << " (s) |";
+  }
+  std::cout << " Total (s) |\n|----------|";
+  for (size_t p = 0; p < kNumPhases; ++p) {
+    std::cout << "------|";
+  }
+  std::cout << "------|\n";
+
+  WriteRow(
+      "virtual",
+      TimePhases(population, calls_per_phase, [](auto items, size_t) {
+        return EvaluateVirtual(items);
+      })
+  );
+  WriteRow(
+      "guarded (fma)",
+      TimePhases(population, calls_per_phase, [](auto items, size_t) {
+        return EvaluateGuarded<PolyFMA>(items);
+      })
+  );
+  WriteRow(
+      "guarded (expensive)",
+      TimePhases(population, calls_per_phase, [](auto items, size_t) {
+        return EvaluateGuarded<PolyExpensive>(items);
+      })
+  );
+
+  SortedBatcher<PolyFMA, PolyExpensive> batcher;
+  WriteRow(
+      "sorted batch",
+      TimePhases(population, calls_per_phase, [&](auto items, size_t) {
+        return batcher.Evaluate(items);
+      })
+  );
+
+  // The same dispatcher instance sees all phases, so it has to notice each
+  // shift in the type mix
+  AdaptiveDispatcher<PolyFMA, PolyExpensive> dispatcher;
+  // Only recorded while timing; named after the timer stops
+  std::array<std::pair<Strategy, size_t>, kNumPhases> chosen;
+  WriteRow(
+      "adaptive",
+      TimePhases(population, calls_per_phase, [&](auto items, size_t p) {
+        double sum = dispatcher.Evaluate(items);
+        chosen[p] = {dispatcher.strategy(), dispatcher.dominant_index()};
+        return sum;
+      })
+  );
+
+  std::cout << "\nAdaptive strategy at end of each phase:";
+  for (size_t p = 0; p < kNumPhases; ++p) {
+    auto [strategy, dominant] = chosen[p];
+    std::cout << " " << kPhases[p].name << " -> " << StrategyName(strategy);
+    if (strategy == Strategy::kGuarded) {
+      std::cout << (dominant == 0 ? " (fma)" : " (expensive)");
+    }
+    std::cout << ";";
+  }
+  std::cout << " switches: " << dispatcher.num_switches() << "\n" << std::endl;
+}
+
+} // namespace adaptive_dispatch
@@ -0,0 +1,79 @@
+#include "allocation_counter.hpp"
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Thread-local and trivially initialized, so they are safe to touch from
+// operator new at any point of the thread's life
+thread_local bool counting = false;
+thread_local uint64_t allocations = 0;
+thread_local uint64_t bytes_requested = 0;
+
+void Count(size_t size) {
+  if (counting) {
+    ++allocations;
+    bytes_requested += size;
+  }
+}
+
+void *CountedAlloc(size_t size) {
+  Count(size);
+  if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void *CountedAlignedAlloc(size_t size, std::align_val_t alignment) {
+  Count(size);
+  auto align = static_cast<size_t>(alignment);
+  // aligned_alloc needs a size that is a multiple of the alignment
+  size_t rounded = (size + align - 1) / align * align;
+  if (void *ptr = std::aligned_alloc(align, rounded == 0 ? align : rounded)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+} // namespace
+
+ScopedAllocationCounting::ScopedAllocationCounting()
+    : was_counting_(counting) {
+  counting = true;
+}
+
+ScopedAllocationCounting::~ScopedAllocationCounting() {
+  counting = was_counting_;
+}
+
+AllocationCounters GetAllocationCounters() {
+  return {allocations, bytes_requested};
+}
+
+// Replacement global allocation functions. The nothrow overloads from the
+// standard library forward to these.
+
+void *operator new(size_t size) { return CountedAlloc(size); }
+void *operator new[](size_t size) { return CountedAlloc(size); }
+void *operator new(size_t size, std::align_val_t alignment) {
+  return CountedAlignedAlloc(size, alignment);
+}
+void *operator new[](size_t size, std::align_val_t alignment) {
+  return CountedAlignedAlloc(size, alignment);
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
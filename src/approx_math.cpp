@@ -0,0 +1,93 @@
+#include "approx_math.hpp"
+#include "math_functions.hpp"
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+
+namespace {
+
+double LibmSin(double x) { return std::sin(x); }
+double LibmLog(double x) { return std::log(x); }
+double LibmSqrt(double x) { return std::sqrt(x); }
+
+struct ReportedFunction {
+  const char *name;
+  double (*reference)(double);
+  double low;
+  double high;
+};
+
+template <Accuracy A>
+void WriteAccuracyRows(std::ostream &out) {
+  constexpr size_t kNumSamples = 1'000'000;
+  const std::pair<ReportedFunction, double (*)(double)> rows[] = {
+      {{"sin", LibmSin, -100.0, 100.0}, ApproxSin<A>},
+      {{"log", LibmLog, 1e-3, 1e3}, ApproxLog<A>},
+      {{"sqrt", LibmSqrt, 0.0, 1e3}, ApproxSqrt<A>},
+      {{"expensive", ComputeExpensive, 0.0, 100.0}, ComputeExpensiveApprox<A>},
+  };
+
+  for (const auto &[function, approximation] : rows) {
+    auto stats = MeasureAccuracy(
+        approximation,
+        function.reference,
+        function.low,
+        function.high,
+        kNumSamples
+    );
+    out << "| " << AccuracyName(A) << " | " << function.name << " | ["
+        << function.low << ", " << function.high << "] | " << stats.max_error
+        << " | " << stats.mean_error << " | " << stats.worst_input << " |\n";
+  }
+}
+
+} // namespace
+
+std::string AccuracyName(Accuracy accuracy) {
+  switch (accuracy) {
+  case Accuracy::kLow:
+    return "low";
+  case Accuracy::kMedium:
+    return "medium";
+  case Accuracy::kHigh:
+    return "high";
+  }
+  return "unknown";
+}
+
+AccuracyStats MeasureAccuracy(
+    double (*approximation)(double),
+    double (*reference)(double),
+    double low,
+    double high,
+    size_t num_samples
+) {
+  AccuracyStats stats{0.0, 0.0, low};
+  double error_sum = 0.0;
+  for (size_t i = 0; i < num_samples; ++i) {
+    double x = low + (high - low) * static_cast<double>(i) /
+                         static_cast<double>(num_samples - 1);
+    double expected = reference(x);
+    double error = std::abs(approximation(x) - expected) /
+                   std::max(std::abs(expected), 1.0);
+    error_sum += error;
+    if (error > stats.max_error) {
+      stats.max_error = error;
+      stats.worst_input = x;
+    }
+  }
+  stats.mean_error = error_sum / static_cast<double>(num_samples);
+  return stats;
+}
+
+void PrintAccuracyReport(std::ostream &out) {
+  out << "Approximation error vs libm (relative where |libm| >= 1, absolute "
+         "below)\n\n";
+  out << "| Accuracy | Function | Range | Max Error | Mean Error | Worst x |\n";
+  out << "|----------|----------|-------|-----------|------------|---------|\n";
+  out << std::setprecision(3);
+  WriteAccuracyRows<Accuracy::kLow>(out);
+  WriteAccuracyRows<Accuracy::kMedium>(out);
+  WriteAccuracyRows<Accuracy::kHigh>(out);
+  out << std::endl;
+}
@@ -0,0 +1,438 @@
+#include "benchmark_server.hpp"
+#include "cold_start.hpp"
+#include "footprint.hpp"
+#include "result_cache.hpp"
+#include "stream_buffers.hpp"
+#include "test_runner.hpp"
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+// Use the macro defined in CMakeLists.txt
+#ifndef COMPILER_FLAGS
+#define COMPILER_FLAGS "Unknown"
+#endif
+
+namespace benchmark_server {
+
+namespace {
+
+void WriteJsonString(std::ostream &out, const std::string &text) {
+  out << '"';
+  for (char c : text) {
+    switch (c) {
+    case '"':
+      out << "\\\"";
+      break;
+    case '\\':
+      out << "\\\\";
+      break;
+    case '\n':
+      out << "\\n";
+      break;
+    default:
+      out << c;
+    }
+  }
+  out << '"';
+}
+
+void WriteCounters(std::ostream &out, const PerfCounters &counters) {
+  out << "\"counters\":{";
+  bool first = true;
+  for (const auto &reading : counters.Read()) {
+    out << (first ? "" : ",");
+    WriteJsonString(out, reading.name);
+    out << ":" << reading.value;
+    first = false;
+  }
+  out << "}";
+}
+
+// Prepends the id (and a "cached" marker) to a result object without one
+std::string WithId(
+    const std::string &id,
+    const std::string &result,
+    bool cached
+) {
+  std::ostringstream out;
+  out << "{\"id\":";
+  WriteJsonString(out, id);
+  if (cached) {
+    out << ",\"cached\":true";
+  }
+  out << "," << result.substr(1);
+  return out.str();
+}
+
+bool IsSkippedLine(const std::string &line) {
+  auto first = line.find_first_not_of(" \t\r");
+  return first == std::string::npos || line[first] == '#';
+}
+
+// The id of a job line that failed to parse, if it has one
+std::string ExtractId(const std::string &line) {
+  std::istringstream iss(line);
+  std::string field;
+  while (iss >> field) {
+    if (field.rfind("id=", 0) == 0) {
+      return field.substr(3);
+    }
+  }
+  return "";
+}
+
+bool IsQuitLine(const std::string &line) {
+  std::istringstream iss(line);
+  std::string word;
+  iss >> word;
+  return word == "quit";
+}
+
+// Writes all of text, retrying partial writes. Returns false if the peer
+// went away.
+bool WriteAll(int fd, const std::string &text) {
+  size_t written = 0;
+  while (written < text.size()) {
+    ssize_t result = write(fd, text.data() + written, text.size() - written);
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result <= 0) {
+      return false;
+    }
+    written += static_cast<size_t>(result);
+  }
+  return true;
+}
+
+// Pushes complete lines from fd into the queue until end of input or "quit"
+void ReadLines(int fd, JobQueue &queue) {
+  std::string pending;
+  char buffer[4096];
+  bool quit = false;
+  while (!quit) {
+    ssize_t count = read(fd, buffer, sizeof(buffer));
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      break;
+    }
+    pending.append(buffer, static_cast<size_t>(count));
+
+    size_t newline;
+    while (!quit && (newline = pending.find('\n')) != std::string::npos) {
+      std::string line = pending.substr(0, newline);
+      pending.erase(0, newline + 1);
+      quit = IsQuitLine(line);
+      queue.Push(std::move(line));
+    }
+  }
+  if (!quit && !pending.empty()) {
+    queue.Push(std::move(pending));
+  }
+  queue.Close();
+}
+
+} // namespace
+
+JobSpec ParseJobSpec(const std::string &line, size_t default_iterations) {
+  JobSpec job;
+  job.iterations = default_iterations;
+
+  std::istringstream iss(line);
+  std::string field;
+  while (iss >> field) {
+    auto equals = field.find('=');
+    if (equals == std::string::npos) {
+      throw std::invalid_argument("Expected key=value, got '" + field + "'");
+    }
+    std::string key = field.substr(0, equals);
+    std::string value = field.substr(equals + 1);
+
+    if (key == "id") {
+      job.id = value;
+    } else if (key == "mode") {
+      job.mode = value;
+    } else if (key == "category") {
+      job.category = value;
+    } else if (key == "computation" || key == "kernel") {
+      job.computation = value;
+    } else if (key == "scenario") {
+      job.scenario = value;
+    } else if (key == "iterations") {
+      std::istringstream value_stream(value);
+      size_t iterations;
+      if (!(value_stream >> iterations) || iterations == 0 ||
+          !value_stream.eof()) {
+        throw std::invalid_argument("Invalid iterations '" + value + "'");
+      }
+      job.iterations = iterations;
+    } else if (key == "run") {
+      std::istringstream value_stream(value);
+      size_t run;
+      if (!(value_stream >> run) || run == 0 || !value_stream.eof()) {
+        throw std::invalid_argument("Invalid run '" + value + "'");
+      }
+      job.run = run;
+    } else {
+      throw std::invalid_argument("Unknown key '" + key + "'");
+    }
+  }
+
+  if (job.mode == "run") {
+    // Throws for unknown categories or computations
+    test_runner::GetSingleTestCase(job.category, job.computation);
+  } else if (job.mode == "scenario") {
+    const auto &scenario_map = test_runner::GetScenarioMap();
+    if (scenario_map.find(job.scenario) == scenario_map.end()) {
+      throw std::invalid_argument("Invalid scenario: " + job.scenario);
+    }
+  } else {
+    throw std::invalid_argument("Invalid mode: " + job.mode);
+  }
+  return job;
+}
+
+std::string JobCacheKey(const JobSpec &job) {
+  const StreamOptions &stream = GetStreamOptions();
+  const cold_start::ColdStartOptions &cold =
+      cold_start::GetColdStartOptions();
+  std::ostringstream out;
+  out << "mode=" << job.mode;
+  if (job.mode == "scenario") {
+    out << " scenario=" << job.scenario;
+  } else {
+    out << " category=" << job.category << " computation=" << job.computation;
+  }
+  out << " iterations=" << job.iterations << " run=" << job.run
+      << " stream-length=" << stream.length
+      << " huge-pages=" << HugePageModeName(stream.huge_pages)
+      << " prefetch=" << stream.prefetch_distance
+      << " population=" << footprint::GetFootprintOptions().population
+      << " cold-samples=" << cold.samples << " cold-batch=" << cold.batch
+      << " evict-bytes=" << cold.evict_bytes;
+  return out.str();
+}
+
+std::string RunJob(const JobSpec &job, PerfCounters &counters) {
+  const auto &cache_options = result_cache::GetResultCacheOptions();
+  std::optional<result_cache::ResultCache> cache;
+  std::string cache_key;
+  if (!cache_options.dir.empty()) {
+    cache.emplace(cache_options.dir, cache_options.max_age_seconds);
+    cache_key =
+        result_cache::MakeKey(result_cache::GetIdentity(), JobCacheKey(job));
+    if (auto cached = cache->Lookup(cache_key)) {
+      return WithId(job.id, *cached, true);
+    }
+  }
+
+  std::chrono::duration<double> elapsed_time{};
+  try {
+    // The counters cover RunTestCase's timed region only, like the reported
+    // time: not the test case's prepare step or the profile output
+    const TestCase &test_case =
+        job.mode == "scenario"
+            ? test_runner::GetScenarioTestCase(job.scenario)
+            : test_runner::GetSingleTestCase(job.category, job.computation);
+    elapsed_time = RunTestCase(test_case, job.iterations, &counters);
+  } catch (const std::exception &e) {
+    counters.Stop();
+    return ErrorResult(job.id, e.what());
+  }
+  std::cout << std::flush;
+
+  // Everything but the id, which is what the cache stores
+  std::ostringstream out;
+  out << "{\"status\":\"ok\",\"mode\":";
+  WriteJsonString(out, job.mode);
+  if (job.mode == "scenario") {
+    out << ",\"scenario\":";
+    WriteJsonString(out, job.scenario);
+  } else {
+    out << ",\"category\":";
+    WriteJsonString(out, job.category);
+    out << ",\"computation\":";
+    WriteJsonString(out, job.computation);
+  }
+  out << ",\"iterations\":" << job.iterations
+      << ",\"seconds\":" << elapsed_time.count() << ",\"ns_per_iteration\":"
+      << elapsed_time.count() * 1e9 / static_cast<double>(job.iterations)
+      << ",";
+  WriteCounters(out, counters);
+  out << "}";
+
+  std::string result = out.str();
+  if (cache) {
+    cache->Store(cache_key, result);
+  }
+  return WithId(job.id, result, false);
+}
+
+std::string ErrorResult(const std::string &id, const std::string &error) {
+  std::ostringstream out;
+  out << "{\"id\":";
+  WriteJsonString(out, id);
+  out << ",\"status\":\"error\",\"error\":";
+  WriteJsonString(out, error);
+  out << "}";
+  return out.str();
+}
+
+std::string ReadyMessage(const PerfCounters &counters) {
+  std::ostringstream out;
+  const result_cache::Identity &identity = result_cache::GetIdentity();
+  out << "{\"status\":\"ready\",\"compiler_flags\":";
+  WriteJsonString(out, COMPILER_FLAGS);
+  out << ",\"binary_hash\":";
+  WriteJsonString(out, identity.binary_hash);
+  out << ",\"cpu_model\":";
+  WriteJsonString(out, identity.cpu_model);
+  out << ",\"counters\":[";
+  bool first = true;
+  for (const auto &reading : counters.Read()) {
+    out << (first ? "" : ",");
+    WriteJsonString(out, reading.name);
+    first = false;
+  }
+  out << "]}";
+  return out.str();
+}
+
+void JobQueue::Push(std::string line) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lines_.push_back(std::move(line));
+  }
+  ready_.notify_one();
+}
+
+std::optional<std::string> JobQueue::Pop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  ready_.wait(lock, [this] { return closed_ || !lines_.empty(); });
+  if (lines_.empty()) {
+    return std::nullopt;
+  }
+  std::string line = std::move(lines_.front());
+  lines_.pop_front();
+  return line;
+}
+
+void JobQueue::Close() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+  }
+  ready_.notify_all();
+}
+
+bool ServeSession(int input_fd, int output_fd, size_t default_iterations) {
+  // Counters follow the thread that opens them and the threads it starts
+  // afterwards (scenario workers), so they are opened on the job thread
+  PerfCounters counters;
+  if (!WriteAll(output_fd, ReadyMessage(counters) + "\n")) {
+    return false;
+  }
+
+  JobQueue queue;
+  std::thread reader(ReadLines, input_fd, std::ref(queue));
+
+  bool quit = false;
+  bool connected = true;
+  while (auto line = queue.Pop()) {
+    if (IsSkippedLine(*line)) {
+      continue;
+    }
+    if (IsQuitLine(*line)) {
+      quit = true;
+      break;
+    }
+
+    std::string result;
+    try {
+      JobSpec job = ParseJobSpec(*line, default_iterations);
+      result = RunJob(job, counters);
+    } catch (const std::exception &e) {
+      result = ErrorResult(ExtractId(*line), e.what());
+    }
+    if (connected && !WriteAll(output_fd, result + "\n")) {
+      connected = false; // keep draining so the reader can finish
+    }
+  }
+
+  reader.join();
+  return quit;
+}
+
+int RunServerOnStdin(size_t default_iterations) {
+  std::cout << std::flush;
+  int results_fd = dup(STDOUT_FILENO);
+  if (results_fd < 0 || dup2(STDERR_FILENO, STDOUT_FILENO) < 0) {
+    std::cerr << "Error: Unable to redirect stdout: " << std::strerror(errno)
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  ServeSession(STDIN_FILENO, results_fd, default_iterations);
+  close(results_fd);
+  return EXIT_SUCCESS;
+}
+
+int RunServerOnSocket(const std::string &path, size_t default_iterations) {
+  sockaddr_un address{};
+  if (path.size() >= sizeof(address.sun_path)) {
+    std::cerr << "Error: Socket path too long: " << path << std::endl;
+    return EXIT_FAILURE;
+  }
+  address.sun_family = AF_UNIX;
+  std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+  int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  unlink(path.c_str());
+  if (listener < 0 ||
+      bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) <
+          0 ||
+      listen(listener, 1) < 0) {
+    std::cerr << "Error: Unable to listen on " << path << ": "
+              << std::strerror(errno) << std::endl;
+    if (listener >= 0) {
+      close(listener);
+    }
+    return EXIT_FAILURE;
+  }
+
+  // A client disconnecting mid-write must not kill the server
+  std::signal(SIGPIPE, SIG_IGN);
+  std::cerr << "Listening on " << path << std::endl;
+
+  bool quit = false;
+  while (!quit) {
+    int connection = accept(listener, nullptr, nullptr);
+    if (connection < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      std::cerr << "Error: accept failed: " << std::strerror(errno)
+                << std::endl;
+      break;
+    }
+    quit = ServeSession(connection, connection, default_iterations);
+    close(connection);
+  }
+
+  close(listener);
+  unlink(path.c_str());
+  return quit ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // namespace benchmark_server
@@ -1,4 +1,5 @@
 #include "benchmark_utils.hpp"
+#include "perf_counters.hpp"
 #include <filesystem>
 #include <iomanip>
 #include <sstream>
@@ -8,6 +9,11 @@
 // Prevent compiler optimizations by using a volatile variable
 volatile double prevent_optimization = 0.0;
 
+BenchmarkSink &GetThreadBenchmarkSink() {
+  thread_local BenchmarkSink sink;
+  return sink;
+}
+
 void PrintTime(
     const std::string &label,
     std::chrono::duration<double> elapsed
@@ -18,15 +24,27 @@ void PrintTime(
 
 std::chrono::duration<double> RunTestCase(
     const TestCase &test_case,
-    size_t iterations
+    size_t iterations,
+    PerfCounters *counters
 ) {
+  TRACE_SCOPE(trace::Intern(test_case.name));
   std::cout << "Running: " << test_case.name << std::endl;
   std::cout << "Iteration Count: " << iterations << std::endl;
   std::cout << "Compiler Flags: " << COMPILER_FLAGS << std::endl;
 
+  if (test_case.prepare != nullptr) {
+    test_case.prepare();
+  }
+  if (counters != nullptr) {
+    counters->Start();
+  }
   auto start = std::chrono::high_resolution_clock::now();
   test_case.function(iterations);
   auto end = std::chrono::high_resolution_clock::now();
+  if (counters != nullptr) {
+    counters->Stop();
+  }
+  sampling_profiler::FlushProfiles();
 
   std::chrono::duration<double> elapsed_time = end - start;
   return elapsed_time;
@@ -71,6 +89,7 @@ void WriteNumberOfIterations(size_t num_iterations, std::ofstream &outfile) {
 }
 
 void WriteMarkdownTableHeader(std::ofstream &outfile) {
+  TRACE_SCOPE("WriteMarkdownTableHeader");
   outfile << "| Polymorphism Type | Compute Function | Time (seconds) |\n";
   outfile << "|-------------------|-----------------|---------------|\n";
 }
@@ -81,6 +100,7 @@ void WriteMarkdownTableRow(
     const std::string &computation_label,
     std::chrono::duration<double> elapsed_time
 ) {
+  TRACE_SCOPE("WriteMarkdownTableRow");
   outfile << "| " << polymorphism_category << " | " << computation_label
           << " | " << elapsed_time.count() << " |\n";
 }
@@ -92,6 +112,7 @@ void WriteSingleTestResultToFile(
     const std::string &computation_label,
     std::chrono::duration<double> elapsed_time
 ) {
+  TRACE_SCOPE("WriteSingleTestResultToFile");
   auto filepath = GenerateTimestampBasedFile(output_dir);
   std::ofstream outfile(filepath);
   ValidateOutfileStream(outfile, filepath);
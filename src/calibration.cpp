@@ -0,0 +1,324 @@
+#include "calibration.hpp"
+#include "benchmark_utils.hpp"
+#include "math_functions.hpp"
+#include "perf_counters.hpp"
+#include "test_runner.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+namespace calibration {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Adds (or empty-kernel calls) per clock measurement
+constexpr size_t kClockAdds = 100'000'000;
+
+// ns per call of kRepetitions runs of `run`, which makes `calls` calls, with
+// RunBenchmark's own printing turned off. The baselines and the test cases
+// all get an opaque argument: RunBenchmark's constant would otherwise let
+// every inlined kernel, direct or through CRTP/Concepts, fold to nothing.
+template <typename Run>
+Estimate MeasureRuns(size_t calls, Run &&run) {
+  if (calls == 0) {
+    throw std::invalid_argument("Calibration needs at least one call");
+  }
+  BenchmarkSink &sink = GetThreadBenchmarkSink();
+  BenchmarkSink saved = sink;
+  sink.print_time = false;
+  sink.opaque_argument = true;
+  std::vector<double> samples;
+  for (int repetition = 0; repetition < kRepetitions; ++repetition) {
+    auto start = Clock::now();
+    run();
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    samples.push_back(elapsed.count() / static_cast<double>(calls));
+  }
+  sink = saved;
+  return FromSamples(samples);
+}
+
+template <typename Kernel>
+Estimate MeasureKernel(const std::string &label, size_t calls, Kernel kernel) {
+  return MeasureRuns(calls, [&] { RunBenchmark(label, calls, kernel); });
+}
+
+// cycles / ns over the empty-kernel harness, if the cycles counter opens
+std::optional<Estimate> MeasureCyclesPerNsWithCounters() {
+  PerfCounters counters;
+  if (!counters.available()) {
+    return std::nullopt;
+  }
+  BenchmarkSink &sink = GetThreadBenchmarkSink();
+  bool print_time = sink.print_time;
+  sink.print_time = false;
+  std::vector<double> samples;
+  for (int repetition = 0; repetition < kRepetitions; ++repetition) {
+    counters.Start();
+    auto start = Clock::now();
+    RunBenchmark("Clock", kClockAdds, [](double x) { return x; });
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    counters.Stop();
+
+    auto readings = counters.Read();
+    auto cycles = std::find_if(
+        readings.begin(),
+        readings.end(),
+        [](const CounterReading &reading) { return reading.name == "cycles"; }
+    );
+    if (cycles == readings.end() || cycles->value == 0) {
+      break;
+    }
+    samples.push_back(static_cast<double>(cycles->value) / elapsed.count());
+  }
+  sink.print_time = print_time;
+  if (samples.size() < static_cast<size_t>(kRepetitions)) {
+    return std::nullopt;
+  }
+  return FromSamples(samples);
+}
+
+// Register-to-register adds, one cycle of latency each, 8 per iteration so
+// the loop counter runs alongside. (Chains of add-immediate can't be used:
+// some cores fold those at rename, faster than one per cycle.)
+std::optional<Estimate> MeasureCyclesPerNsWithAddChain() {
+#if defined(__GNUC__) && defined(__x86_64__)
+  constexpr size_t kTrips = kClockAdds / 8;
+  std::vector<double> samples;
+  for (int repetition = 0; repetition < kRepetitions; ++repetition) {
+    uint64_t value = 1;
+    auto start = Clock::now();
+    for (size_t i = 0; i < kTrips; ++i) {
+      asm volatile("add %0, %0\n\t"
+                   "add %0, %0\n\t"
+                   "add %0, %0\n\t"
+                   "add %0, %0\n\t"
+                   "add %0, %0\n\t"
+                   "add %0, %0\n\t"
+                   "add %0, %0\n\t"
+                   "add %0, %0"
+                   : "+r"(value));
+    }
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    samples.push_back(static_cast<double>(kTrips * 8) / elapsed.count());
+  }
+  return FromSamples(samples);
+#else
+  return std::nullopt;
+#endif
+}
+
+void WriteEstimate(std::ostream &out, const Estimate &estimate) {
+  out << std::fixed << std::setprecision(2) << estimate.value << " ± "
+      << estimate.uncertainty;
+  out.unsetf(std::ios::fixed);
+}
+
+void WriteOptionalEstimate(
+    std::ostream &out,
+    const std::optional<Estimate> &estimate
+) {
+  if (estimate) {
+    WriteEstimate(out, *estimate);
+  } else {
+    out << "n/a";
+  }
+}
+
+} // namespace
+
+Estimate FromSamples(const std::vector<double> &samples) {
+  if (samples.empty()) {
+    return {};
+  }
+  double n = static_cast<double>(samples.size());
+  double mean = 0.0;
+  for (double sample : samples) {
+    mean += sample;
+  }
+  mean /= n;
+  if (samples.size() < 2) {
+    return {mean, 0.0};
+  }
+  double squares = 0.0;
+  for (double sample : samples) {
+    squares += (sample - mean) * (sample - mean);
+  }
+  double stddev = std::sqrt(squares / (n - 1));
+  return {mean, stddev / std::sqrt(n)};
+}
+
+Estimate Difference(const Estimate &a, const Estimate &b) {
+  return {a.value - b.value, std::hypot(a.uncertainty, b.uncertainty)};
+}
+
+Estimate Product(const Estimate &a, const Estimate &b) {
+  // Absolute form of the relative-error sum, so zero values are fine
+  return {
+      a.value * b.value,
+      std::hypot(a.uncertainty * b.value, b.uncertainty * a.value),
+  };
+}
+
+const std::vector<std::string> &CalibratedComputations() {
+  static const std::vector<std::string> computations = {
+      "fma",
+      "expensive",
+      "approx_low",
+      "approx_medium",
+      "approx_high",
+  };
+  return computations;
+}
+
+Estimate MeasureEmptyKernel(size_t calls) {
+  return MeasureKernel("Empty Kernel", calls, [](double x) { return x; });
+}
+
+Estimate MeasureInlineKernel(const std::string &computation, size_t calls) {
+  if (computation == "fma") {
+    return MeasureKernel("Inline FMA", calls, [](double x) {
+      return ComputeFMA(x);
+    });
+  }
+  if (computation == "expensive") {
+    return MeasureKernel("Inline Expensive", calls, [](double x) {
+      return ComputeExpensive(x);
+    });
+  }
+  if (computation == "approx_low") {
+    return MeasureKernel("Inline Approx (low)", calls, [](double x) {
+      return ComputeExpensiveApprox<Accuracy::kLow>(x);
+    });
+  }
+  if (computation == "approx_medium") {
+    return MeasureKernel("Inline Approx (medium)", calls, [](double x) {
+      return ComputeExpensiveApprox<Accuracy::kMedium>(x);
+    });
+  }
+  if (computation == "approx_high") {
+    return MeasureKernel("Inline Approx (high)", calls, [](double x) {
+      return ComputeExpensiveApprox<Accuracy::kHigh>(x);
+    });
+  }
+  throw std::invalid_argument("No inline baseline for: " + computation);
+}
+
+std::optional<Estimate> MeasureCyclesPerNs(std::string *source) {
+  if (auto cycles_per_ns = MeasureCyclesPerNsWithCounters()) {
+    *source = "cycles counter";
+    return cycles_per_ns;
+  }
+  if (auto cycles_per_ns = MeasureCyclesPerNsWithAddChain()) {
+    *source = "dependent add chain";
+    return cycles_per_ns;
+  }
+  *source = "unavailable";
+  return std::nullopt;
+}
+
+Calibration Calibrate(size_t calls) {
+  TRACE_SCOPE("Calibrate");
+  Calibration calibration;
+  calibration.calls = calls;
+  calibration.empty_ns = MeasureEmptyKernel(calls);
+  for (const auto &computation : CalibratedComputations()) {
+    calibration.inline_ns[computation] =
+        MeasureInlineKernel(computation, calls);
+  }
+  calibration.cycles_per_ns = MeasureCyclesPerNs(&calibration.clock_source);
+  return calibration;
+}
+
+NetCost MeasureNetCost(
+    const Calibration &calibration,
+    const std::string &category,
+    const std::string &computation
+) {
+  TRACE_SCOPE("MeasureNetCost");
+  auto baseline = calibration.inline_ns.find(computation);
+  if (baseline == calibration.inline_ns.end()) {
+    throw std::invalid_argument("No inline baseline for: " + computation);
+  }
+  const TestCase &test_case =
+      test_runner::GetSingleTestCase(category, computation);
+
+  NetCost cost;
+  cost.category = category;
+  cost.computation = computation;
+  cost.raw_ns = MeasureRuns(calibration.calls, [&] {
+    test_case.function(calibration.calls);
+  });
+  cost.net_ns = Difference(cost.raw_ns, calibration.empty_ns);
+  cost.dispatch_ns = Difference(cost.raw_ns, baseline->second);
+  if (calibration.cycles_per_ns) {
+    cost.net_cycles = Product(cost.net_ns, *calibration.cycles_per_ns);
+    cost.dispatch_cycles =
+        Product(cost.dispatch_ns, *calibration.cycles_per_ns);
+  }
+  return cost;
+}
+
+void WriteNetCostTable(
+    std::ostream &out,
+    const Calibration &calibration,
+    const std::vector<NetCost> &results
+) {
+  out << "Harness baselines (ns/call, mean ± standard error of "
+      << kRepetitions << " runs of " << calibration.calls << " calls):\n\n";
+  out << "- Empty kernel: ";
+  WriteEstimate(out, calibration.empty_ns);
+  out << "\n";
+  for (const auto &[computation, estimate] : calibration.inline_ns) {
+    out << "- Inline " << computation << ": ";
+    WriteEstimate(out, estimate);
+    out << "\n";
+  }
+  out << "- Clock (cycles/ns, " << calibration.clock_source << "): ";
+  WriteOptionalEstimate(out, calibration.cycles_per_ns);
+  out << "\n\n";
+
+  out << "| Category | Computation | Raw (ns/call) | Net (ns/call) | Net "
+         "(cycles/call) | Dispatch vs Inline (ns/call) | Dispatch vs Inline "
+         "(cycles/call) |\n";
+  out << "|----------|-------------|------|------|------|------|------|\n";
+  for (const auto &result : results) {
+    out << "| " << result.category << " | " << result.computation << " | ";
+    WriteEstimate(out, result.raw_ns);
+    out << " | ";
+    WriteEstimate(out, result.net_ns);
+    out << " | ";
+    WriteOptionalEstimate(out, result.net_cycles);
+    out << " | ";
+    WriteEstimate(out, result.dispatch_ns);
+    out << " | ";
+    WriteOptionalEstimate(out, result.dispatch_cycles);
+    out << " |\n";
+  }
+}
+
+void RunCalibrationBenchmark(size_t iterations) {
+  size_t calls = std::max(iterations / kRepetitions, size_t{1});
+  std::cout << "Calls per run: " << calls << " (" << kRepetitions
+            << " runs per estimate)\n\n";
+
+  Calibration calibration = Calibrate(calls);
+  std::vector<NetCost> results;
+  for (const auto &category : {"runtime", "crtp", "concepts"}) {
+    for (const auto &computation : CalibratedComputations()) {
+      results.push_back(MeasureNetCost(calibration, category, computation));
+    }
+  }
+  WriteNetCostTable(std::cout, calibration, results);
+  std::cout << "\nNet subtracts the empty-kernel harness (loop, accumulation "
+               "and timer). Dispatch vs Inline subtracts the same kernel "
+               "called directly, leaving the cost of the polymorphism.\n"
+            << std::endl;
+}
+
+} // namespace calibration
@@ -1,7 +1,19 @@
 #include "cli_utils.hpp"
+#include "approx_math.hpp"
+#include "benchmark_server.hpp"
+#include "cold_start.hpp"
+#include "footprint.hpp"
+#include "result_cache.hpp"
+#include "sampling_profiler.hpp"
+#include "stream_buffers.hpp"
 #include "test_runner.hpp"
+#include "thread_scaling.hpp"
+#include "trace.hpp"
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
+#include <limits>
+#include <sstream>
 #include <string_view>
 
 // Default number of iterations
@@ -11,13 +23,20 @@ constexpr size_t kDefaultNumIterations = 1'000'000'000;
 void PrintUsage(const char *program_name) {
   std::cerr
       << "\nUsage: " << program_name
-      << " [polymorphism_category] [computation] [-n iterations] [-s]\n"
+      << " [polymorphism_category] [computation] [-n iterations] [-s] "
+         "[-t threads]\n"
       << " - No arguments: Runs all tests with the default iteration count.\n"
       << " - With two arguments: Runs a specific test with the default "
          "iteration count.\n"
       << " - With '-n iterations': Runs all tests with a custom iteration "
          "count.\n"
-      << " - With '-s': Saves execution time data.\n\n"
+      << " - With '-s': Saves execution time data.\n"
+      << " - With '-t threads': Runs each test on 1, 2, 4, ... threads at "
+         "once\n"
+      << "   (streaming kernels excluded).\n"
+      << " - With '--scenario name': Runs a self-contained scenario instead.\n"
+      << " - Streaming kernels (triad, dot, stencil, gather) also accept\n"
+      << "   '--huge-pages', '--prefetch' and '--stream-length'.\n\n"
       << "Valid arguments:\n"
       << " ------------------------\n";
 
@@ -40,10 +59,55 @@ void PrintUsage(const char *program_name) {
     }
   }
 
+  // Format valid scenarios
+  std::cerr << "\n Scenarios:\n";
+  std::cerr << " ----------\n";
+  for (const auto &scenario : test_runner::GetScenarioMap()) {
+    std::cerr << "  - " << scenario.first << "\n";
+  }
+
   std::cerr << "\nOther Options:\n"
             << "  --help              Show this help message\n"
             << "  -n [iterations]     Specify a custom iteration count\n"
             << "  -s                  Save execution time data\n"
+            << "  -t [threads]        Scale tests up to this many pinned "
+               "threads\n"
+            << "  --shared-sink       With -t, also run with per-thread sinks "
+               "sharing cache lines\n"
+            << "  --huge-pages [mode] Streaming buffer pages: none, thp "
+               "(default), explicit\n"
+            << "  --prefetch [dist]   Software prefetch distance in elements "
+               "(default 0 = off)\n"
+            << "  --stream-length [n] Elements per streaming array, power of "
+               "two (default "
+            << kDefaultStreamLength << ")\n"
+            << "  --scenario [name]   Run a scenario benchmark (see above)\n"
+            << "  --population [n]    Objects per model for the footprint "
+               "scenario (default "
+            << footprint::kDefaultPopulation << ")\n"
+            << "  --cold-samples [n]  Samples per case for the cold_start "
+               "scenario (default "
+            << cold_start::kDefaultColdSamples << ")\n"
+            << "  --cold-batch [n]    Calls per cold sample (default 1)\n"
+            << "  --evict-mib [n]     Cache eviction buffer size (default "
+               "1.5x LLC)\n"
+            << "  --server            Read job specs from stdin, stream JSON "
+               "results to stdout\n"
+            << "  --server-socket [path] Same, over a Unix domain socket\n"
+            << "  --cache [dir]       With --server, reuse fresh results "
+               "from this result cache\n"
+            << "  --cache-max-age [s] Freshness window in seconds (default "
+            << result_cache::kDefaultMaxAgeSeconds << ")\n"
+            << "  --cache-info        Print the binary hash, compiler flags "
+               "and CPU model results are keyed on\n"
+            << "  --accuracy-report   Print approx kernel error vs libm and "
+               "exit\n"
+            << "  --trace [file]      Write a Chrome/Perfetto trace (requires "
+               "-DENABLE_TRACING=ON)\n"
+            << "  --profile [dir]     Write a pprof profile and top-N report "
+               "per test (requires -DENABLE_PROFILING=ON)\n"
+            << "  --profile-top [n]   Functions in each report (default 10)\n"
+            << "  --profile-hz [n]    Samples per second (default 1000)\n"
             << std::endl;
 }
 
@@ -63,6 +127,245 @@ bool ParseSaveExecutionTimesFlag(int argc, char **argv, int &remaining_argc) {
   return false;
 }
 
+// Parses a boolean flag and removes it from args if present
+bool ParseFlag(char **argv, int &remaining_argc, std::string_view flag) {
+  for (int i = 1; i < remaining_argc; ++i) {
+    if (std::string_view(argv[i]) == flag) {
+      // Shift remaining arguments forward
+      for (int j = i; j < remaining_argc - 1; ++j) {
+        argv[j] = argv[j + 1];
+      }
+      // Reduce argument count
+      remaining_argc -= 1;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Parses a "flag value" pair and removes both from args if present
+std::optional<std::string> ParseFlagValue(
+    char **argv,
+    int &remaining_argc,
+    std::string_view flag
+) {
+  for (int i = 1; i < remaining_argc - 1; ++i) {
+    if (std::string_view(argv[i]) == flag) {
+      std::string value = argv[i + 1];
+
+      // Shift remaining arguments forward
+      for (int j = i; j < remaining_argc - 2; ++j) {
+        argv[j] = argv[j + 2];
+      }
+
+      // Reduce argument count
+      remaining_argc -= 2;
+      return value;
+    }
+  }
+  return std::nullopt;
+}
+
+// Parses a strictly positive (or, if allow_zero, non-negative) integer
+std::optional<size_t> ParseCount(const std::string &text, bool allow_zero) {
+  std::istringstream iss(text);
+  size_t value;
+  if (!(iss >> value) || (value == 0 && !allow_zero) || !iss.eof()) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+// Parses the streaming kernel options into GetStreamOptions()
+bool ParseStreamOptions(char **argv, int &remaining_argc) {
+  auto &options = GetStreamOptions();
+
+  if (auto value = ParseFlagValue(argv, remaining_argc, "--huge-pages")) {
+    auto mode = ParseHugePageMode(*value);
+    if (!mode) {
+      std::cerr << "Error: Invalid huge page mode '" << *value << "'\n";
+      return false;
+    }
+    options.huge_pages = *mode;
+  }
+
+  if (auto value = ParseFlagValue(argv, remaining_argc, "--prefetch")) {
+    auto distance = ParseCount(*value, true);
+    if (!distance) {
+      std::cerr << "Error: Invalid prefetch distance '" << *value << "'\n";
+      return false;
+    }
+    options.prefetch_distance = *distance;
+  }
+
+  if (auto value = ParseFlagValue(argv, remaining_argc, "--stream-length")) {
+    auto length = ParseCount(*value, false);
+    if (!length || !IsPowerOfTwo(*length) ||
+        *length > std::numeric_limits<uint32_t>::max()) {
+      std::cerr << "Error: Stream length must be a power of two below 2^32, "
+                   "got '"
+                << *value << "'\n";
+      return false;
+    }
+    options.length = *length;
+  }
+
+  return true;
+}
+
+// Parses the footprint scenario options into
+// footprint::GetFootprintOptions()
+bool ParseFootprintOptions(char **argv, int &remaining_argc) {
+  if (auto value = ParseFlagValue(argv, remaining_argc, "--population")) {
+    auto population = ParseCount(*value, false);
+    if (!population) {
+      std::cerr << "Error: Invalid population '" << *value << "'\n";
+      return false;
+    }
+    footprint::GetFootprintOptions().population = *population;
+  }
+  return true;
+}
+
+// Parses the cold-start scenario options into
+// cold_start::GetColdStartOptions()
+bool ParseColdStartOptions(char **argv, int &remaining_argc) {
+  auto &options = cold_start::GetColdStartOptions();
+
+  if (auto value = ParseFlagValue(argv, remaining_argc, "--cold-samples")) {
+    auto samples = ParseCount(*value, false);
+    if (!samples) {
+      std::cerr << "Error: Invalid cold sample count '" << *value << "'\n";
+      return false;
+    }
+    options.samples = *samples;
+  }
+
+  if (auto value = ParseFlagValue(argv, remaining_argc, "--cold-batch")) {
+    auto batch = ParseCount(*value, false);
+    if (!batch) {
+      std::cerr << "Error: Invalid cold batch size '" << *value << "'\n";
+      return false;
+    }
+    options.batch = *batch;
+  }
+
+  if (auto value = ParseFlagValue(argv, remaining_argc, "--evict-mib")) {
+    auto mebibytes = ParseCount(*value, false);
+    if (!mebibytes) {
+      std::cerr << "Error: Invalid eviction buffer size '" << *value << "'\n";
+      return false;
+    }
+    options.evict_bytes = *mebibytes << 20;
+  }
+
+  return true;
+}
+
+// Parses the multi-threaded scaling options into GetThreadScalingOptions()
+bool ParseThreadScalingOptions(char **argv, int &remaining_argc) {
+  auto &options = thread_scaling::GetThreadScalingOptions();
+
+  if (auto value = ParseFlagValue(argv, remaining_argc, "-t")) {
+    auto threads = ParseCount(*value, false);
+    if (!threads) {
+      std::cerr << "Error: Invalid thread count '" << *value << "'\n";
+      return false;
+    }
+    options.threads = *threads;
+  }
+
+  options.shared_sink = ParseFlag(argv, remaining_argc, "--shared-sink");
+  if (options.shared_sink && options.threads == 0) {
+    std::cerr << "Error: --shared-sink requires -t\n";
+    return false;
+  }
+
+  return true;
+}
+
+bool ParseProfilerOptions(char **argv, int &remaining_argc) {
+  auto &options = sampling_profiler::GetProfilerOptions();
+
+  if (auto value = ParseFlagValue(argv, remaining_argc, "--profile")) {
+    options.output_dir = *value;
+  }
+
+  std::optional<std::string> top =
+      ParseFlagValue(argv, remaining_argc, "--profile-top");
+  std::optional<std::string> hz =
+      ParseFlagValue(argv, remaining_argc, "--profile-hz");
+  if ((top || hz) && options.output_dir.empty()) {
+    std::cerr << "Error: --profile-top and --profile-hz require --profile\n";
+    return false;
+  }
+  if (top) {
+    auto count = ParseCount(*top, false);
+    if (!count) {
+      std::cerr << "Error: Invalid report length '" << *top << "'\n";
+      return false;
+    }
+    options.top = *count;
+  }
+  if (hz) {
+    auto frequency = ParseCount(*hz, false);
+    if (!frequency || *frequency > 100'000) {
+      std::cerr << "Error: Invalid sampling frequency '" << *hz << "'\n";
+      return false;
+    }
+    options.frequency_hz = static_cast<int>(*frequency);
+  }
+
+#ifndef ENABLE_PROFILING
+  if (!options.output_dir.empty()) {
+    std::cerr << "Warning: the sampling profiler is compiled out, rebuild "
+                 "with -DENABLE_PROFILING=ON to write profiles to "
+              << options.output_dir << std::endl;
+  }
+#endif
+  return true;
+}
+
+// Parses the result cache options into result_cache::GetResultCacheOptions()
+bool ParseResultCacheOptions(char **argv, int &remaining_argc) {
+  auto &options = result_cache::GetResultCacheOptions();
+
+  if (auto value = ParseFlagValue(argv, remaining_argc, "--cache")) {
+    options.dir = *value;
+  }
+
+  if (auto value = ParseFlagValue(argv, remaining_argc, "--cache-max-age")) {
+    if (options.dir.empty()) {
+      std::cerr << "Error: --cache-max-age requires --cache\n";
+      return false;
+    }
+    auto seconds = ParseCount(*value, true);
+    if (!seconds ||
+        *seconds > static_cast<size_t>(std::numeric_limits<int64_t>::max())) {
+      std::cerr << "Error: Invalid cache max age '" << *value << "'\n";
+      return false;
+    }
+    options.max_age_seconds = static_cast<int64_t>(*seconds);
+  }
+  return true;
+}
+
+// Writes the recorded trace events, if tracing was compiled in
+void WriteTraceFile(const std::string &filepath) {
+#ifdef ENABLE_TRACING
+  if (trace::WriteChromeTrace(filepath)) {
+    std::cout << "Trace saved to: " << filepath << std::endl;
+  } else {
+    std::cerr << "Error: Unable to write trace file: " << filepath
+              << std::endl;
+  }
+#else
+  std::cerr << "Warning: tracing is compiled out, rebuild with "
+               "-DENABLE_TRACING=ON to write "
+            << filepath << std::endl;
+#endif
+}
+
 // Checks for the "--help" option and prints usage if needed
 bool HandleHelpOption(int argc, char **argv) {
   if (argc == 2 && std::string_view(argv[1]) == "--help") {
@@ -104,6 +407,11 @@ bool IsValidPolymorphismCategory(const std::string &category) {
   return test_case_map.find(category) != test_case_map.end();
 }
 
+bool IsValidScenario(const std::string &scenario) {
+  const auto &scenario_map = test_runner::GetScenarioMap();
+  return scenario_map.find(scenario) != scenario_map.end();
+}
+
 bool IsValidComputation(
     const std::string &category,
     const std::string &computation
@@ -135,9 +443,31 @@ int RunAppropriateTests(
     size_t iterations,
     bool save_execution_times
 ) {
+  const auto &scaling_options = thread_scaling::GetThreadScalingOptions();
+  if (scaling_options.threads != 0 && save_execution_times) {
+    std::cerr << "Error: -t can't be combined with -s\n";
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
   if (remaining_argc == 1) {
     // No arguments left → Run all tests
-    test_runner::RunAllTests(iterations, save_execution_times);
+    if (scaling_options.threads != 0) {
+      for (const auto &[category, inner_map] : test_runner::GetTestCaseMap()) {
+        for (const auto &[computation, test_case] : inner_map) {
+          if (!thread_scaling::SupportsThreadScaling(test_case)) {
+            continue;
+          }
+          thread_scaling::RunThreadScaling(
+              test_case,
+              iterations,
+              scaling_options
+          );
+        }
+      }
+    } else {
+      test_runner::RunAllTests(iterations, save_execution_times);
+    }
   } else if (remaining_argc == 3) {
     std::string polymorphism_category = argv[1];
     std::string computation = argv[2];
@@ -156,12 +486,23 @@ int RunAppropriateTests(
       return EXIT_FAILURE;
     }
 
-    test_runner::RunSingleTest(
-        polymorphism_category,
-        computation,
-        iterations,
-        save_execution_times
-    );
+    if (scaling_options.threads != 0) {
+      const TestCase &test_case =
+          test_runner::GetSingleTestCase(polymorphism_category, computation);
+      if (!thread_scaling::SupportsThreadScaling(test_case)) {
+        std::cerr << "Error: -t doesn't support the streaming kernel '"
+                  << computation << "'\n";
+        return EXIT_FAILURE;
+      }
+      thread_scaling::RunThreadScaling(test_case, iterations, scaling_options);
+    } else {
+      test_runner::RunSingleTest(
+          polymorphism_category,
+          computation,
+          iterations,
+          save_execution_times
+      );
+    }
   } else {
     // Invalid number of arguments
     PrintUsage(argv[0]);
@@ -171,6 +512,28 @@ int RunAppropriateTests(
   return EXIT_SUCCESS;
 }
 
+// Validates and runs a "--scenario" request
+int RunScenarioFromCLI(
+    const std::string &scenario,
+    int remaining_argc,
+    char **argv,
+    size_t iterations
+) {
+  if (remaining_argc != 1) {
+    std::cerr << "Error: --scenario can't be combined with a category and "
+                 "computation\n";
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  if (!IsValidScenario(scenario)) {
+    std::cerr << "Error: Invalid scenario '" << scenario << "'\n";
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  test_runner::RunScenario(scenario, iterations);
+  return EXIT_SUCCESS;
+}
+
 // Handles command-line arguments and runs the appropriate test(s)
 int RunFromCLI(int argc, char **argv) {
   if (HandleHelpOption(argc, argv)) {
@@ -186,10 +549,98 @@ int RunFromCLI(int argc, char **argv) {
   bool save_execution_times =
       ParseSaveExecutionTimesFlag(argc, argv, remaining_argc);
 
-  return RunAppropriateTests(
-      remaining_argc,
-      argv,
-      iterations,
-      save_execution_times
-  );
+  // Parse options for the memory-bound kernels
+  if (!ParseStreamOptions(argv, remaining_argc)) {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  // Parse options for the footprint scenario
+  if (!ParseFootprintOptions(argv, remaining_argc)) {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  // Parse options for the cold-start scenario
+  if (!ParseColdStartOptions(argv, remaining_argc)) {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  // Parse options for the multi-threaded scaling mode
+  if (!ParseThreadScalingOptions(argv, remaining_argc)) {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  // Parse options for the sampling profiler
+  if (!ParseProfilerOptions(argv, remaining_argc)) {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  // Parse options for the result cache
+  if (!ParseResultCacheOptions(argv, remaining_argc)) {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  // "--cache-info" prints what cached results are keyed on and exits
+  if (ParseFlag(argv, remaining_argc, "--cache-info")) {
+    std::cout << result_cache::IdentityJson(result_cache::GetIdentity())
+              << std::endl;
+    return EXIT_SUCCESS;
+  }
+
+  // "--accuracy-report" replaces the benchmark run
+  if (ParseFlag(argv, remaining_argc, "--accuracy-report")) {
+    PrintAccuracyReport(std::cout);
+    return EXIT_SUCCESS;
+  }
+
+  // "--server" and "--server-socket" keep the process alive and take jobs
+  // instead of running tests from the command line
+  bool serve_stdin = ParseFlag(argv, remaining_argc, "--server");
+  std::optional<std::string> socket_path =
+      ParseFlagValue(argv, remaining_argc, "--server-socket");
+  if (serve_stdin || socket_path) {
+    if (remaining_argc != 1 || (serve_stdin && socket_path)) {
+      std::cerr << "Error: --server and --server-socket only accept options\n";
+      PrintUsage(argv[0]);
+      return EXIT_FAILURE;
+    }
+    return socket_path
+               ? benchmark_server::RunServerOnSocket(*socket_path, iterations)
+               : benchmark_server::RunServerOnStdin(iterations);
+  }
+  if (!result_cache::GetResultCacheOptions().dir.empty()) {
+    std::cerr << "Warning: --cache only applies to --server jobs, measuring "
+                 "from scratch"
+              << std::endl;
+  }
+
+  // Parse the "--trace" option
+  std::optional<std::string> trace_file =
+      ParseFlagValue(argv, remaining_argc, "--trace");
+
+  // "--scenario" replaces the category/computation grid
+  std::optional<std::string> scenario =
+      ParseFlagValue(argv, remaining_argc, "--scenario");
+
+  int status = EXIT_SUCCESS;
+  if (scenario) {
+    status = RunScenarioFromCLI(*scenario, remaining_argc, argv, iterations);
+  } else {
+    status = RunAppropriateTests(
+        remaining_argc,
+        argv,
+        iterations,
+        save_execution_times
+    );
+  }
+
+  if (trace_file) {
+    WriteTraceFile(*trace_file);
+  }
+  return status;
 }
@@ -0,0 +1,402 @@
+#include "cold_start.hpp"
+#include "benchmark_utils.hpp"
+#include "concepts_polymorphism.hpp"
+#include "crtp_polymorphism.hpp"
+#include "runtime_polymorphism.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define COLD_START_HAS_X86 1
+#endif
+
+namespace cold_start {
+
+namespace {
+
+constexpr size_t kCacheLineSize = 64;
+
+// Bytes of code flushed from each function entry point
+constexpr size_t kCodeFlushBytes = 4 * kCacheLineSize;
+
+// ===========================
+// TIMING
+// ===========================
+
+// Serialized timestamp reads: TSC ticks on x86, steady-clock ns elsewhere
+inline uint64_t TimerStart() {
+#ifdef COLD_START_HAS_X86
+  _mm_mfence();
+  _mm_lfence();
+  uint64_t ticks = __rdtsc();
+  _mm_lfence();
+  return ticks;
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()
+  )
+      .count();
+#endif
+}
+
+inline uint64_t TimerEnd() {
+#ifdef COLD_START_HAS_X86
+  unsigned int aux;
+  uint64_t ticks = __rdtscp(&aux);
+  _mm_lfence();
+  return ticks;
+#else
+  return TimerStart();
+#endif
+}
+
+// Timer ticks per nanosecond, calibrated once against the steady clock
+double TicksPerNs() {
+  static const double ticks_per_ns = [] {
+#ifdef COLD_START_HAS_X86
+    auto start_time = std::chrono::steady_clock::now();
+    uint64_t start_ticks = TimerStart();
+    while (std::chrono::steady_clock::now() - start_time <
+           std::chrono::milliseconds(20)) {
+    }
+    uint64_t end_ticks = TimerEnd();
+    auto elapsed = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start_time
+    );
+    return static_cast<double>(end_ticks - start_ticks) / elapsed.count();
+#else
+    return 1.0;
+#endif
+  }();
+  return ticks_per_ns;
+}
+
+// ===========================
+// BRANCH SCRAMBLING
+// ===========================
+
+inline uint64_t NextRandom(uint64_t &state) {
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+// Distinct targets for the indirect-branch scramble
+template <int N>
+[[gnu::noinline]] uint64_t ScrambleTarget(uint64_t value) {
+  return value * (2 * N + 1) + N;
+}
+
+constexpr std::array<uint64_t (*)(uint64_t), 8> kScrambleTargets = {
+    ScrambleTarget<0>,
+    ScrambleTarget<1>,
+    ScrambleTarget<2>,
+    ScrambleTarget<3>,
+    ScrambleTarget<4>,
+    ScrambleTarget<5>,
+    ScrambleTarget<6>,
+    ScrambleTarget<7>,
+};
+
+// Random branches taken per scramble; a few times the size of the
+// predictor's global history and BTB
+constexpr size_t kScrambleBranches = 1 << 14;
+
+// ===========================
+// MEASURED CALLS
+// ===========================
+
+// The measured region. noinline keeps one code address per object type to
+// flush, and hides the concrete type of runtime objects from the caller.
+template <typename Object>
+[[gnu::noinline]] double CallBatch(const Object &object, double x, size_t n) {
+  double sum = 0.0;
+  for (size_t i = 0; i < n; ++i) {
+    sum += object.Compute(x + static_cast<double>(i) * 1e-3);
+  }
+  return sum;
+}
+
+// Lines to flush before a cold call: the object, the measured function and,
+// for polymorphic objects, the vtable and the virtual Compute it points to
+template <typename Object>
+void FlushCallTargets(const Object &object) {
+  FlushLines(&object, sizeof(object));
+  FlushLines(
+      reinterpret_cast<const void *>(&CallBatch<Object>),
+      kCodeFlushBytes
+  );
+  if constexpr (std::is_polymorphic_v<Object>) {
+    // Itanium ABI: the vptr is the first word, Compute is the first slot
+    auto *const *vtable = *reinterpret_cast<void *const *const *>(&object);
+    FlushLines(vtable, kCacheLineSize);
+    FlushLines(vtable[0], kCodeFlushBytes);
+  }
+}
+
+struct LatencySamples {
+  std::vector<double> cold_ticks;
+  std::vector<double> warm_ticks;
+};
+
+template <typename Object>
+LatencySamples SampleLatency(
+    const Object &object,
+    const ColdStartOptions &options,
+    std::vector<uint64_t> &evict_buffer
+) {
+  LatencySamples samples;
+  samples.cold_ticks.reserve(options.samples);
+  samples.warm_ticks.reserve(options.samples);
+  uint64_t branch_state = 0x9E3779B97F4A7C15ULL;
+  double sum = 0.0;
+
+  for (size_t s = 0; s < options.samples; ++s) {
+    EvictCaches(evict_buffer);
+    FlushCallTargets(object);
+    ScrambleBranchHistory(branch_state);
+
+    double x = 1.0 + static_cast<double>(s & 255) / 256.0;
+    uint64_t start = TimerStart();
+    sum += CallBatch(object, x, options.batch);
+    uint64_t end = TimerEnd();
+    samples.cold_ticks.push_back(static_cast<double>(end - start));
+  }
+
+  // Warm reference: same calls, back to back, after a warm-up
+  for (size_t s = 0; s < options.samples * 2; ++s) {
+    double x = 1.0 + static_cast<double>(s & 255) / 256.0;
+    uint64_t start = TimerStart();
+    sum += CallBatch(object, x, options.batch);
+    uint64_t end = TimerEnd();
+    if (s >= options.samples) {
+      samples.warm_ticks.push_back(static_cast<double>(end - start));
+    }
+  }
+
+  prevent_optimization = sum;
+  return samples;
+}
+
+// Median ticks of an empty timed region
+double TimerOverheadTicks(size_t samples) {
+  std::vector<double> ticks;
+  ticks.reserve(samples);
+  for (size_t s = 0; s < samples; ++s) {
+    uint64_t start = TimerStart();
+    uint64_t end = TimerEnd();
+    ticks.push_back(static_cast<double>(end - start));
+  }
+  return Percentile(std::move(ticks), 0.5);
+}
+
+template <typename Object>
+ColdStartResult Measure(
+    const std::string &category,
+    const std::string &computation,
+    const Object &object,
+    const ColdStartOptions &options
+) {
+  size_t evict_bytes = options.evict_bytes != 0
+                           ? options.evict_bytes
+                           : LastLevelCacheSize() * 3 / 2;
+  std::vector<uint64_t> evict_buffer(evict_bytes / sizeof(uint64_t), 1);
+
+  LatencySamples samples = SampleLatency(object, options, evict_buffer);
+  double overhead = TimerOverheadTicks(1000);
+  double ticks_per_ns = TicksPerNs();
+  auto batch = static_cast<double>(options.batch);
+
+  // Per call, with the timer overhead removed
+  auto per_call = [&](double ticks) {
+    return std::max(ticks - overhead, 0.0) / batch;
+  };
+  double cold_median = per_call(Percentile(samples.cold_ticks, 0.5));
+  double cold_p90 = per_call(Percentile(samples.cold_ticks, 0.9));
+  double warm_median = per_call(Percentile(samples.warm_ticks, 0.5));
+
+  return ColdStartResult{
+      category,
+      computation,
+      cold_median / ticks_per_ns,
+      cold_p90 / ticks_per_ns,
+      cold_median,
+      warm_median / ticks_per_ns
+  };
+}
+
+template <typename FMA, typename Expensive>
+ColdStartResult MeasureStatic(
+    const std::string &category,
+    const std::string &computation,
+    const ColdStartOptions &options
+) {
+  if (computation == "fma") {
+    return Measure(category, computation, FMA{}, options);
+  }
+  if (computation == "expensive") {
+    return Measure(category, computation, Expensive{}, options);
+  }
+  throw std::invalid_argument("Invalid cold-start computation: " + computation);
+}
+
+} // namespace
+
+ColdStartOptions &GetColdStartOptions() {
+  static ColdStartOptions options;
+  return options;
+}
+
+size_t LastLevelCacheSize() {
+#ifdef _SC_LEVEL3_CACHE_SIZE
+  long l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+  if (l3 > 0) {
+    return static_cast<size_t>(l3);
+  }
+#endif
+  std::ifstream size_file("/sys/devices/system/cpu/cpu0/cache/index3/size");
+  size_t kilobytes = 0;
+  if (size_file >> kilobytes && kilobytes > 0) {
+    return kilobytes * 1024;
+  }
+  return size_t{32} << 20;
+}
+
+void EvictCaches(std::vector<uint64_t> &buffer) {
+  constexpr size_t kStride = kCacheLineSize / sizeof(uint64_t);
+  uint64_t sum = 0;
+  for (size_t i = 0; i < buffer.size(); i += kStride) {
+    sum += buffer[i]++;
+  }
+  prevent_optimization = static_cast<double>(sum);
+}
+
+void FlushLines(const void *address, size_t num_bytes) {
+#ifdef COLD_START_HAS_X86
+  auto begin = reinterpret_cast<uintptr_t>(address) & ~(kCacheLineSize - 1);
+  auto end = reinterpret_cast<uintptr_t>(address) + num_bytes;
+  for (uintptr_t line = begin; line < end; line += kCacheLineSize) {
+    _mm_clflush(reinterpret_cast<const void *>(line));
+  }
+  _mm_mfence();
+#else
+  (void)address;
+  (void)num_bytes;
+#endif
+}
+
+void ScrambleBranchHistory(uint64_t &state) {
+  uint64_t accumulator = 0;
+  for (size_t i = 0; i < kScrambleBranches; ++i) {
+    uint64_t random = NextRandom(state);
+    if (random & 1) {
+      accumulator += random >> 7;
+    } else {
+      accumulator ^= random >> 3;
+    }
+    if (random & 2) {
+      accumulator = kScrambleTargets[(random >> 8) & 7](accumulator);
+    }
+  }
+  prevent_optimization = static_cast<double>(accumulator);
+}
+
+double Percentile(std::vector<double> values, double p) {
+  if (values.empty()) {
+    return 0.0;
+  }
+  auto rank = static_cast<size_t>(p * static_cast<double>(values.size() - 1));
+  std::nth_element(values.begin(), values.begin() + rank, values.end());
+  return values[rank];
+}
+
+ColdStartResult MeasureColdStart(
+    const std::string &category,
+    const std::string &computation,
+    const ColdStartOptions &options
+) {
+  if (category == "runtime") {
+    std::unique_ptr<runtime_polymorphism::RuntimeBase> object;
+    if (computation == "fma") {
+      object = std::make_unique<runtime_polymorphism::PolyFMA>();
+    } else if (computation == "expensive") {
+      object = std::make_unique<runtime_polymorphism::PolyExpensive>();
+    } else {
+      throw std::invalid_argument(
+          "Invalid cold-start computation: " + computation
+      );
+    }
+    return Measure(category, computation, *object, options);
+  }
+  if (category == "crtp") {
+    return MeasureStatic<
+        crtp_polymorphism::PolyFMA,
+        crtp_polymorphism::PolyExpensive>(category, computation, options);
+  }
+  if (category == "concepts") {
+    return MeasureStatic<
+        concepts_polymorphism::InlinePolyFMA,
+        concepts_polymorphism::InlinePolyExpensive>(
+        category,
+        computation,
+        options
+    );
+  }
+  throw std::invalid_argument("Invalid cold-start category: " + category);
+}
+
+void WriteColdStartTable(
+    std::ostream &out,
+    const std::vector<ColdStartResult> &results
+) {
+  out << "| Category | Computation | Cold Median (ns) | Cold p90 (ns) "
+         "| Cold Median (ticks) | Warm Median (ns) | Cold / Warm |\n";
+  out << "|----------|-------------|------|------|------|------|------|\n";
+  for (const auto &result : results) {
+    double ratio = result.warm_median_ns > 0.0
+                       ? result.cold_median_ns / result.warm_median_ns
+                       : 0.0;
+    out << "| " << result.category << " | " << result.computation << " | "
+        << std::fixed << std::setprecision(1) << result.cold_median_ns
+        << " | " << result.cold_p90_ns << " | " << result.cold_median_ticks
+        << " | " << result.warm_median_ns << " | " << ratio << " |\n";
+    out.unsetf(std::ios::fixed);
+  }
+}
+
+void RunColdStartBenchmark(size_t /*iterations*/) {
+  const auto &options = GetColdStartOptions();
+  size_t evict_bytes = options.evict_bytes != 0
+                           ? options.evict_bytes
+                           : LastLevelCacheSize() * 3 / 2;
+
+  std::cout << "Cold Samples: " << options.samples
+            << ", Calls per Sample: " << options.batch
+            << ", Eviction Buffer: " << (evict_bytes >> 20) << " MiB (LLC "
+            << (LastLevelCacheSize() >> 20) << " MiB)\n";
+#ifndef COLD_START_HAS_X86
+  std::cout << "Note: no clflush/TSC on this target, so code and vtables "
+               "are evicted only by the buffer sweep\n";
+#endif
+  std::cout << "\n";
+
+  std::vector<ColdStartResult> results;
+  for (const std::string category : {"runtime", "crtp", "concepts"}) {
+    for (const std::string computation : {"fma", "expensive"}) {
+      results.push_back(MeasureColdStart(category, computation, options));
+    }
+  }
+  WriteColdStartTable(std::cout, results);
+  std::cout << std::endl;
+}
+
+} // namespace cold_start
@@ -10,6 +10,40 @@ double PolyFMA::Compute(double x) const {return ComputeFMA(x);}
 
 double PolyExpensive::Compute(double x) const {return ComputeExpensive(x);}
 
+template <Accuracy A>
+double PolyExpensiveApprox<A>::Compute(double x) const {
+  return ComputeExpensiveApprox<A>(x);
+}
+
+template class PolyExpensiveApprox<Accuracy::kLow>;
+template class PolyExpensiveApprox<Accuracy::kMedium>;
+template class PolyExpensiveApprox<Accuracy::kHigh>;
+
+template <size_t K>
+double PolyChain<K>::Compute(double x) const {
+  return ComputeChain<K>(x);
+}
+
+template class PolyChain<1>;
+template class PolyChain<2>;
+template class PolyChain<4>;
+template class PolyChain<8>;
+template class PolyChain<16>;
+template class PolyChain<32>;
+template class PolyChain<64>;
+template class PolyChain<128>;
+template class PolyChain<256>;
+
+double PolyTriad::Compute(size_t i) const { return ComputeTriad(arrays_, i); }
+
+double PolyDot::Compute(size_t i) const { return ComputeDot(arrays_, i); }
+
+double PolyStencil::Compute(size_t i) const {
+  return ComputeStencil(arrays_, i);
+}
+
+double PolyGather::Compute(size_t i) const { return ComputeGather(arrays_, i); }
+
 // Explicit template instantiations
 
 template void TestConceptsPolymorphism<PolyFMA>(
@@ -24,4 +58,104 @@ template void TestConceptsPolymorphism<PolyExpensive>(
     PolyExpensive &obj
 );
 
+template void TestConceptsPolymorphism<PolyExpensiveApprox<Accuracy::kLow>>(
+    const std::string &label,
+    size_t n,
+    PolyExpensiveApprox<Accuracy::kLow> &obj
+);
+
+template void TestConceptsPolymorphism<PolyExpensiveApprox<Accuracy::kMedium>>(
+    const std::string &label,
+    size_t n,
+    PolyExpensiveApprox<Accuracy::kMedium> &obj
+);
+
+template void TestConceptsPolymorphism<PolyExpensiveApprox<Accuracy::kHigh>>(
+    const std::string &label,
+    size_t n,
+    PolyExpensiveApprox<Accuracy::kHigh> &obj
+);
+
+template void TestConceptsPolymorphism<PolyChain<1>>(
+    const std::string &label,
+    size_t n,
+    PolyChain<1> &obj
+);
+
+template void TestConceptsPolymorphism<PolyChain<2>>(
+    const std::string &label,
+    size_t n,
+    PolyChain<2> &obj
+);
+
+template void TestConceptsPolymorphism<PolyChain<4>>(
+    const std::string &label,
+    size_t n,
+    PolyChain<4> &obj
+);
+
+template void TestConceptsPolymorphism<PolyChain<8>>(
+    const std::string &label,
+    size_t n,
+    PolyChain<8> &obj
+);
+
+template void TestConceptsPolymorphism<PolyChain<16>>(
+    const std::string &label,
+    size_t n,
+    PolyChain<16> &obj
+);
+
+template void TestConceptsPolymorphism<PolyChain<32>>(
+    const std::string &label,
+    size_t n,
+    PolyChain<32> &obj
+);
+
+template void TestConceptsPolymorphism<PolyChain<64>>(
+    const std::string &label,
+    size_t n,
+    PolyChain<64> &obj
+);
+
+template void TestConceptsPolymorphism<PolyChain<128>>(
+    const std::string &label,
+    size_t n,
+    PolyChain<128> &obj
+);
+
+template void TestConceptsPolymorphism<PolyChain<256>>(
+    const std::string &label,
+    size_t n,
+    PolyChain<256> &obj
+);
+
+template void TestConceptsStreamPolymorphism<PolyTriad>(
+    const std::string &label,
+    size_t n,
+    size_t mask,
+    PolyTriad &obj
+);
+
+template void TestConceptsStreamPolymorphism<PolyDot>(
+    const std::string &label,
+    size_t n,
+    size_t mask,
+    PolyDot &obj
+);
+
+template void TestConceptsStreamPolymorphism<PolyStencil>(
+    const std::string &label,
+    size_t n,
+    size_t mask,
+    PolyStencil &obj
+);
+
+template void TestConceptsStreamPolymorphism<PolyGather>(
+    const std::string &label,
+    size_t n,
+    size_t mask,
+    PolyGather &obj
+);
+
 } // namespace concepts_polymorphism
@@ -15,5 +15,46 @@ template void TestCRTPPolymorphism<PolyExpensive>(
     size_t n,
     PolyExpensive &obj
 );
+template void TestCRTPPolymorphism<PolyExpensiveApprox<Accuracy::kLow>>(
+    const std::string &label,
+    size_t n,
+    PolyExpensiveApprox<Accuracy::kLow> &obj
+);
+template void TestCRTPPolymorphism<PolyExpensiveApprox<Accuracy::kMedium>>(
+    const std::string &label,
+    size_t n,
+    PolyExpensiveApprox<Accuracy::kMedium> &obj
+);
+template void TestCRTPPolymorphism<PolyExpensiveApprox<Accuracy::kHigh>>(
+    const std::string &label,
+    size_t n,
+    PolyExpensiveApprox<Accuracy::kHigh> &obj
+);
+
+
+template void TestCRTPStreamPolymorphism<PolyTriad>(
+    const std::string &label,
+    size_t n,
+    size_t mask,
+    PolyTriad &obj
+);
+template void TestCRTPStreamPolymorphism<PolyDot>(
+    const std::string &label,
+    size_t n,
+    size_t mask,
+    PolyDot &obj
+);
+template void TestCRTPStreamPolymorphism<PolyStencil>(
+    const std::string &label,
+    size_t n,
+    size_t mask,
+    PolyStencil &obj
+);
+template void TestCRTPStreamPolymorphism<PolyGather>(
+    const std::string &label,
+    size_t n,
+    size_t mask,
+    PolyGather &obj
+);
 
 } // namespace crtp_polymorphism
@@ -0,0 +1,277 @@
+#include "double_dispatch.hpp"
+#include "benchmark_utils.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+
+namespace double_dispatch {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Calls per pass; the call data stays cache resident
+constexpr size_t kSequenceLength = size_t{1} << 16;
+
+// Holds one object of every left and right type in each representation, plus
+// the call sequence translated to that representation
+template <size_t N, size_t M>
+class DispatchMatrix {
+public:
+  explicit DispatchMatrix(std::span<const PairCall> calls) : calls_(calls) {
+    [&]<size_t... Is>(std::index_sequence<Is...>) {
+      lefts_ = {std::make_unique<VisitorLeftImpl<N, Is>>()...};
+      left_values_ = {LeftVariant<N>(std::in_place_index<Is>)...};
+    }(std::make_index_sequence<N>{});
+    [&]<size_t... Js>(std::index_sequence<Js...>) {
+      rights_ = {std::make_unique<VisitorRightImpl<N, Js>>()...};
+      right_values_ = {RightVariant<M>(std::in_place_index<Js>)...};
+    }(std::make_index_sequence<M>{});
+
+    visitor_calls_.reserve(calls.size());
+    variant_calls_.reserve(calls.size());
+    for (const auto &call : calls) {
+      if (call.left >= N || call.right >= M) {
+        throw std::invalid_argument("Pair call outside the type matrix");
+      }
+      visitor_calls_.push_back(
+          {lefts_[call.left].get(), rights_[call.right].get(), call.x}
+      );
+      variant_calls_.push_back(
+          {left_values_[call.left], right_values_[call.right], call.x}
+      );
+    }
+  }
+
+  double Evaluate(Approach approach) {
+    switch (approach) {
+    case Approach::kVirtualVisitor:
+      return EvaluateVirtualVisitor();
+    case Approach::kVariantVisit:
+      return EvaluateVariantVisit();
+    case Approach::kFunctionTable:
+      return EvaluateFunctionTable();
+    case Approach::kStaticOverload:
+      return batcher_.Evaluate(calls_);
+    }
+    return 0.0;
+  }
+
+private:
+  struct VisitorCall {
+    const VisitorLeft<N> *left;
+    const VisitorRight<N> *right;
+    double x;
+  };
+
+  struct VariantCall {
+    LeftVariant<N> left;
+    RightVariant<M> right;
+    double x;
+  };
+
+  double EvaluateVirtualVisitor() const {
+    double sum = 0.0;
+    for (const auto &call : visitor_calls_) {
+      sum += call.left->Accept(*call.right, call.x);
+    }
+    return sum;
+  }
+
+  double EvaluateVariantVisit() const {
+    double sum = 0.0;
+    for (const auto &call : variant_calls_) {
+      sum += VisitPair<N, M>(call.left, call.right, call.x);
+    }
+    return sum;
+  }
+
+  double EvaluateFunctionTable() const {
+    static constexpr InteractionTable<N, M> kTable =
+        MakeInteractionTable<N, M>();
+    double sum = 0.0;
+    for (const auto &call : calls_) {
+      sum += kTable[call.left][call.right](call.x);
+    }
+    return sum;
+  }
+
+  std::span<const PairCall> calls_;
+  std::array<std::unique_ptr<VisitorLeft<N>>, N> lefts_;
+  std::array<std::unique_ptr<VisitorRight<N>>, M> rights_;
+  std::array<LeftVariant<N>, N> left_values_;
+  std::array<RightVariant<M>, M> right_values_;
+  std::vector<VisitorCall> visitor_calls_;
+  std::vector<VariantCall> variant_calls_;
+  StaticBatcher<N, M> batcher_;
+};
+
+template <size_t N, size_t M>
+DoubleDispatchResult
+Measure(Approach approach, std::span<const PairCall> calls, size_t passes) {
+  DispatchMatrix<N, M> matrix(calls);
+
+  double pass_sum = matrix.Evaluate(approach); // warm-up
+  double total = 0.0;
+  auto start = Clock::now();
+  for (size_t pass = 0; pass < passes; ++pass) {
+    pass_sum = matrix.Evaluate(approach);
+    total += pass_sum;
+  }
+  auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start);
+  prevent_optimization = total;
+
+  size_t num_calls = std::max<size_t>(calls.size() * passes, 1);
+  return {N, M, approach, elapsed.count() / num_calls, pass_sum};
+}
+
+using MeasureFunction = DoubleDispatchResult (*)(
+    Approach,
+    std::span<const PairCall>,
+    size_t
+);
+
+struct MatrixEntry {
+  size_t num_left;
+  size_t num_right;
+  MeasureFunction measure;
+};
+
+// Square matrices show growth in both dimensions together, the lopsided
+// ones separate the left (first) and right (second) dispatch
+const std::vector<MatrixEntry> &MatrixEntries() {
+  static const std::vector<MatrixEntry> entries = {
+      {2, 2, &Measure<2, 2>},
+      {4, 4, &Measure<4, 4>},
+      {8, 8, &Measure<8, 8>},
+      {16, 16, &Measure<16, 16>},
+      {2, 16, &Measure<2, 16>},
+      {16, 2, &Measure<16, 2>},
+  };
+  return entries;
+}
+
+} // namespace
+
+std::vector<PairCall> MakePairSequence(
+    size_t length,
+    size_t num_left,
+    size_t num_right,
+    uint64_t seed
+) {
+  std::mt19937_64 rng(seed);
+  std::uniform_int_distribution<size_t> left(0, num_left - 1);
+  std::uniform_int_distribution<size_t> right(0, num_right - 1);
+  std::uniform_real_distribution<double> argument(0.0, 1.0);
+
+  std::vector<PairCall> calls(length);
+  for (auto &call : calls) {
+    call.left = static_cast<uint8_t>(left(rng));
+    call.right = static_cast<uint8_t>(right(rng));
+    call.x = argument(rng);
+  }
+  return calls;
+}
+
+std::string ApproachName(Approach approach) {
+  switch (approach) {
+  case Approach::kVirtualVisitor:
+    return "virtual visitor";
+  case Approach::kVariantVisit:
+    return "std::visit";
+  case Approach::kFunctionTable:
+    return "function table";
+  case Approach::kStaticOverload:
+    return "crtp/concepts (bucketed)";
+  }
+  return "unknown";
+}
+
+const std::vector<Approach> &AllApproaches() {
+  static const std::vector<Approach> approaches = {
+      Approach::kVirtualVisitor,
+      Approach::kVariantVisit,
+      Approach::kFunctionTable,
+      Approach::kStaticOverload,
+  };
+  return approaches;
+}
+
+const std::vector<std::pair<size_t, size_t>> &MatrixSizes() {
+  static const std::vector<std::pair<size_t, size_t>> sizes = [] {
+    std::vector<std::pair<size_t, size_t>> sizes;
+    for (const auto &entry : MatrixEntries()) {
+      sizes.emplace_back(entry.num_left, entry.num_right);
+    }
+    return sizes;
+  }();
+  return sizes;
+}
+
+DoubleDispatchResult MeasureDoubleDispatch(
+    size_t num_left,
+    size_t num_right,
+    Approach approach,
+    std::span<const PairCall> calls,
+    size_t passes
+) {
+  TRACE_SCOPE("MeasureDoubleDispatch");
+  for (const auto &entry : MatrixEntries()) {
+    if (entry.num_left == num_left && entry.num_right == num_right) {
+      return entry.measure(approach, calls, passes);
+    }
+  }
+  throw std::invalid_argument(
+      "No compiled-in " + std::to_string(num_left) + " x " +
+      std::to_string(num_right) + " type matrix"
+  );
+}
+
+void WriteDoubleDispatchTable(
+    std::ostream &out,
+    const std::vector<DoubleDispatchResult> &results
+) {
+  out << "| Matrix (N x M) | Approach | Time (ns/call) | vs Smallest Matrix "
+         "|\n";
+  out << "|-------|----------|------|------|\n";
+  for (const auto &result : results) {
+    const DoubleDispatchResult *baseline = nullptr;
+    for (const auto &other : results) {
+      if (other.approach == result.approach &&
+          (baseline == nullptr || other.num_left * other.num_right <
+                                      baseline->num_left * baseline->num_right)) {
+        baseline = &other;
+      }
+    }
+
+    out << "| " << result.num_left << " x " << result.num_right << " | "
+        << ApproachName(result.approach) << " | " << std::fixed
+        << std::setprecision(2) << result.ns_per_call << " | "
+        << result.ns_per_call / baseline->ns_per_call << " |\n";
+    out.unsetf(std::ios::fixed);
+  }
+}
+
+void RunDoubleDispatchBenchmark(size_t iterations) {
+  size_t passes = std::max(iterations / kSequenceLength, size_t{1});
+  std::cout << "Random pair sequence: " << kSequenceLength
+            << " calls, Passes: " << passes << "\n\n";
+
+  std::vector<DoubleDispatchResult> results;
+  for (const auto &[num_left, num_right] : MatrixSizes()) {
+    auto calls = MakePairSequence(kSequenceLength, num_left, num_right, 42);
+    for (Approach approach : AllApproaches()) {
+      results.push_back(
+          MeasureDoubleDispatch(num_left, num_right, approach, calls, passes)
+      );
+    }
+  }
+  WriteDoubleDispatchTable(std::cout, results);
+  std::cout << std::endl;
+}
+
+} // namespace double_dispatch
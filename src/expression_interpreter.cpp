@@ -0,0 +1,615 @@
+#include "expression_interpreter.hpp"
+#include "benchmark_utils.hpp"
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace expression_interpreter {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Each measurement keeps the fastest of this many runs
+constexpr int kRepetitions = 3;
+
+// Length of the input array every tree is evaluated over
+constexpr size_t kInputLength = 1024;
+
+// ===========================
+// VIRTUAL NODES
+// ===========================
+
+class InputNode final : public VirtualNode {
+public:
+  double Evaluate(double x) const override { return x; }
+};
+
+class ConstantNode final : public VirtualNode {
+public:
+  explicit ConstantNode(double value) : value_(value) {}
+  double Evaluate(double) const override { return value_; }
+
+private:
+  double value_;
+};
+
+template <Op kOp>
+class UnaryNode final : public VirtualNode {
+public:
+  explicit UnaryNode(std::unique_ptr<VirtualNode> child)
+      : child_(std::move(child)) {}
+  double Evaluate(double x) const override {
+    return ApplyUnary(kOp, child_->Evaluate(x));
+  }
+
+private:
+  std::unique_ptr<VirtualNode> child_;
+};
+
+template <Op kOp>
+class BinaryNode final : public VirtualNode {
+public:
+  BinaryNode(
+      std::unique_ptr<VirtualNode> left,
+      std::unique_ptr<VirtualNode> right
+  )
+      : left_(std::move(left)), right_(std::move(right)) {}
+  double Evaluate(double x) const override {
+    return ApplyBinary(kOp, left_->Evaluate(x), right_->Evaluate(x));
+  }
+
+private:
+  std::unique_ptr<VirtualNode> left_;
+  std::unique_ptr<VirtualNode> right_;
+};
+
+// ===========================
+// STATIC TREES
+// ===========================
+
+template <size_t Shape>
+struct ShapeHolder {
+  static constexpr ExprTree kTree = MakeRandomTree(
+      kTreeShapes[Shape].size,
+      kTreeShapes[Shape].depth,
+      kTreeSeed + Shape
+  );
+};
+
+template <typename Derived>
+class StaticExpression {
+public:
+  double Evaluate(double x) const {
+    return static_cast<const Derived &>(*this).EvaluateImpl(x);
+  }
+};
+
+// Node I of Tree as a type: the whole tree is resolved at compile time.
+// Constants go through OpaqueValue so constant subtrees are still evaluated
+// at run time, as they are by the interpreters.
+template <const ExprTree &Tree, uint32_t I>
+class CRTPNode : public StaticExpression<CRTPNode<Tree, I>> {
+public:
+  double EvaluateImpl(double x) const {
+    constexpr ExprNode node = Tree.nodes[I];
+    if constexpr (node.op == Op::kInput) {
+      return x;
+    } else if constexpr (node.op == Op::kConstant) {
+      return OpaqueValue(node.constant);
+    } else if constexpr (IsUnary(node.op)) {
+      return ApplyUnary(node.op, CRTPNode<Tree, node.left>{}.Evaluate(x));
+    } else {
+      return ApplyBinary(
+          node.op,
+          CRTPNode<Tree, node.left>{}.Evaluate(x),
+          CRTPNode<Tree, node.right>{}.Evaluate(x)
+      );
+    }
+  }
+};
+
+template <typename T>
+concept Expression = requires(const T &expression, double x) {
+  { expression.Evaluate(x) } -> std::convertible_to<double>;
+};
+
+template <Expression E>
+double EvaluateExpression(const E &expression, double x) {
+  return expression.Evaluate(x);
+}
+
+template <const ExprTree &Tree, uint32_t I>
+class ConceptNode {
+public:
+  double Evaluate(double x) const {
+    constexpr ExprNode node = Tree.nodes[I];
+    if constexpr (node.op == Op::kInput) {
+      return x;
+    } else if constexpr (node.op == Op::kConstant) {
+      return OpaqueValue(node.constant);
+    } else if constexpr (IsUnary(node.op)) {
+      return ApplyUnary(
+          node.op,
+          EvaluateExpression(ConceptNode<Tree, node.left>{}, x)
+      );
+    } else {
+      return ApplyBinary(
+          node.op,
+          EvaluateExpression(ConceptNode<Tree, node.left>{}, x),
+          EvaluateExpression(ConceptNode<Tree, node.right>{}, x)
+      );
+    }
+  }
+};
+
+// ===========================
+// MEASUREMENT
+// ===========================
+
+struct Timing {
+  double ns_per_evaluation;
+  double sum;
+};
+
+template <typename Evaluate>
+Timing TimeEvaluations(
+    const std::vector<double> &inputs,
+    size_t passes,
+    const Evaluate &evaluate
+) {
+  double fastest_ns = std::numeric_limits<double>::max();
+  double sum = 0.0;
+  for (int repetition = 0; repetition < kRepetitions; ++repetition) {
+    sum = 0.0;
+    auto start = Clock::now();
+    for (size_t pass = 0; pass < passes; ++pass) {
+      for (double x : inputs) {
+        sum += evaluate(x);
+      }
+    }
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    fastest_ns = std::min(fastest_ns, elapsed.count());
+  }
+  prevent_optimization = sum;
+  return {fastest_ns / static_cast<double>(passes * inputs.size()), sum};
+}
+
+template <size_t Shape>
+Timing TimeCRTP(const std::vector<double> &inputs, size_t passes) {
+  using Holder = ShapeHolder<Shape>;
+  CRTPNode<Holder::kTree, Holder::kTree.root()> root;
+  return TimeEvaluations(inputs, passes, [&](double x) {
+    return root.Evaluate(x);
+  });
+}
+
+template <size_t Shape>
+Timing TimeConcepts(const std::vector<double> &inputs, size_t passes) {
+  using Holder = ShapeHolder<Shape>;
+  ConceptNode<Holder::kTree, Holder::kTree.root()> root;
+  return TimeEvaluations(inputs, passes, [&](double x) {
+    return EvaluateExpression(root, x);
+  });
+}
+
+using StaticTimings = std::array<
+    Timing (*)(const std::vector<double> &, size_t),
+    kTreeShapes.size()>;
+
+constexpr StaticTimings kCRTPTimings =
+    []<size_t... Is>(std::index_sequence<Is...>) {
+      return StaticTimings{&TimeCRTP<Is>...};
+    }(std::make_index_sequence<kTreeShapes.size()>{});
+
+constexpr StaticTimings kConceptsTimings =
+    []<size_t... Is>(std::index_sequence<Is...>) {
+      return StaticTimings{&TimeConcepts<Is>...};
+    }(std::make_index_sequence<kTreeShapes.size()>{});
+
+const ExpressionResult *FindVirtualResult(
+    const std::vector<ExpressionResult> &results,
+    const ExpressionResult &result
+) {
+  auto it = std::find_if(
+      results.begin(),
+      results.end(),
+      [&](const ExpressionResult &candidate) {
+        return candidate.approach == Approach::kVirtualNodes &&
+               candidate.size == result.size &&
+               candidate.depth == result.depth;
+      }
+  );
+  return it != results.end() ? &*it : nullptr;
+}
+
+} // namespace
+
+double EvaluateReference(const ExprTree &tree, double x) {
+  std::vector<double> values(tree.size);
+  for (uint32_t i = 0; i < tree.size; ++i) {
+    const ExprNode &node = tree.nodes[i];
+    if (node.op == Op::kInput) {
+      values[i] = x;
+    } else if (node.op == Op::kConstant) {
+      values[i] = node.constant;
+    } else if (IsUnary(node.op)) {
+      values[i] = ApplyUnary(node.op, values[node.left]);
+    } else {
+      values[i] = ApplyBinary(node.op, values[node.left], values[node.right]);
+    }
+  }
+  return values[tree.root()];
+}
+
+std::unique_ptr<VirtualNode> BuildVirtualTree(const ExprTree &tree) {
+  std::vector<std::unique_ptr<VirtualNode>> built(tree.size);
+  for (uint32_t i = 0; i < tree.size; ++i) {
+    const ExprNode &node = tree.nodes[i];
+    switch (node.op) {
+    case Op::kInput:
+      built[i] = std::make_unique<InputNode>();
+      break;
+    case Op::kConstant:
+      built[i] = std::make_unique<ConstantNode>(node.constant);
+      break;
+    case Op::kFMA:
+      built[i] = std::make_unique<UnaryNode<Op::kFMA>>(
+          std::move(built[node.left])
+      );
+      break;
+    case Op::kExpensive:
+      built[i] = std::make_unique<UnaryNode<Op::kExpensive>>(
+          std::move(built[node.left])
+      );
+      break;
+    case Op::kAverage:
+      built[i] = std::make_unique<BinaryNode<Op::kAverage>>(
+          std::move(built[node.left]),
+          std::move(built[node.right])
+      );
+      break;
+    case Op::kDifference:
+      built[i] = std::make_unique<BinaryNode<Op::kDifference>>(
+          std::move(built[node.left]),
+          std::move(built[node.right])
+      );
+      break;
+    }
+  }
+  return std::move(built[tree.root()]);
+}
+
+VariantArena::VariantArena(const ExprTree &tree) : root_(tree.root()) {
+  nodes_.reserve(tree.size);
+  for (uint32_t i = 0; i < tree.size; ++i) {
+    const ExprNode &node = tree.nodes[i];
+    switch (node.op) {
+    case Op::kInput:
+      nodes_.emplace_back(InputTerm{});
+      break;
+    case Op::kConstant:
+      nodes_.emplace_back(ConstantTerm{node.constant});
+      break;
+    case Op::kFMA:
+      nodes_.emplace_back(UnaryTerm<Op::kFMA>{node.left});
+      break;
+    case Op::kExpensive:
+      nodes_.emplace_back(UnaryTerm<Op::kExpensive>{node.left});
+      break;
+    case Op::kAverage:
+      nodes_.emplace_back(BinaryTerm<Op::kAverage>{node.left, node.right});
+      break;
+    case Op::kDifference:
+      nodes_.emplace_back(BinaryTerm<Op::kDifference>{node.left, node.right}
+      );
+      break;
+    }
+  }
+}
+
+double VariantArena::Evaluate(uint32_t index, double x) const {
+  return std::visit(
+      [&](const auto &term) -> double {
+        using Term = std::decay_t<decltype(term)>;
+        if constexpr (std::is_same_v<Term, InputTerm>) {
+          return x;
+        } else if constexpr (std::is_same_v<Term, ConstantTerm>) {
+          return term.value;
+        } else if constexpr (requires { term.child; }) {
+          return ApplyUnary(Term::op, Evaluate(term.child, x));
+        } else {
+          return ApplyBinary(
+              Term::op,
+              Evaluate(term.left, x),
+              Evaluate(term.right, x)
+          );
+        }
+      },
+      nodes_[index]
+  );
+}
+
+Bytecode::Bytecode(const ExprTree &tree) {
+  // Post-order is already postfix: leaves push, operators pop their operands
+  // and push the result
+  code_.reserve(tree.size + 1);
+  size_t stack = 0;
+  for (uint32_t i = 0; i < tree.size; ++i) {
+    const ExprNode &node = tree.nodes[i];
+    switch (node.op) {
+    case Op::kInput:
+      code_.push_back({Opcode::kPushInput, 0.0});
+      ++stack;
+      break;
+    case Op::kConstant:
+      code_.push_back({Opcode::kPushConstant, node.constant});
+      ++stack;
+      break;
+    case Op::kFMA:
+      code_.push_back({Opcode::kFMA, 0.0});
+      break;
+    case Op::kExpensive:
+      code_.push_back({Opcode::kExpensive, 0.0});
+      break;
+    case Op::kAverage:
+      code_.push_back({Opcode::kAverage, 0.0});
+      --stack;
+      break;
+    case Op::kDifference:
+      code_.push_back({Opcode::kDifference, 0.0});
+      --stack;
+      break;
+    }
+    max_stack_ = std::max(max_stack_, stack);
+  }
+  code_.push_back({Opcode::kReturn, 0.0});
+}
+
+double Bytecode::RunSwitch(double x) const {
+  // A postfix program of kMaxTreeNodes instructions never holds more values
+  std::array<double, kMaxTreeNodes> stack;
+  double *top = stack.data(); // one past the top value
+  for (const Instruction *pc = code_.data();; ++pc) {
+    switch (pc->opcode) {
+    case Opcode::kPushInput:
+      *top++ = x;
+      break;
+    case Opcode::kPushConstant:
+      *top++ = pc->constant;
+      break;
+    case Opcode::kFMA:
+      top[-1] = ApplyUnary(Op::kFMA, top[-1]);
+      break;
+    case Opcode::kExpensive:
+      top[-1] = ApplyUnary(Op::kExpensive, top[-1]);
+      break;
+    case Opcode::kAverage:
+      --top;
+      top[-1] = ApplyBinary(Op::kAverage, top[-1], top[0]);
+      break;
+    case Opcode::kDifference:
+      --top;
+      top[-1] = ApplyBinary(Op::kDifference, top[-1], top[0]);
+      break;
+    case Opcode::kReturn:
+      return top[-1];
+    }
+  }
+}
+
+double Bytecode::RunThreaded(double x) const {
+#if defined(__GNUC__)
+  // Indexed by Opcode
+  static void *const kHandlers[] = {
+      &&push_input,
+      &&push_constant,
+      &&fma,
+      &&expensive,
+      &&average,
+      &&difference,
+      &&ret,
+  };
+#define DISPATCH() goto *kHandlers[static_cast<size_t>((++pc)->opcode)]
+
+  std::array<double, kMaxTreeNodes> stack;
+  double *top = stack.data();
+  const Instruction *pc = code_.data();
+  goto *kHandlers[static_cast<size_t>(pc->opcode)];
+
+push_input:
+  *top++ = x;
+  DISPATCH();
+push_constant:
+  *top++ = pc->constant;
+  DISPATCH();
+fma:
+  top[-1] = ApplyUnary(Op::kFMA, top[-1]);
+  DISPATCH();
+expensive:
+  top[-1] = ApplyUnary(Op::kExpensive, top[-1]);
+  DISPATCH();
+average:
+  --top;
+  top[-1] = ApplyBinary(Op::kAverage, top[-1], top[0]);
+  DISPATCH();
+difference:
+  --top;
+  top[-1] = ApplyBinary(Op::kDifference, top[-1], top[0]);
+  DISPATCH();
+ret:
+  return top[-1];
+
+#undef DISPATCH
+#else
+  return RunSwitch(x);
+#endif
+}
+
+std::string ApproachName(Approach approach) {
+  switch (approach) {
+  case Approach::kVirtualNodes:
+    return "virtual nodes";
+  case Approach::kCRTPStatic:
+    return "CRTP static tree";
+  case Approach::kConceptsStatic:
+    return "Concepts static tree";
+  case Approach::kVariantArena:
+    return "variant arena";
+  case Approach::kBytecodeSwitch:
+    return "bytecode (switch)";
+  case Approach::kBytecodeThreaded:
+    return "bytecode (threaded)";
+  }
+  return "unknown";
+}
+
+const std::vector<Approach> &AllApproaches() {
+  static const std::vector<Approach> approaches = {
+      Approach::kVirtualNodes,
+      Approach::kCRTPStatic,
+      Approach::kConceptsStatic,
+      Approach::kVariantArena,
+      Approach::kBytecodeSwitch,
+      Approach::kBytecodeThreaded,
+  };
+  return approaches;
+}
+
+const ExprTree &ShapeTree(size_t shape_index) {
+  static constexpr std::array<const ExprTree *, kTreeShapes.size()> kTrees =
+      []<size_t... Is>(std::index_sequence<Is...>) {
+        return std::array<const ExprTree *, kTreeShapes.size()>{
+            &ShapeHolder<Is>::kTree...
+        };
+      }(std::make_index_sequence<kTreeShapes.size()>{});
+
+  if (shape_index >= kTrees.size()) {
+    throw std::invalid_argument(
+        "Tree shape " + std::to_string(shape_index) + " isn't compiled in"
+    );
+  }
+  return *kTrees[shape_index];
+}
+
+ExpressionResult MeasureExpression(
+    size_t shape_index,
+    Approach approach,
+    const std::vector<double> &inputs,
+    size_t passes
+) {
+  TRACE_SCOPE("MeasureExpression");
+  const ExprTree &tree = ShapeTree(shape_index);
+  if (inputs.empty() || passes == 0) {
+    throw std::invalid_argument("Need at least one input and one pass");
+  }
+
+  Timing timing{};
+  switch (approach) {
+  case Approach::kVirtualNodes: {
+    std::unique_ptr<VirtualNode> root = BuildVirtualTree(tree);
+    timing = TimeEvaluations(inputs, passes, [&](double x) {
+      return root->Evaluate(x);
+    });
+    break;
+  }
+  case Approach::kCRTPStatic:
+    timing = kCRTPTimings[shape_index](inputs, passes);
+    break;
+  case Approach::kConceptsStatic:
+    timing = kConceptsTimings[shape_index](inputs, passes);
+    break;
+  case Approach::kVariantArena: {
+    VariantArena arena(tree);
+    timing = TimeEvaluations(inputs, passes, [&](double x) {
+      return arena.Evaluate(x);
+    });
+    break;
+  }
+  case Approach::kBytecodeSwitch: {
+    Bytecode bytecode(tree);
+    timing = TimeEvaluations(inputs, passes, [&](double x) {
+      return bytecode.RunSwitch(x);
+    });
+    break;
+  }
+  case Approach::kBytecodeThreaded: {
+    Bytecode bytecode(tree);
+    timing = TimeEvaluations(inputs, passes, [&](double x) {
+      return bytecode.RunThreaded(x);
+    });
+    break;
+  }
+  }
+
+  return {
+      tree.size,
+      tree.depth,
+      approach,
+      passes * inputs.size(),
+      timing.ns_per_evaluation,
+      timing.sum,
+  };
+}
+
+std::vector<double> MakeInputs(size_t length, uint64_t seed) {
+  std::vector<double> inputs(length);
+  uint64_t state = seed;
+  for (double &input : inputs) {
+    // xorshift64
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    input = static_cast<double>(state >> 11) * 0x1.0p-53;
+  }
+  return inputs;
+}
+
+void WriteExpressionTable(
+    std::ostream &out,
+    const std::vector<ExpressionResult> &results
+) {
+  out << "| Nodes | Depth | Approach | Evaluations (M/s) | Time (ns/node) | "
+         "Speedup vs Virtual |\n";
+  out << "|-------|-------|----------|------|------|------|\n";
+  for (const auto &result : results) {
+    out << "| " << result.size << " | " << result.depth << " | "
+        << ApproachName(result.approach) << " | " << std::fixed
+        << std::setprecision(2) << result.EvaluationsPerSecond() / 1e6
+        << " | " << result.ns_per_evaluation / result.size << " | ";
+    if (const ExpressionResult *reference =
+            FindVirtualResult(results, result)) {
+      out << reference->ns_per_evaluation / result.ns_per_evaluation << "x";
+    } else {
+      out << "n/a";
+    }
+    out << " |\n";
+    out.unsetf(std::ios::fixed);
+  }
+}
+
+void RunExpressionBenchmark(size_t iterations) {
+  std::vector<double> inputs = MakeInputs(kInputLength, kTreeSeed);
+  std::cout << "Node evaluations per tree and approach: " << iterations
+            << " (input array of " << kInputLength << " doubles)\n\n";
+
+  std::vector<ExpressionResult> results;
+  for (size_t shape = 0; shape < kTreeShapes.size(); ++shape) {
+    size_t passes = std::max(
+        iterations / (kTreeShapes[shape].size * inputs.size()),
+        size_t{1}
+    );
+    for (Approach approach : AllApproaches()) {
+      results.push_back(MeasureExpression(shape, approach, inputs, passes));
+    }
+  }
+  WriteExpressionTable(std::cout, results);
+  std::cout << std::endl;
+}
+
+} // namespace expression_interpreter
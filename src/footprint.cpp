@@ -0,0 +1,348 @@
+#include "footprint.hpp"
+#include "allocation_counter.hpp"
+#include "benchmark_utils.hpp"
+#include "concepts_polymorphism.hpp"
+#include "crtp_polymorphism.hpp"
+#include "runtime_polymorphism.hpp"
+#include "value_polymorphism.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <sys/resource.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace footprint {
+
+namespace {
+
+// Argument for the i-th object, varied so calls can't be folded together
+inline double ArgumentFor(size_t i) {
+  return 1.0 + static_cast<double>(i & 255) / 256.0;
+}
+
+// Both concrete types of a model, stored in separate homogeneous vectors.
+// This is how CRTP and Concepts objects are held: there is no common base
+// type to put in a single container.
+template <typename FMA, typename Expensive>
+struct SplitPopulation {
+  std::vector<FMA> fma;
+  std::vector<Expensive> expensive;
+};
+
+template <typename FMA, typename Expensive>
+SplitPopulation<FMA, Expensive> BuildSplit(size_t population) {
+  SplitPopulation<FMA, Expensive> objects;
+  objects.fma.resize(population / 2);
+  objects.expensive.resize(population - population / 2);
+  return objects;
+}
+
+template <typename FMA, typename Expensive>
+double SweepSplit(const SplitPopulation<FMA, Expensive> &objects) {
+  double sum = 0.0;
+  for (size_t i = 0; i < objects.fma.size(); ++i) {
+    sum += objects.fma[i].Compute(ArgumentFor(i));
+  }
+  for (size_t i = 0; i < objects.expensive.size(); ++i) {
+    sum += objects.expensive[i].Compute(ArgumentFor(i));
+  }
+  return sum;
+}
+
+// Builds the population, times the sweeps and frees it, recording the
+// allocations, RSS growth and page faults in between
+template <typename Build, typename Sweep>
+FootprintResult Measure(
+    const std::string &model,
+    size_t element_size,
+    size_t population,
+    size_t sweeps,
+    Build &&build,
+    Sweep &&sweep
+) {
+#ifdef __GLIBC__
+  // Return memory freed by earlier populations to the OS, otherwise the
+  // next population reuses it without growing the RSS
+  malloc_trim(0);
+#endif
+  ResetPeakRss();
+  MemoryUsage usage_before = ReadMemoryUsage();
+  ScopedAllocationCounting counting;
+  AllocationCounters allocations_before = GetAllocationCounters();
+
+  double elapsed_ns = 0.0;
+  MemoryUsage usage_after{};
+  AllocationCounters allocations_after{};
+  {
+    auto objects = build(population);
+    allocations_after = GetAllocationCounters();
+
+    double sum = 0.0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t s = 0; s < sweeps; ++s) {
+      sum += sweep(objects);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    prevent_optimization = sum;
+    elapsed_ns = std::chrono::duration<double, std::nano>(end - start).count();
+
+    usage_after = ReadMemoryUsage();
+  }
+
+  size_t peak_growth = usage_after.peak_rss_bytes > usage_before.rss_bytes
+                           ? usage_after.peak_rss_bytes - usage_before.rss_bytes
+                           : 0;
+  auto per_object = [population](double total) {
+    return total / static_cast<double>(population);
+  };
+
+  return FootprintResult{
+      model,
+      element_size,
+      per_object(static_cast<double>(
+          allocations_after.bytes_requested - allocations_before.bytes_requested
+      )),
+      per_object(static_cast<double>(peak_growth)),
+      allocations_after.allocations - allocations_before.allocations,
+      peak_growth,
+      usage_after.minor_faults - usage_before.minor_faults,
+      usage_after.major_faults - usage_before.major_faults,
+      elapsed_ns / static_cast<double>(population * sweeps)
+  };
+}
+
+// Reads a "Key:   value kB" line from /proc/self/status
+size_t ReadStatusKilobytes(const std::string &status, const std::string &key) {
+  auto pos = status.find(key + ":");
+  if (pos == std::string::npos) {
+    return 0;
+  }
+  std::istringstream iss(status.substr(pos + key.size() + 1));
+  size_t kilobytes = 0;
+  iss >> kilobytes;
+  return kilobytes;
+}
+
+} // namespace
+
+FootprintOptions &GetFootprintOptions() {
+  static FootprintOptions options;
+  return options;
+}
+
+MemoryUsage ReadMemoryUsage() {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+
+  MemoryUsage result{
+      0,
+      static_cast<size_t>(usage.ru_maxrss) * 1024,
+      static_cast<uint64_t>(usage.ru_minflt),
+      static_cast<uint64_t>(usage.ru_majflt)
+  };
+
+  std::ifstream status_file("/proc/self/status");
+  if (status_file) {
+    std::stringstream buffer;
+    buffer << status_file.rdbuf();
+    std::string status = buffer.str();
+    result.rss_bytes = ReadStatusKilobytes(status, "VmRSS") * 1024;
+    result.peak_rss_bytes = ReadStatusKilobytes(status, "VmHWM") * 1024;
+  }
+  return result;
+}
+
+bool ResetPeakRss() {
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  // "5" resets the peak RSS (Linux 4.0+)
+  return static_cast<bool>(clear_refs << "5" << std::flush);
+}
+
+const std::vector<std::string> &FootprintModels() {
+  static const std::vector<std::string> models = {
+      "runtime",
+      "crtp",
+      "concepts",
+      "variant",
+      "type_erased",
+  };
+  return models;
+}
+
+FootprintResult MeasureFootprint(
+    const std::string &model,
+    size_t population,
+    size_t sweeps
+) {
+  if (model == "runtime") {
+    using runtime_polymorphism::RuntimeBase;
+    using Population = std::vector<std::unique_ptr<RuntimeBase>>;
+    return Measure(
+        model,
+        sizeof(std::unique_ptr<RuntimeBase>),
+        population,
+        sweeps,
+        [](size_t n) {
+          Population objects;
+          objects.reserve(n);
+          for (size_t i = 0; i < n; ++i) {
+            if (i % 2 == 0) {
+              objects.push_back(
+                  std::make_unique<runtime_polymorphism::PolyFMA>()
+              );
+            } else {
+              objects.push_back(
+                  std::make_unique<runtime_polymorphism::PolyExpensive>()
+              );
+            }
+          }
+          return objects;
+        },
+        [](const Population &objects) {
+          double sum = 0.0;
+          for (size_t i = 0; i < objects.size(); ++i) {
+            sum += objects[i]->Compute(ArgumentFor(i));
+          }
+          return sum;
+        }
+    );
+  }
+
+  if (model == "crtp") {
+    using crtp_polymorphism::PolyExpensive;
+    using crtp_polymorphism::PolyFMA;
+    return Measure(
+        model,
+        sizeof(PolyFMA),
+        population,
+        sweeps,
+        BuildSplit<PolyFMA, PolyExpensive>,
+        SweepSplit<PolyFMA, PolyExpensive>
+    );
+  }
+
+  if (model == "concepts") {
+    using PolyExpensive = concepts_polymorphism::InlinePolyExpensive;
+    using PolyFMA = concepts_polymorphism::InlinePolyFMA;
+    return Measure(
+        model,
+        sizeof(PolyFMA),
+        population,
+        sweeps,
+        BuildSplit<PolyFMA, PolyExpensive>,
+        SweepSplit<PolyFMA, PolyExpensive>
+    );
+  }
+
+  if (model == "variant") {
+    using value_polymorphism::PolyVariant;
+    return Measure(
+        model,
+        sizeof(PolyVariant),
+        population,
+        sweeps,
+        [](size_t n) {
+          std::vector<PolyVariant> objects;
+          objects.reserve(n);
+          for (size_t i = 0; i < n; ++i) {
+            if (i % 2 == 0) {
+              objects.emplace_back(crtp_polymorphism::PolyFMA{});
+            } else {
+              objects.emplace_back(crtp_polymorphism::PolyExpensive{});
+            }
+          }
+          return objects;
+        },
+        [](const std::vector<PolyVariant> &objects) {
+          double sum = 0.0;
+          for (size_t i = 0; i < objects.size(); ++i) {
+            sum += value_polymorphism::Compute(objects[i], ArgumentFor(i));
+          }
+          return sum;
+        }
+    );
+  }
+
+  if (model == "type_erased") {
+    using value_polymorphism::PolyAny;
+    return Measure(
+        model,
+        sizeof(PolyAny),
+        population,
+        sweeps,
+        [](size_t n) {
+          std::vector<PolyAny> objects;
+          objects.reserve(n);
+          for (size_t i = 0; i < n; ++i) {
+            if (i % 2 == 0) {
+              objects.emplace_back(concepts_polymorphism::InlinePolyFMA{});
+            } else {
+              objects.emplace_back(
+                  concepts_polymorphism::InlinePolyExpensive{}
+              );
+            }
+          }
+          return objects;
+        },
+        [](const std::vector<PolyAny> &objects) {
+          double sum = 0.0;
+          for (size_t i = 0; i < objects.size(); ++i) {
+            sum += objects[i].Compute(ArgumentFor(i));
+          }
+          return sum;
+        }
+    );
+  }
+
+  throw std::invalid_argument("Invalid footprint model: " + model);
+}
+
+void WriteFootprintTable(
+    std::ostream &out,
+    const std::vector<FootprintResult> &results
+) {
+  constexpr double kMiB = 1024.0 * 1024.0;
+  out << "| Model | sizeof (B) | Requested (B/obj) | Resident (B/obj) "
+         "| Allocations | Peak RSS Growth (MiB) | Minor Faults "
+         "| Major Faults | Time (ns/call) |\n";
+  out << "|-------|------|------|------|------|------|------|------|------|\n";
+  for (const auto &result : results) {
+    out << "| " << result.model << " | " << result.element_size << " | "
+        << std::fixed << std::setprecision(2)
+        << result.requested_bytes_per_object << " | "
+        << result.resident_bytes_per_object << " | " << result.allocations
+        << " | " << static_cast<double>(result.peak_rss_growth_bytes) / kMiB
+        << " | " << result.minor_faults << " | " << result.major_faults
+        << " | " << result.ns_per_call << " |\n";
+    out.unsetf(std::ios::fixed);
+  }
+}
+
+void RunFootprintBenchmark(size_t iterations) {
+  size_t population = GetFootprintOptions().population;
+  size_t sweeps = std::max(iterations / population, size_t{1});
+
+  std::cout << "Population: " << population << " objects (half FMA, half "
+            << "Expensive), Sweeps: " << sweeps << "\n";
+  if (!ResetPeakRss()) {
+    std::cout << "Note: peak RSS can't be reset on this system, so it is a "
+                 "process-wide high-water mark\n";
+  }
+  std::cout << "\n";
+
+  std::vector<FootprintResult> results;
+  for (const auto &model : FootprintModels()) {
+    results.push_back(MeasureFootprint(model, population, sweeps));
+  }
+  WriteFootprintTable(std::cout, results);
+  std::cout << std::endl;
+}
+
+} // namespace footprint
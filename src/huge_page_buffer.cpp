@@ -0,0 +1,133 @@
+#include "huge_page_buffer.hpp"
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <utility>
+
+namespace {
+
+size_t RoundUpToHugePage(size_t num_bytes) {
+  return (num_bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+}
+
+// Maps `length` bytes aligned to kHugePageSize by over-mapping one huge page
+// and trimming the unaligned head and tail.
+void *MapAligned(size_t length) {
+  size_t padded_length = length + kHugePageSize;
+  void *raw = mmap(
+      nullptr,
+      padded_length,
+      PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS,
+      -1,
+      0
+  );
+  if (raw == MAP_FAILED) {
+    return nullptr;
+  }
+
+  auto raw_address = reinterpret_cast<uintptr_t>(raw);
+  uintptr_t aligned_address =
+      (raw_address + kHugePageSize - 1) & ~(kHugePageSize - 1);
+  size_t head = aligned_address - raw_address;
+  size_t tail = padded_length - head - length;
+  if (head > 0) {
+    munmap(raw, head);
+  }
+  if (tail > 0) {
+    munmap(reinterpret_cast<void *>(aligned_address + length), tail);
+  }
+  return reinterpret_cast<void *>(aligned_address);
+}
+
+void *MapExplicitHugePages(size_t length) {
+  void *ptr = mmap(
+      nullptr,
+      length,
+      PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+      -1,
+      0
+  );
+  return ptr == MAP_FAILED ? nullptr : ptr;
+}
+
+} // namespace
+
+std::optional<HugePageMode> ParseHugePageMode(const std::string &name) {
+  if (name == "none") {
+    return HugePageMode::kNone;
+  }
+  if (name == "thp") {
+    return HugePageMode::kTransparent;
+  }
+  if (name == "explicit") {
+    return HugePageMode::kExplicit;
+  }
+  return std::nullopt;
+}
+
+std::string HugePageModeName(HugePageMode mode) {
+  switch (mode) {
+  case HugePageMode::kNone:
+    return "none";
+  case HugePageMode::kTransparent:
+    return "thp";
+  case HugePageMode::kExplicit:
+    return "explicit";
+  }
+  return "unknown";
+}
+
+HugePageBuffer::HugePageBuffer(size_t num_bytes, HugePageMode mode)
+    : num_bytes_(num_bytes), mapped_bytes_(RoundUpToHugePage(num_bytes)),
+      mode_(mode) {
+  if (mode_ == HugePageMode::kExplicit) {
+    data_ = MapExplicitHugePages(mapped_bytes_);
+    if (data_ == nullptr) {
+      std::cerr << "Warning: explicit huge pages unavailable "
+                   "(check vm.nr_hugepages), using transparent huge pages"
+                << std::endl;
+      mode_ = HugePageMode::kTransparent;
+    }
+  }
+
+  if (data_ == nullptr) {
+    data_ = MapAligned(mapped_bytes_);
+    if (data_ == nullptr) {
+      throw std::runtime_error(
+          "Unable to map " + std::to_string(mapped_bytes_) + " bytes"
+      );
+    }
+    int advice = mode_ == HugePageMode::kTransparent ? MADV_HUGEPAGE
+                                                     : MADV_NOHUGEPAGE;
+    madvise(data_, mapped_bytes_, advice);
+  }
+}
+
+HugePageBuffer::~HugePageBuffer() { Release(); }
+
+HugePageBuffer::HugePageBuffer(HugePageBuffer &&other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      num_bytes_(std::exchange(other.num_bytes_, 0)),
+      mapped_bytes_(std::exchange(other.mapped_bytes_, 0)),
+      mode_(other.mode_) {}
+
+HugePageBuffer &HugePageBuffer::operator=(HugePageBuffer &&other) noexcept {
+  if (this != &other) {
+    Release();
+    data_ = std::exchange(other.data_, nullptr);
+    num_bytes_ = std::exchange(other.num_bytes_, 0);
+    mapped_bytes_ = std::exchange(other.mapped_bytes_, 0);
+    mode_ = other.mode_;
+  }
+  return *this;
+}
+
+void HugePageBuffer::Release() {
+  if (data_ != nullptr) {
+    munmap(data_, mapped_bytes_);
+    data_ = nullptr;
+  }
+}
@@ -0,0 +1,288 @@
+#include "intensity_sweep.hpp"
+#include "benchmark_utils.hpp"
+#include "polymorphism_tests.hpp"
+#include "value_polymorphism.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <variant>
+
+namespace intensity_sweep {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Each measurement keeps the fastest of this many runs, which filters out
+// interference that would otherwise show up as negative overhead
+constexpr int kRepetitions = 3;
+
+// Forces the object to be reloaded from memory, so the variant index or the
+// type-erased ops pointer isn't known at compile time
+template <typename T>
+void HideFromOptimizer(T &object) {
+#if defined(__GNUC__)
+  asm volatile("" : : "r"(&object) : "memory");
+#else
+  (void)object;
+#endif
+}
+
+template <size_t K>
+std::string ChainLabel(const std::string &model) {
+  return "Chain<" + std::to_string(K) + "> " + model;
+}
+
+template <size_t K>
+void TestVariantChain(size_t iterations) {
+  using ChainVariant = std::variant<
+      crtp_polymorphism::PolyFMA,
+      crtp_polymorphism::PolyChain<K>>;
+  ChainVariant object(std::in_place_index<1>);
+  HideFromOptimizer(object);
+  RunBenchmark(ChainLabel<K>("Variant"), iterations, [&](double x) {
+    return std::visit(
+        [x](const auto &held) { return held.Compute(x); },
+        object
+    );
+  });
+}
+
+template <size_t K>
+void TestTypeErasedChain(size_t iterations) {
+  value_polymorphism::PolyAny object(crtp_polymorphism::PolyChain<K>{});
+  HideFromOptimizer(object);
+  RunBenchmark(ChainLabel<K>("Type Erased"), iterations, [&](double x) {
+    return object.Compute(x);
+  });
+}
+
+using ChainTests = std::array<void (*)(size_t), kChainLengths.size()>;
+
+// Test function for every chain length, indexed like kChainLengths
+template <template <size_t> class Test>
+constexpr ChainTests MakeChainTests() {
+  return [&]<size_t... Is>(std::index_sequence<Is...>) {
+    return ChainTests{&Test<kChainLengths[Is]>::Run...};
+  }(std::make_index_sequence<kChainLengths.size()>{});
+}
+
+// Wrappers so the test function templates can be passed as template template
+// arguments
+template <size_t K>
+struct RuntimeChain {
+  static void Run(size_t n) { polymorphism_tests::TestRuntimeChain<K>(n); }
+};
+template <size_t K>
+struct CRTPChain {
+  static void Run(size_t n) { polymorphism_tests::TestCRTPChain<K>(n); }
+};
+template <size_t K>
+struct ConceptsChain {
+  static void Run(size_t n) { polymorphism_tests::TestConceptsChain<K>(n); }
+};
+template <size_t K>
+struct VariantChain {
+  static void Run(size_t n) { TestVariantChain<K>(n); }
+};
+template <size_t K>
+struct TypeErasedChain {
+  static void Run(size_t n) { TestTypeErasedChain<K>(n); }
+};
+
+const ChainTests &ChainTestsFor(const std::string &model) {
+  static constexpr ChainTests kRuntime = MakeChainTests<RuntimeChain>();
+  static constexpr ChainTests kCRTP = MakeChainTests<CRTPChain>();
+  static constexpr ChainTests kConcepts = MakeChainTests<ConceptsChain>();
+  static constexpr ChainTests kVariant = MakeChainTests<VariantChain>();
+  static constexpr ChainTests kTypeErased =
+      MakeChainTests<TypeErasedChain>();
+
+  if (model == "runtime") {
+    return kRuntime;
+  }
+  if (model == "crtp") {
+    return kCRTP;
+  }
+  if (model == "concepts") {
+    return kConcepts;
+  }
+  if (model == "variant") {
+    return kVariant;
+  }
+  if (model == "type_erased") {
+    return kTypeErased;
+  }
+  throw std::invalid_argument("Unknown dispatch model: " + model);
+}
+
+const SweepResult *FindResult(
+    const std::vector<SweepResult> &results,
+    const std::string &model,
+    size_t chain_length
+) {
+  auto it = std::find_if(
+      results.begin(),
+      results.end(),
+      [&](const SweepResult &result) {
+        return result.model == model && result.chain_length == chain_length;
+      }
+  );
+  return it != results.end() ? &*it : nullptr;
+}
+
+} // namespace
+
+const std::vector<std::string> &SweepModels() {
+  static const std::vector<std::string> models = {
+      "runtime",
+      "crtp",
+      "concepts",
+      "variant",
+      "type_erased",
+  };
+  return models;
+}
+
+SweepResult
+MeasureChain(const std::string &model, size_t chain_length, size_t calls) {
+  TRACE_SCOPE("MeasureChain");
+  const ChainTests &tests = ChainTestsFor(model);
+  auto length_it =
+      std::find(kChainLengths.begin(), kChainLengths.end(), chain_length);
+  if (length_it == kChainLengths.end()) {
+    throw std::invalid_argument(
+        "Chain length " + std::to_string(chain_length) + " isn't compiled in"
+    );
+  }
+  auto test = tests[length_it - kChainLengths.begin()];
+
+  BenchmarkSink &sink = GetThreadBenchmarkSink();
+  bool print_time = sink.print_time;
+  sink.print_time = false;
+  double fastest_ns = std::numeric_limits<double>::max();
+  for (int repetition = 0; repetition < kRepetitions; ++repetition) {
+    auto start = Clock::now();
+    test(calls);
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    fastest_ns = std::min(fastest_ns, elapsed.count());
+  }
+  sink.print_time = print_time;
+
+  return {model, chain_length, calls, fastest_ns / calls};
+}
+
+std::optional<double> RelativeOverhead(
+    const std::vector<SweepResult> &results,
+    const SweepResult &result
+) {
+  const SweepResult *reference =
+      FindResult(results, kReferenceModel, result.chain_length);
+  if (reference == nullptr) {
+    return std::nullopt;
+  }
+  return (result.ns_per_call - reference->ns_per_call) /
+         reference->ns_per_call;
+}
+
+std::optional<size_t> CrossoverChainLength(
+    const std::vector<SweepResult> &results,
+    const std::string &model,
+    double threshold
+) {
+  // Walk from the longest chain down while the overhead stays below
+  std::optional<size_t> crossover;
+  for (auto it = kChainLengths.rbegin(); it != kChainLengths.rend(); ++it) {
+    const SweepResult *result = FindResult(results, model, *it);
+    if (result == nullptr) {
+      continue;
+    }
+    auto overhead = RelativeOverhead(results, *result);
+    if (!overhead || *overhead >= threshold) {
+      break;
+    }
+    crossover = *it;
+  }
+  return crossover;
+}
+
+void WriteSweepTable(
+    std::ostream &out,
+    const std::vector<SweepResult> &results
+) {
+  out << "| FMAs per Call | Model | Time (ns/call) | Overhead vs "
+      << kReferenceModel << " (%) |\n";
+  out << "|------|-------|------|------|\n";
+  for (const auto &result : results) {
+    out << "| " << result.chain_length << " | " << result.model << " | "
+        << std::fixed << std::setprecision(2) << result.ns_per_call << " | ";
+    if (auto overhead = RelativeOverhead(results, result)) {
+      out << *overhead * 100;
+    } else {
+      out << "n/a";
+    }
+    out << " |\n";
+    out.unsetf(std::ios::fixed);
+  }
+}
+
+void WriteCrossoverReport(
+    std::ostream &out,
+    const std::vector<SweepResult> &results
+) {
+  out << "| Model |";
+  for (double threshold : kCrossoverThresholds) {
+    out << " Overhead < " << threshold * 100 << "% from |";
+  }
+  out << "\n|-------|";
+  for (size_t i = 0; i < std::size(kCrossoverThresholds); ++i) {
+    out << "------|";
+  }
+  out << "\n";
+
+  for (const auto &model : SweepModels()) {
+    if (model == kReferenceModel) {
+      continue;
+    }
+    out << "| " << model << " |";
+    for (double threshold : kCrossoverThresholds) {
+      auto length = CrossoverChainLength(results, model, threshold);
+      if (!length) {
+        out << " not reached |";
+        continue;
+      }
+      const SweepResult *reference =
+          FindResult(results, kReferenceModel, *length);
+      out << " " << *length << " FMAs (" << std::fixed
+          << std::setprecision(2) << reference->ns_per_call << " ns) |";
+      out.unsetf(std::ios::fixed);
+    }
+    out << "\n";
+  }
+}
+
+void RunIntensitySweepBenchmark(size_t iterations) {
+  std::cout << "FMAs per chain length: " << iterations
+            << " (iterations / K calls of ComputeChain<K>)\n\n";
+
+  std::vector<SweepResult> results;
+  for (size_t chain_length : kChainLengths) {
+    size_t calls = std::max(iterations / chain_length, size_t{1});
+    for (const auto &model : SweepModels()) {
+      results.push_back(MeasureChain(model, chain_length, calls));
+    }
+  }
+  WriteSweepTable(std::cout, results);
+  std::cout << "\nCrossover (work per call from which dispatch overhead "
+               "stays below each level, "
+            << kReferenceModel << " time in brackets):\n\n";
+  WriteCrossoverReport(std::cout, results);
+  std::cout << std::endl;
+}
+
+} // namespace intensity_sweep
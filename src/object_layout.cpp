@@ -0,0 +1,501 @@
+#include "object_layout.hpp"
+#include "benchmark_utils.hpp"
+#include "concepts_polymorphism.hpp"
+#include "crtp_polymorphism.hpp"
+#include "perf_counters.hpp"
+#include "runtime_polymorphism.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <numeric>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <utility>
+
+namespace object_layout {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Fixed so every model and layout visits its objects in the same order
+constexpr uint64_t kShuffleSeed = 42;
+
+constexpr size_t kPlacementCount = 3;
+
+// Argument for the i-th call, varied so calls can't be folded together
+inline double ArgumentFor(size_t i) {
+  return 1.0 + static_cast<double>(i & 255) / 256.0;
+}
+
+template <size_t P>
+struct ColdPayload {
+  std::array<unsigned char, P> bytes{};
+};
+
+// An object's state, in declaration order. Compute only reads `hot`.
+template <size_t P, Placement L>
+struct Fields;
+
+template <size_t P>
+struct Fields<P, Placement::kHotFirst> {
+  double hot = 1.0;
+  ColdPayload<P> cold;
+};
+
+template <size_t P>
+struct Fields<P, Placement::kHotLast> {
+  ColdPayload<P> cold;
+  double hot = 1.0;
+};
+
+template <size_t P>
+struct Fields<P, Placement::kSplit> {
+  double hot = 1.0;
+  ColdPayload<P> *cold = nullptr; // into a side array
+};
+
+// Two cheap kernels, so that memory rather than arithmetic sets the time
+struct FMAKernel {
+  static double Apply(double x) { return ComputeFMA(x); }
+};
+
+struct ChainKernel {
+  static double Apply(double x) { return ComputeChain<4>(x); }
+};
+
+// The vptr comes first, then the fields
+template <typename Kernel, size_t P, size_t A, Placement L>
+class alignas(A) RuntimeObject final
+    : public runtime_polymorphism::RuntimeBase {
+public:
+  double Compute(double x) const override {
+    return Kernel::Apply(x) * fields_.hot;
+  }
+
+  Fields<P, L> fields_;
+};
+
+template <typename Kernel, size_t P, size_t A, Placement L>
+class alignas(A) CRTPObject
+    : public crtp_polymorphism::CRTPBase<CRTPObject<Kernel, P, A, L>> {
+public:
+  double ComputeImpl(double x) const {
+    return Kernel::Apply(x) * fields_.hot;
+  }
+
+  Fields<P, L> fields_;
+};
+
+template <typename Kernel, size_t P, size_t A, Placement L>
+class alignas(A) ConceptObject {
+public:
+  double Compute(double x) const { return Kernel::Apply(x) * fields_.hot; }
+
+  Fields<P, L> fields_;
+};
+
+template <typename Object>
+size_t HotOffset(const Object &object) {
+  return static_cast<size_t>(
+      reinterpret_cast<const char *>(&object.fields_.hot) -
+      reinterpret_cast<const char *>(&object)
+  );
+}
+
+template <size_t P, Placement L>
+void AttachCold(
+    Fields<P, L> &fields,
+    std::vector<ColdPayload<P>> &cold,
+    size_t i
+) {
+  if constexpr (L == Placement::kSplit) {
+    fields.cold = &cold[i];
+  }
+}
+
+std::vector<uint32_t> VisitOrder(size_t count, Order order) {
+  std::vector<uint32_t> indices(count);
+  std::iota(indices.begin(), indices.end(), 0);
+  if (order == Order::kShuffled) {
+    std::mt19937_64 generator(kShuffleSeed);
+    std::shuffle(indices.begin(), indices.end(), generator);
+  }
+  return indices;
+}
+
+// Both runtime types in one contiguous array, alternating, so that layout
+// rather than the allocator decides where each object sits
+template <typename FMAObject, typename ChainObject>
+class RuntimeArena {
+  static_assert(sizeof(FMAObject) == sizeof(ChainObject));
+  static_assert(alignof(FMAObject) == alignof(ChainObject));
+
+  struct alignas(alignof(FMAObject)) Slot {
+    unsigned char bytes[sizeof(FMAObject)];
+  };
+
+public:
+  explicit RuntimeArena(size_t population) : slots_(population) {
+    objects_.reserve(population);
+    for (size_t i = 0; i < population; ++i) {
+      if (i % 2 == 0) {
+        objects_.push_back(new (&slots_[i]) FMAObject);
+      } else {
+        objects_.push_back(new (&slots_[i]) ChainObject);
+      }
+    }
+  }
+
+  ~RuntimeArena() {
+    for (auto *object : objects_) {
+      object->~RuntimeBase();
+    }
+  }
+
+  RuntimeArena(const RuntimeArena &) = delete;
+  RuntimeArena &operator=(const RuntimeArena &) = delete;
+
+  template <typename Object>
+  Object &at(size_t i) {
+    return *static_cast<Object *>(objects_[i]);
+  }
+
+  const runtime_polymorphism::RuntimeBase *base(size_t i) const {
+    return objects_[i];
+  }
+
+private:
+  std::vector<Slot> slots_;
+  std::vector<runtime_polymorphism::RuntimeBase *> objects_;
+};
+
+template <concepts_polymorphism::Computable Object>
+double SweepObjects(
+    const std::vector<Object> &objects,
+    const std::vector<uint32_t> &order
+) {
+  double sum = 0.0;
+  for (size_t i = 0; i < order.size(); ++i) {
+    sum += objects[order[i]].Compute(ArgumentFor(i));
+  }
+  return sum;
+}
+
+// One untimed sweep to settle caches and TLBs, then `sweeps` timed sweeps
+// with the counters running. Fills in the timing and miss fields.
+template <typename Sweep>
+void TimeSweeps(
+    size_t sweeps,
+    size_t population,
+    Sweep &&sweep,
+    LayoutResult &result
+) {
+  prevent_optimization = sweep();
+
+  PerfCounters counters;
+  double sum = 0.0;
+  counters.Start();
+  auto start = Clock::now();
+  for (size_t s = 0; s < sweeps; ++s) {
+    sum += sweep();
+  }
+  std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+  counters.Stop();
+  prevent_optimization = sum;
+
+  result.calls = sweeps * population;
+  double calls = static_cast<double>(result.calls);
+  result.ns_per_call = elapsed.count() / calls;
+  for (const auto &reading : counters.Read()) {
+    if (reading.name == "cache-misses") {
+      result.cache_misses_per_call =
+          static_cast<double>(reading.value) / calls;
+    }
+  }
+}
+
+template <size_t P, size_t A, Placement L>
+LayoutResult MeasureRuntime(
+    const LayoutConfig &config,
+    size_t population,
+    size_t sweeps
+) {
+  using FMAObject = RuntimeObject<FMAKernel, P, A, L>;
+  using ChainObject = RuntimeObject<ChainKernel, P, A, L>;
+
+  RuntimeArena<FMAObject, ChainObject> arena(population);
+  std::vector<ColdPayload<P>> cold(L == Placement::kSplit ? population : 0);
+  size_t hot_offset = HotOffset(arena.template at<FMAObject>(0));
+  double lines = 0.0;
+  for (size_t i = 0; i < population; ++i) {
+    if (i % 2 == 0) {
+      AttachCold(arena.template at<FMAObject>(i).fields_, cold, i);
+    } else {
+      AttachCold(arena.template at<ChainObject>(i).fields_, cold, i);
+    }
+    lines += static_cast<double>(LinesTouched(
+        reinterpret_cast<uintptr_t>(arena.base(i)),
+        {0, hot_offset} // vptr and hot field
+    ));
+  }
+
+  std::vector<const runtime_polymorphism::RuntimeBase *> objects;
+  objects.reserve(population);
+  for (uint32_t i : VisitOrder(population, config.order)) {
+    objects.push_back(arena.base(i));
+  }
+
+  LayoutResult result{config, sizeof(FMAObject), hot_offset, 0.0, 0, 0.0, {}};
+  result.lines_per_call = lines / static_cast<double>(population);
+  TimeSweeps(
+      sweeps,
+      population,
+      [&objects] {
+        double sum = 0.0;
+        for (size_t i = 0; i < objects.size(); ++i) {
+          sum += objects[i]->Compute(ArgumentFor(i));
+        }
+        return sum;
+      },
+      result
+  );
+  return result;
+}
+
+// CRTP and Concepts objects have no common base, so each type gets its own
+// array (as in the footprint scenario)
+template <typename FMAObject, typename ChainObject, size_t P, Placement L>
+LayoutResult MeasureStatic(
+    const LayoutConfig &config,
+    size_t population,
+    size_t sweeps
+) {
+  std::vector<FMAObject> fma(population / 2);
+  std::vector<ChainObject> chain(population - population / 2);
+  std::vector<ColdPayload<P>> cold(L == Placement::kSplit ? population : 0);
+
+  size_t hot_offset = HotOffset(fma.front());
+  double lines = 0.0;
+  for (size_t i = 0; i < fma.size(); ++i) {
+    AttachCold(fma[i].fields_, cold, i);
+    lines += static_cast<double>(
+        LinesTouched(reinterpret_cast<uintptr_t>(&fma[i]), {hot_offset})
+    );
+  }
+  for (size_t i = 0; i < chain.size(); ++i) {
+    AttachCold(chain[i].fields_, cold, fma.size() + i);
+    lines += static_cast<double>(
+        LinesTouched(reinterpret_cast<uintptr_t>(&chain[i]), {hot_offset})
+    );
+  }
+
+  std::vector<uint32_t> fma_order = VisitOrder(fma.size(), config.order);
+  std::vector<uint32_t> chain_order = VisitOrder(chain.size(), config.order);
+
+  LayoutResult result{config, sizeof(FMAObject), hot_offset, 0.0, 0, 0.0, {}};
+  result.lines_per_call = lines / static_cast<double>(population);
+  TimeSweeps(
+      sweeps,
+      population,
+      [&] {
+        return SweepObjects(fma, fma_order) + SweepObjects(chain, chain_order);
+      },
+      result
+  );
+  return result;
+}
+
+template <size_t P, size_t A, Placement L>
+LayoutResult MeasureVariant(
+    const LayoutConfig &config,
+    size_t population,
+    size_t sweeps
+) {
+  if (config.model == "runtime") {
+    return MeasureRuntime<P, A, L>(config, population, sweeps);
+  }
+  if (config.model == "crtp") {
+    return MeasureStatic<
+        CRTPObject<FMAKernel, P, A, L>,
+        CRTPObject<ChainKernel, P, A, L>,
+        P,
+        L>(config, population, sweeps);
+  }
+  if (config.model == "concepts") {
+    return MeasureStatic<
+        ConceptObject<FMAKernel, P, A, L>,
+        ConceptObject<ChainKernel, P, A, L>,
+        P,
+        L>(config, population, sweeps);
+  }
+  throw std::invalid_argument("Unknown layout model: " + config.model);
+}
+
+using MeasureFunction = LayoutResult (*)(const LayoutConfig &, size_t, size_t);
+
+constexpr size_t kVariantCount =
+    kPayloadSizes.size() * kAlignments.size() * kPlacementCount;
+
+// MeasureVariant for every payload, alignment and placement, indexed by
+// (payload index * alignments + alignment index) * placements + placement
+constexpr std::array<MeasureFunction, kVariantCount> MakeMeasureTable() {
+  return []<size_t... Is>(std::index_sequence<Is...>) {
+    return std::array<MeasureFunction, kVariantCount>{&MeasureVariant<
+        kPayloadSizes[Is / (kAlignments.size() * kPlacementCount)],
+        kAlignments[Is / kPlacementCount % kAlignments.size()],
+        static_cast<Placement>(Is % kPlacementCount)>...};
+  }(std::make_index_sequence<kVariantCount>{});
+}
+
+template <size_t N>
+std::optional<size_t>
+IndexOf(const std::array<size_t, N> &values, size_t value) {
+  auto it = std::find(values.begin(), values.end(), value);
+  if (it == values.end()) {
+    return std::nullopt;
+  }
+  return static_cast<size_t>(it - values.begin());
+}
+
+} // namespace
+
+std::string PlacementName(Placement placement) {
+  switch (placement) {
+  case Placement::kHotFirst:
+    return "hot first";
+  case Placement::kHotLast:
+    return "hot last";
+  case Placement::kSplit:
+    return "hot/cold split";
+  }
+  return "unknown";
+}
+
+std::string OrderName(Order order) {
+  return order == Order::kSequential ? "sequential" : "shuffled";
+}
+
+const std::vector<Placement> &AllPlacements() {
+  static const std::vector<Placement> placements = {
+      Placement::kHotFirst,
+      Placement::kHotLast,
+      Placement::kSplit,
+  };
+  return placements;
+}
+
+const std::vector<std::string> &LayoutModels() {
+  static const std::vector<std::string> models = {
+      "runtime",
+      "crtp",
+      "concepts",
+  };
+  return models;
+}
+
+size_t
+LinesTouched(uintptr_t address, const std::vector<size_t> &field_offsets) {
+  std::set<uintptr_t> lines;
+  for (size_t offset : field_offsets) {
+    uintptr_t first = address + offset;
+    lines.insert(first / kCacheLineSize);
+    lines.insert((first + sizeof(double) - 1) / kCacheLineSize);
+  }
+  return lines.size();
+}
+
+LayoutResult MeasureLayout(
+    const LayoutConfig &config,
+    size_t population,
+    size_t calls
+) {
+  TRACE_SCOPE("MeasureLayout");
+  static constexpr auto kMeasure = MakeMeasureTable();
+
+  auto payload = IndexOf(kPayloadSizes, config.payload);
+  auto alignment = IndexOf(kAlignments, config.alignment);
+  if (!payload || !alignment) {
+    throw std::invalid_argument(
+        "No layout with a " + std::to_string(config.payload) +
+        " byte payload and alignas(" + std::to_string(config.alignment) + ")"
+    );
+  }
+  if (population < 2) {
+    throw std::invalid_argument("A layout population needs two objects");
+  }
+  size_t index =
+      (*payload * kAlignments.size() + *alignment) * kPlacementCount +
+      static_cast<size_t>(config.placement);
+  size_t sweeps = std::max((calls + population - 1) / population, size_t{1});
+  return kMeasure[index](config, population, sweeps);
+}
+
+void WriteLayoutTable(
+    std::ostream &out,
+    const std::vector<LayoutResult> &results
+) {
+  out << "| Order | Payload (B) | alignas | Placement | Model | sizeof (B) | "
+         "Hot Offset (B) | Lines/Call | LLC Misses/Call | Time (ns/call) |\n";
+  out << "|-------|------|------|------|-------|------|------|------|------|"
+         "------|\n";
+  for (const auto &result : results) {
+    const LayoutConfig &config = result.config;
+    out << "| " << OrderName(config.order) << " | " << config.payload << " | "
+        << config.alignment << " | " << PlacementName(config.placement)
+        << " | " << config.model << " | " << result.object_size << " | "
+        << result.hot_offset << " | " << std::fixed << std::setprecision(2)
+        << result.lines_per_call << " | ";
+    if (result.cache_misses_per_call) {
+      out << *result.cache_misses_per_call;
+    } else {
+      out << "n/a";
+    }
+    out << " | " << result.ns_per_call << " |\n";
+    out.unsetf(std::ios::fixed);
+  }
+}
+
+void RunObjectLayoutBenchmark(size_t iterations) {
+  constexpr Order kOrders[] = {Order::kSequential, Order::kShuffled};
+  size_t population = kDefaultLayoutPopulation;
+  size_t cells = std::size(kOrders) * kVariantCount * LayoutModels().size();
+  size_t calls = std::max(iterations / cells, population);
+
+  std::cout << "Population: " << population << " objects (half FMA, half "
+            << "Chain<4>), " << calls << " calls per row\n";
+  if (!PerfCounters().available()) {
+    std::cout << "Note: perf events aren't available, so LLC misses are "
+                 "n/a; Lines/Call still shows the layout effect\n";
+  }
+  std::cout << "\n";
+
+  std::vector<LayoutResult> results;
+  for (Order order : kOrders) {
+    for (size_t payload : kPayloadSizes) {
+      for (size_t alignment : kAlignments) {
+        for (Placement placement : AllPlacements()) {
+          for (const auto &model : LayoutModels()) {
+            results.push_back(MeasureLayout(
+                {model, payload, alignment, placement, order},
+                population,
+                calls
+            ));
+          }
+        }
+      }
+    }
+  }
+  WriteLayoutTable(std::cout, results);
+  std::cout << "\nLines/Call counts the distinct cache lines holding what a "
+               "call reads: the vptr (runtime only) and the hot field. "
+               "Hot-last layouts push the hot field away from the vptr, "
+               "natural alignment lets objects straddle lines, and the "
+               "hot/cold split keeps the stride small.\n"
+            << std::endl;
+}
+
+} // namespace object_layout
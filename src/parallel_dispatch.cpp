@@ -0,0 +1,389 @@
+#include "parallel_dispatch.hpp"
+#include "benchmark_utils.hpp"
+#include "concepts_polymorphism.hpp"
+#include "crtp_polymorphism.hpp"
+#include "runtime_polymorphism.hpp"
+#include "value_polymorphism.hpp"
+#include <algorithm>
+#include <chrono>
+#include <execution>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#ifdef HAVE_TBB
+#include <tbb/global_control.h>
+#endif
+
+namespace parallel_dispatch {
+
+namespace {
+
+// Argument for the i-th object, varied so calls can't be folded together
+inline double ArgumentFor(size_t i) {
+  return 1.0 + static_cast<double>(i & 255) / 256.0;
+}
+
+// Each population evaluates a half-open index range and returns the sum
+
+class RuntimePopulation {
+public:
+  explicit RuntimePopulation(const std::vector<uint8_t> &expensive_mask) {
+    objects_.reserve(expensive_mask.size());
+    for (uint8_t expensive : expensive_mask) {
+      if (expensive) {
+        objects_.push_back(
+            std::make_unique<runtime_polymorphism::PolyExpensive>()
+        );
+      } else {
+        objects_.push_back(std::make_unique<runtime_polymorphism::PolyFMA>());
+      }
+    }
+  }
+
+  double Evaluate(size_t begin, size_t end) const {
+    double sum = 0.0;
+    for (size_t i = begin; i < end; ++i) {
+      sum += objects_[i]->Compute(ArgumentFor(i));
+    }
+    return sum;
+  }
+
+  size_t size() const { return objects_.size(); }
+
+private:
+  std::vector<std::unique_ptr<runtime_polymorphism::RuntimeBase>> objects_;
+};
+
+// CRTP and Concepts types share no base, so a mixed collection stores a
+// type tag per item and branches to the statically known type
+template <typename FMA, typename Expensive>
+class TaggedPopulation {
+public:
+  explicit TaggedPopulation(const std::vector<uint8_t> &expensive_mask)
+      : tags_(expensive_mask) {}
+
+  double Evaluate(size_t begin, size_t end) const {
+    double sum = 0.0;
+    for (size_t i = begin; i < end; ++i) {
+      sum += tags_[i] ? expensive_.Compute(ArgumentFor(i))
+                      : fma_.Compute(ArgumentFor(i));
+    }
+    return sum;
+  }
+
+  size_t size() const { return tags_.size(); }
+
+private:
+  std::vector<uint8_t> tags_;
+  FMA fma_;
+  Expensive expensive_;
+};
+
+class VariantPopulation {
+public:
+  explicit VariantPopulation(const std::vector<uint8_t> &expensive_mask) {
+    objects_.reserve(expensive_mask.size());
+    for (uint8_t expensive : expensive_mask) {
+      if (expensive) {
+        objects_.emplace_back(crtp_polymorphism::PolyExpensive{});
+      } else {
+        objects_.emplace_back(crtp_polymorphism::PolyFMA{});
+      }
+    }
+  }
+
+  double Evaluate(size_t begin, size_t end) const {
+    double sum = 0.0;
+    for (size_t i = begin; i < end; ++i) {
+      sum += value_polymorphism::Compute(objects_[i], ArgumentFor(i));
+    }
+    return sum;
+  }
+
+  size_t size() const { return objects_.size(); }
+
+private:
+  std::vector<value_polymorphism::PolyVariant> objects_;
+};
+
+class TypeErasedPopulation {
+public:
+  explicit TypeErasedPopulation(const std::vector<uint8_t> &expensive_mask) {
+    objects_.reserve(expensive_mask.size());
+    for (uint8_t expensive : expensive_mask) {
+      if (expensive) {
+        objects_.emplace_back(concepts_polymorphism::InlinePolyExpensive{});
+      } else {
+        objects_.emplace_back(concepts_polymorphism::InlinePolyFMA{});
+      }
+    }
+  }
+
+  double Evaluate(size_t begin, size_t end) const {
+    double sum = 0.0;
+    for (size_t i = begin; i < end; ++i) {
+      sum += objects_[i].Compute(ArgumentFor(i));
+    }
+    return sum;
+  }
+
+  size_t size() const { return objects_.size(); }
+
+private:
+  std::vector<value_polymorphism::PolyAny> objects_;
+};
+
+template <typename Population>
+ParallelResult Measure(
+    const std::string &model,
+    const Population &population,
+    Executor executor,
+    WorkStealingPool &pool,
+    size_t passes
+) {
+  size_t n = population.size();
+  size_t threads = pool.num_threads();
+  ParallelResult result{model, executor, threads, 0.0, 0.0, 0.0, 0, 0.0};
+  double wall_ns = 0.0;
+  double sum = 0.0;
+
+  if (executor == Executor::kStdPar) {
+    // The pool pins this thread to CPU 0; TBB's workers, created on first
+    // use, would inherit that and all share one CPU
+    ScopedProcessAffinity unpinned;
+#ifdef HAVE_TBB
+    tbb::global_control limit(
+        tbb::global_control::max_allowed_parallelism,
+        threads
+    );
+#endif
+    // One element per chunk, so per-call scheduling overhead matches the
+    // pool's
+    std::vector<size_t> chunk_begins((n + kDefaultChunkSize - 1) /
+                                     kDefaultChunkSize);
+    for (size_t c = 0; c < chunk_begins.size(); ++c) {
+      chunk_begins[c] = c * kDefaultChunkSize;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t pass = 0; pass < passes; ++pass) {
+      sum += std::transform_reduce(
+          std::execution::par,
+          chunk_begins.begin(),
+          chunk_begins.end(),
+          0.0,
+          std::plus<>(),
+          [&population, n](size_t begin) {
+            return population.Evaluate(
+                begin,
+                std::min(begin + kDefaultChunkSize, n)
+            );
+          }
+      );
+    }
+    wall_ns = std::chrono::duration<double, std::nano>(
+                  std::chrono::steady_clock::now() - start
+    )
+                  .count();
+  } else {
+    Schedule schedule = executor == Executor::kStatic ? Schedule::kStatic
+                                                      : Schedule::kWorkStealing;
+    std::vector<CacheLinePadded<double>> partial_sums(threads);
+    std::vector<double> idle_ns(threads, 0.0);
+
+    for (size_t pass = 0; pass < passes; ++pass) {
+      auto stats = pool.ParallelFor(
+          n,
+          kDefaultChunkSize,
+          schedule,
+          [&](size_t begin, size_t end, size_t worker) {
+            partial_sums[worker].value += population.Evaluate(begin, end);
+          }
+      );
+      wall_ns += stats.wall_ns;
+      for (size_t worker = 0; worker < threads; ++worker) {
+        idle_ns[worker] += stats.workers[worker].idle_ns;
+        result.steals += stats.workers[worker].steals;
+      }
+    }
+
+    for (size_t worker = 0; worker < threads; ++worker) {
+      sum += partial_sums[worker].value;
+      double idle_fraction = wall_ns > 0.0 ? idle_ns[worker] / wall_ns : 0.0;
+      result.mean_idle_fraction += idle_fraction / static_cast<double>(threads);
+      result.max_idle_fraction =
+          std::max(result.max_idle_fraction, idle_fraction);
+    }
+  }
+
+  prevent_optimization = sum;
+  result.sum = sum;
+  result.calls_per_second =
+      static_cast<double>(n * passes) / (wall_ns * 1e-9);
+  return result;
+}
+
+} // namespace
+
+std::string ExecutorName(Executor executor) {
+  switch (executor) {
+  case Executor::kStatic:
+    return "static";
+  case Executor::kWorkStealing:
+    return "work stealing";
+  case Executor::kStdPar:
+#ifdef HAVE_TBB
+    return "std::execution::par";
+#else
+    return "std::execution::par (serial, no TBB)";
+#endif
+  }
+  return "unknown";
+}
+
+std::vector<uint8_t> MakeExpensiveMask(size_t population, uint64_t seed) {
+  std::mt19937_64 rng{seed};
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  std::vector<uint8_t> mask(population);
+  for (size_t i = 0; i < population; ++i) {
+    double ramp = static_cast<double>(i) / static_cast<double>(population);
+    mask[i] = unit(rng) < ramp ? 1 : 0;
+  }
+  return mask;
+}
+
+const std::vector<std::string> &ParallelModels() {
+  static const std::vector<std::string> models = {
+      "runtime",
+      "crtp",
+      "concepts",
+      "variant",
+      "type_erased",
+  };
+  return models;
+}
+
+ParallelResult MeasureParallel(
+    const std::string &model,
+    Executor executor,
+    WorkStealingPool &pool,
+    const std::vector<uint8_t> &expensive_mask,
+    size_t passes
+) {
+  if (model == "runtime") {
+    return Measure(
+        model,
+        RuntimePopulation(expensive_mask),
+        executor,
+        pool,
+        passes
+    );
+  }
+  if (model == "crtp") {
+    return Measure(
+        model,
+        TaggedPopulation<
+            crtp_polymorphism::PolyFMA,
+            crtp_polymorphism::PolyExpensive>(expensive_mask),
+        executor,
+        pool,
+        passes
+    );
+  }
+  if (model == "concepts") {
+    return Measure(
+        model,
+        TaggedPopulation<
+            concepts_polymorphism::InlinePolyFMA,
+            concepts_polymorphism::InlinePolyExpensive>(expensive_mask),
+        executor,
+        pool,
+        passes
+    );
+  }
+  if (model == "variant") {
+    return Measure(
+        model,
+        VariantPopulation(expensive_mask),
+        executor,
+        pool,
+        passes
+    );
+  }
+  if (model == "type_erased") {
+    return Measure(
+        model,
+        TypeErasedPopulation(expensive_mask),
+        executor,
+        pool,
+        passes
+    );
+  }
+  throw std::invalid_argument("Invalid parallel model: " + model);
+}
+
+void WriteParallelTable(
+    std::ostream &out,
+    const std::vector<ParallelResult> &results
+) {
+  out << "| Model | Executor | Threads | Throughput (M calls/s) | Speedup "
+         "| Mean Idle (%) | Max Idle (%) | Steals |\n";
+  out << "|-------|----------|------|------|------|------|------|------|\n";
+  for (const auto &result : results) {
+    auto baseline = std::find_if(
+        results.begin(),
+        results.end(),
+        [&](const ParallelResult &other) {
+          return other.model == result.model &&
+                 other.executor == result.executor && other.threads == 1;
+        }
+    );
+    double speedup = baseline != results.end()
+                         ? result.calls_per_second / baseline->calls_per_second
+                         : 0.0;
+
+    out << "| " << result.model << " | " << ExecutorName(result.executor)
+        << " | " << result.threads << " | " << std::fixed
+        << std::setprecision(2) << result.calls_per_second / 1e6 << " | "
+        << speedup << " | ";
+    if (result.executor == Executor::kStdPar) {
+      out << "n/a | n/a | n/a |\n";
+    } else {
+      out << result.mean_idle_fraction * 100 << " | "
+          << result.max_idle_fraction * 100 << " | " << result.steals
+          << " |\n";
+    }
+    out.unsetf(std::ios::fixed);
+  }
+}
+
+void RunParallelDispatchBenchmark(size_t iterations) {
+  size_t passes = std::max(iterations / kPopulation, size_t{1});
+  auto expensive_mask = MakeExpensiveMask(kPopulation, 42);
+  auto thread_counts = ThreadCountSweep(HardwareThreadCount());
+
+  std::cout << "Population: " << kPopulation
+            << " objects (Expensive share ramps from 0% to 100%), Passes: "
+            << passes << ", Chunk Size: " << kDefaultChunkSize << "\n\n";
+
+  std::vector<ParallelResult> results;
+  for (size_t threads : thread_counts) {
+    WorkStealingPool pool(threads);
+    for (const auto &model : ParallelModels()) {
+      for (Executor executor :
+           {Executor::kStatic, Executor::kWorkStealing, Executor::kStdPar}) {
+        results.push_back(
+            MeasureParallel(model, executor, pool, expensive_mask, passes)
+        );
+      }
+    }
+  }
+  WriteParallelTable(std::cout, results);
+  std::cout << std::endl;
+}
+
+} // namespace parallel_dispatch
@@ -0,0 +1,104 @@
+#include "perf_counters.hpp"
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+struct EventSpec {
+  const char *name;
+  uint32_t type;
+  uint64_t config;
+};
+
+constexpr EventSpec kDefaultEvents[] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"branches", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS},
+    {"branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {"cache-references", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES},
+    {"cache-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+};
+
+int OpenCounter(const EventSpec &event) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = event.type;
+  attr.config = event.config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  // Threads created later count too (e.g. a scenario's worker pool)
+  attr.inherit = 1;
+  // This thread, any CPU
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+bool ReadCounter(int fd, uint64_t (&data)[3]) {
+  return read(fd, data, sizeof(data)) == sizeof(data);
+}
+
+} // namespace
+
+PerfCounters::PerfCounters() {
+  for (const auto &event : kDefaultEvents) {
+    int fd = OpenCounter(event);
+    if (fd >= 0) {
+      counters_.push_back({event.name, fd, {}, {}});
+    }
+  }
+}
+
+PerfCounters::~PerfCounters() {
+  for (const auto &counter : counters_) {
+    close(counter.fd);
+  }
+}
+
+// PERF_EVENT_IOC_RESET clears only the count, not the enabled and running
+// times, so the window is taken as the difference of two snapshots
+void PerfCounters::Start() {
+  for (auto &counter : counters_) {
+    ioctl(counter.fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+  for (auto &counter : counters_) {
+    uint64_t data[3] = {};
+    ReadCounter(counter.fd, data);
+    counter.start = {data[0], data[1], data[2]};
+  }
+}
+
+void PerfCounters::Stop() {
+  for (auto &counter : counters_) {
+    uint64_t data[3] = {};
+    bool ok = ReadCounter(counter.fd, data);
+    ioctl(counter.fd, PERF_EVENT_IOC_DISABLE, 0);
+    counter.window = ok ? Sample{
+                              data[0] - counter.start.value,
+                              data[1] - counter.start.enabled,
+                              data[2] - counter.start.running,
+                          }
+                        : Sample{};
+  }
+}
+
+std::vector<CounterReading> PerfCounters::Read() const {
+  std::vector<CounterReading> readings;
+  for (const auto &counter : counters_) {
+    const Sample &window = counter.window;
+    uint64_t value = window.value;
+    if (window.running != 0 && window.running < window.enabled) {
+      value = static_cast<uint64_t>(
+          static_cast<double>(value) * static_cast<double>(window.enabled) /
+          static_cast<double>(window.running)
+      );
+    }
+    readings.push_back({counter.name, value});
+  }
+  return readings;
+}
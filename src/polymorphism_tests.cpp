@@ -1,4 +1,5 @@
 #include "polymorphism_tests.hpp"
+#include "stream_buffers.hpp"
 
 namespace polymorphism_tests {
 
@@ -62,4 +63,268 @@ void TestConceptsExpensive(size_t iterations) {
   );
 }
 
+// Approximate ComputeExpensive Tests
+
+template <Accuracy A>
+std::string ExpensiveApproxLabel() {
+  return "Expensive Approx (" + AccuracyName(A) + ") Computation:";
+}
+
+template <Accuracy A>
+void TestRuntimeExpensiveApprox(size_t iterations) {
+  runtime_polymorphism::PolyExpensiveApprox<A> runtime_expensive_approx;
+  runtime_polymorphism::TestRuntimePolymorphism(
+      ExpensiveApproxLabel<A>(),
+      iterations,
+      runtime_expensive_approx
+  );
+}
+
+template <Accuracy A>
+void TestCRTPExpensiveApprox(size_t iterations) {
+  crtp_polymorphism::PolyExpensiveApprox<A> crtp_expensive_approx;
+  crtp_polymorphism::TestCRTPPolymorphism(
+      ExpensiveApproxLabel<A>(),
+      iterations,
+      crtp_expensive_approx
+  );
+}
+
+template <Accuracy A>
+void TestConceptsExpensiveApprox(size_t iterations) {
+  concepts_polymorphism::PolyExpensiveApprox<A> concepts_expensive_approx;
+  concepts_polymorphism::TestConceptsPolymorphism(
+      ExpensiveApproxLabel<A>(),
+      iterations,
+      concepts_expensive_approx
+  );
+}
+
+template void TestRuntimeExpensiveApprox<Accuracy::kLow>(size_t iterations);
+template void TestRuntimeExpensiveApprox<Accuracy::kMedium>(size_t iterations);
+template void TestRuntimeExpensiveApprox<Accuracy::kHigh>(size_t iterations);
+template void TestCRTPExpensiveApprox<Accuracy::kLow>(size_t iterations);
+template void TestCRTPExpensiveApprox<Accuracy::kMedium>(size_t iterations);
+template void TestCRTPExpensiveApprox<Accuracy::kHigh>(size_t iterations);
+template void TestConceptsExpensiveApprox<Accuracy::kLow>(size_t iterations);
+template void TestConceptsExpensiveApprox<Accuracy::kMedium>(size_t iterations);
+template void TestConceptsExpensiveApprox<Accuracy::kHigh>(size_t iterations);
+
+// Dependent FMA Chain Tests
+
+template <size_t K>
+std::string ChainLabel() {
+  return "Chain<" + std::to_string(K) + "> Computation:";
+}
+
+template <size_t K>
+void TestRuntimeChain(size_t iterations) {
+  runtime_polymorphism::PolyChain<K> runtime_chain;
+  runtime_polymorphism::TestRuntimePolymorphism(
+      ChainLabel<K>(),
+      iterations,
+      runtime_chain
+  );
+}
+
+template <size_t K>
+void TestCRTPChain(size_t iterations) {
+  crtp_polymorphism::PolyChain<K> crtp_chain;
+  crtp_polymorphism::TestCRTPPolymorphism(
+      ChainLabel<K>(),
+      iterations,
+      crtp_chain
+  );
+}
+
+template <size_t K>
+void TestConceptsChain(size_t iterations) {
+  concepts_polymorphism::PolyChain<K> concepts_chain;
+  concepts_polymorphism::TestConceptsPolymorphism(
+      ChainLabel<K>(),
+      iterations,
+      concepts_chain
+  );
+}
+
+template void TestRuntimeChain<1>(size_t iterations);
+template void TestRuntimeChain<2>(size_t iterations);
+template void TestRuntimeChain<4>(size_t iterations);
+template void TestRuntimeChain<8>(size_t iterations);
+template void TestRuntimeChain<16>(size_t iterations);
+template void TestRuntimeChain<32>(size_t iterations);
+template void TestRuntimeChain<64>(size_t iterations);
+template void TestRuntimeChain<128>(size_t iterations);
+template void TestRuntimeChain<256>(size_t iterations);
+template void TestCRTPChain<1>(size_t iterations);
+template void TestCRTPChain<2>(size_t iterations);
+template void TestCRTPChain<4>(size_t iterations);
+template void TestCRTPChain<8>(size_t iterations);
+template void TestCRTPChain<16>(size_t iterations);
+template void TestCRTPChain<32>(size_t iterations);
+template void TestCRTPChain<64>(size_t iterations);
+template void TestCRTPChain<128>(size_t iterations);
+template void TestCRTPChain<256>(size_t iterations);
+template void TestConceptsChain<1>(size_t iterations);
+template void TestConceptsChain<2>(size_t iterations);
+template void TestConceptsChain<4>(size_t iterations);
+template void TestConceptsChain<8>(size_t iterations);
+template void TestConceptsChain<16>(size_t iterations);
+template void TestConceptsChain<32>(size_t iterations);
+template void TestConceptsChain<64>(size_t iterations);
+template void TestConceptsChain<128>(size_t iterations);
+template void TestConceptsChain<256>(size_t iterations);
+
+// Memory-Bound (Streaming) Kernel Tests
+
+// Runtime Polymorphism Streaming Tests
+
+void TestRuntimeTriad(size_t iterations) {
+  const StreamBuffers &buffers = SharedStreamBuffers();
+  PrintStreamBuffersInfo(buffers);
+  runtime_polymorphism::PolyTriad runtime_triad(buffers.arrays());
+  runtime_polymorphism::TestRuntimeStreamPolymorphism(
+      "Triad Computation:",
+      iterations,
+      buffers.arrays().mask,
+      runtime_triad
+  );
+}
+
+void TestRuntimeDot(size_t iterations) {
+  const StreamBuffers &buffers = SharedStreamBuffers();
+  PrintStreamBuffersInfo(buffers);
+  runtime_polymorphism::PolyDot runtime_dot(buffers.arrays());
+  runtime_polymorphism::TestRuntimeStreamPolymorphism(
+      "Dot Computation:",
+      iterations,
+      buffers.arrays().mask,
+      runtime_dot
+  );
+}
+
+void TestRuntimeStencil(size_t iterations) {
+  const StreamBuffers &buffers = SharedStreamBuffers();
+  PrintStreamBuffersInfo(buffers);
+  runtime_polymorphism::PolyStencil runtime_stencil(buffers.arrays());
+  runtime_polymorphism::TestRuntimeStreamPolymorphism(
+      "Stencil Computation:",
+      iterations,
+      buffers.arrays().mask,
+      runtime_stencil
+  );
+}
+
+void TestRuntimeGather(size_t iterations) {
+  const StreamBuffers &buffers = SharedStreamBuffers();
+  PrintStreamBuffersInfo(buffers);
+  runtime_polymorphism::PolyGather runtime_gather(buffers.arrays());
+  runtime_polymorphism::TestRuntimeStreamPolymorphism(
+      "Gather Computation:",
+      iterations,
+      buffers.arrays().mask,
+      runtime_gather
+  );
+}
+
+// CRTP Polymorphism Streaming Tests
+
+void TestCRTPTriad(size_t iterations) {
+  const StreamBuffers &buffers = SharedStreamBuffers();
+  PrintStreamBuffersInfo(buffers);
+  crtp_polymorphism::PolyTriad crtp_triad(buffers.arrays());
+  crtp_polymorphism::TestCRTPStreamPolymorphism(
+      "Triad Computation:",
+      iterations,
+      buffers.arrays().mask,
+      crtp_triad
+  );
+}
+
+void TestCRTPDot(size_t iterations) {
+  const StreamBuffers &buffers = SharedStreamBuffers();
+  PrintStreamBuffersInfo(buffers);
+  crtp_polymorphism::PolyDot crtp_dot(buffers.arrays());
+  crtp_polymorphism::TestCRTPStreamPolymorphism(
+      "Dot Computation:",
+      iterations,
+      buffers.arrays().mask,
+      crtp_dot
+  );
+}
+
+void TestCRTPStencil(size_t iterations) {
+  const StreamBuffers &buffers = SharedStreamBuffers();
+  PrintStreamBuffersInfo(buffers);
+  crtp_polymorphism::PolyStencil crtp_stencil(buffers.arrays());
+  crtp_polymorphism::TestCRTPStreamPolymorphism(
+      "Stencil Computation:",
+      iterations,
+      buffers.arrays().mask,
+      crtp_stencil
+  );
+}
+
+void TestCRTPGather(size_t iterations) {
+  const StreamBuffers &buffers = SharedStreamBuffers();
+  PrintStreamBuffersInfo(buffers);
+  crtp_polymorphism::PolyGather crtp_gather(buffers.arrays());
+  crtp_polymorphism::TestCRTPStreamPolymorphism(
+      "Gather Computation:",
+      iterations,
+      buffers.arrays().mask,
+      crtp_gather
+  );
+}
+
+// Concepts Polymorphism Streaming Tests
+
+void TestConceptsTriad(size_t iterations) {
+  const StreamBuffers &buffers = SharedStreamBuffers();
+  PrintStreamBuffersInfo(buffers);
+  concepts_polymorphism::PolyTriad concepts_triad(buffers.arrays());
+  concepts_polymorphism::TestConceptsStreamPolymorphism(
+      "Triad Computation:",
+      iterations,
+      buffers.arrays().mask,
+      concepts_triad
+  );
+}
+
+void TestConceptsDot(size_t iterations) {
+  const StreamBuffers &buffers = SharedStreamBuffers();
+  PrintStreamBuffersInfo(buffers);
+  concepts_polymorphism::PolyDot concepts_dot(buffers.arrays());
+  concepts_polymorphism::TestConceptsStreamPolymorphism(
+      "Dot Computation:",
+      iterations,
+      buffers.arrays().mask,
+      concepts_dot
+  );
+}
+
+void TestConceptsStencil(size_t iterations) {
+  const StreamBuffers &buffers = SharedStreamBuffers();
+  PrintStreamBuffersInfo(buffers);
+  concepts_polymorphism::PolyStencil concepts_stencil(buffers.arrays());
+  concepts_polymorphism::TestConceptsStreamPolymorphism(
+      "Stencil Computation:",
+      iterations,
+      buffers.arrays().mask,
+      concepts_stencil
+  );
+}
+
+void TestConceptsGather(size_t iterations) {
+  const StreamBuffers &buffers = SharedStreamBuffers();
+  PrintStreamBuffersInfo(buffers);
+  concepts_polymorphism::PolyGather concepts_gather(buffers.arrays());
+  concepts_polymorphism::TestConceptsStreamPolymorphism(
+      "Gather Computation:",
+      iterations,
+      buffers.arrays().mask,
+      concepts_gather
+  );
+}
+
 } // namespace polymorphism_tests
@@ -0,0 +1,194 @@
+#include "result_cache.hpp"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <unistd.h>
+
+// Use the macro defined in CMakeLists.txt
+#ifndef COMPILER_FLAGS
+#define COMPILER_FLAGS "Unknown"
+#endif
+
+namespace result_cache {
+
+namespace {
+
+// Bumped whenever the meaning of a cached payload changes
+constexpr std::string_view kKeyVersion = "v1";
+
+void WriteJsonString(std::ostream &out, const std::string &text) {
+  out << '"';
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      out << '\\';
+    }
+    out << c;
+  }
+  out << '"';
+}
+
+// Tabs and newlines would break the one-line key
+std::string KeyField(std::string text) {
+  for (char &c : text) {
+    if (c == '\t' || c == '\n' || c == '\r') {
+      c = ' ';
+    }
+  }
+  return text;
+}
+
+} // namespace
+
+ResultCacheOptions &GetResultCacheOptions() {
+  static ResultCacheOptions options;
+  return options;
+}
+
+std::string ToHex(uint64_t value) {
+  std::ostringstream out;
+  out << std::hex << std::setw(16) << std::setfill('0') << value;
+  return out.str();
+}
+
+std::string HashFile(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("Unable to read " + path);
+  }
+  uint64_t hash = kFnvOffset;
+  char buffer[1 << 16];
+  while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+    hash = Fnv1a(
+        std::string_view(buffer, static_cast<size_t>(file.gcount())),
+        hash
+    );
+  }
+  return ToHex(hash);
+}
+
+std::string CpuModel() {
+  std::ifstream cpuinfo("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(cpuinfo, line)) {
+    if (line.rfind("model name", 0) != 0) {
+      continue;
+    }
+    auto colon = line.find(':');
+    auto start = line.find_first_not_of(" \t", colon + 1);
+    if (colon != std::string::npos && start != std::string::npos) {
+      return line.substr(start);
+    }
+  }
+  return "unknown";
+}
+
+const Identity &GetIdentity() {
+  static const Identity identity = [] {
+    Identity result;
+    try {
+      result.binary_hash = HashFile("/proc/self/exe");
+    } catch (const std::runtime_error &) {
+      result.binary_hash = "unknown";
+    }
+    result.compiler_flags = COMPILER_FLAGS;
+    result.cpu_model = CpuModel();
+    return result;
+  }();
+  return identity;
+}
+
+std::string IdentityJson(const Identity &identity) {
+  std::ostringstream out;
+  out << "{\"binary_hash\":";
+  WriteJsonString(out, identity.binary_hash);
+  out << ",\"compiler_flags\":";
+  WriteJsonString(out, identity.compiler_flags);
+  out << ",\"cpu_model\":";
+  WriteJsonString(out, identity.cpu_model);
+  out << "}";
+  return out.str();
+}
+
+std::string MakeKey(const Identity &identity, const std::string &job) {
+  std::ostringstream out;
+  out << kKeyVersion << '\t' << KeyField(identity.binary_hash) << '\t'
+      << KeyField(identity.compiler_flags) << '\t'
+      << KeyField(identity.cpu_model) << '\t' << KeyField(job);
+  return out.str();
+}
+
+std::string Digest(const std::string &key) {
+  return ToHex(Fnv1a(key));
+}
+
+ResultCache::ResultCache(std::string dir, int64_t max_age_seconds)
+    : dir_(std::move(dir)), max_age_seconds_(max_age_seconds) {
+  if (dir_.empty()) {
+    throw std::invalid_argument("Result cache needs a directory");
+  }
+  if (max_age_seconds_ < 0) {
+    throw std::invalid_argument("Result cache max age can't be negative");
+  }
+}
+
+std::string ResultCache::EntryPath(const std::string &key) const {
+  return (std::filesystem::path(dir_) / (Digest(key) + ".entry")).string();
+}
+
+std::optional<std::string> ResultCache::Lookup(const std::string &key) const {
+  namespace fs = std::filesystem;
+  std::string path = EntryPath(key);
+  std::error_code error;
+  auto modified = fs::last_write_time(path, error);
+  if (error) {
+    return std::nullopt;
+  }
+  auto age = std::chrono::duration_cast<std::chrono::seconds>(
+      fs::file_time_type::clock::now() - modified
+  );
+  if (age.count() > max_age_seconds_) {
+    return std::nullopt;
+  }
+
+  std::ifstream file(path, std::ios::binary);
+  std::string stored_key;
+  if (!std::getline(file, stored_key) || stored_key != key) {
+    return std::nullopt;
+  }
+  std::ostringstream payload;
+  payload << file.rdbuf();
+  return payload.str();
+}
+
+bool ResultCache::Store(const std::string &key, const std::string &payload)
+    const {
+  namespace fs = std::filesystem;
+  std::error_code error;
+  fs::create_directories(dir_, error);
+  if (error) {
+    return false;
+  }
+
+  std::string path = EntryPath(key);
+  std::string temporary = path + ".tmp." + std::to_string(getpid());
+  {
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    file << key << '\n' << payload;
+    if (!file.flush()) {
+      std::remove(temporary.c_str());
+      return false;
+    }
+  }
+  fs::rename(temporary, path, error);
+  if (error) {
+    std::remove(temporary.c_str());
+    return false;
+  }
+  return true;
+}
+
+} // namespace result_cache
@@ -9,6 +9,43 @@ double PolyFMA::Compute(double x) const { return ComputeFMA(x); }
 // Implement PolyExpensive::Compute
 double PolyExpensive::Compute(double x) const { return ComputeExpensive(x); }
 
+// Implement PolyExpensiveApprox::Compute
+template <Accuracy A>
+double PolyExpensiveApprox<A>::Compute(double x) const {
+  return ComputeExpensiveApprox<A>(x);
+}
+
+template class PolyExpensiveApprox<Accuracy::kLow>;
+template class PolyExpensiveApprox<Accuracy::kMedium>;
+template class PolyExpensiveApprox<Accuracy::kHigh>;
+
+// Implement PolyChain::Compute
+template <size_t K>
+double PolyChain<K>::Compute(double x) const {
+  return ComputeChain<K>(x);
+}
+
+template class PolyChain<1>;
+template class PolyChain<2>;
+template class PolyChain<4>;
+template class PolyChain<8>;
+template class PolyChain<16>;
+template class PolyChain<32>;
+template class PolyChain<64>;
+template class PolyChain<128>;
+template class PolyChain<256>;
+
+// Implement streaming kernels
+double PolyTriad::Compute(size_t i) const { return ComputeTriad(arrays_, i); }
+
+double PolyDot::Compute(size_t i) const { return ComputeDot(arrays_, i); }
+
+double PolyStencil::Compute(size_t i) const {
+  return ComputeStencil(arrays_, i);
+}
+
+double PolyGather::Compute(size_t i) const { return ComputeGather(arrays_, i); }
+
 // Implement TestRuntimePolymorphism
 void TestRuntimePolymorphism(
     const std::string &label,
@@ -20,4 +57,15 @@ void TestRuntimePolymorphism(
   });
 }
 
+void TestRuntimeStreamPolymorphism(
+    const std::string &label,
+    size_t n,
+    size_t mask,
+    RuntimeStreamBase &obj
+) {
+  RunStreamBenchmark(label + " Runtime Polymorphism", n, mask, [&](size_t i) {
+    return obj.Compute(i);
+  });
+}
+
 } // namespace runtime_polymorphism
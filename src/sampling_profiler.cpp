@@ -0,0 +1,707 @@
+#include "sampling_profiler.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <execinfo.h>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <linux/perf_event.h>
+#include <map>
+#include <mutex>
+#include <poll.h>
+#include <set>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <tuple>
+#include <ucontext.h>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace sampling_profiler {
+
+namespace {
+
+// Only one profiler samples at a time: the SIGPROF handler and its sample
+// storage are process-wide
+std::atomic<bool> profiler_running{false};
+
+// Ring buffer sizes to try, in pages. Unprivileged users are limited by
+// perf_event_mlock_kb (516 KiB by default).
+constexpr size_t kRingPages[] = {64, 16, 4};
+
+// How often the reader thread wakes up if the buffer isn't half full
+constexpr int kReaderPollMs = 50;
+
+// Frames of the signal handler itself (handler, sigreturn trampoline)
+// skipped when the interrupted address isn't found in the backtrace
+constexpr int kHandlerFrames = 2;
+
+// Longest function name printed in the text report
+constexpr size_t kMaxReportedNameLength = 96;
+
+// SIGPROF sample storage, allocated before the timer starts so the handler
+// never allocates. A depth of 0 marks a slot that wasn't completely written.
+std::unique_ptr<uint64_t[]> signal_frames;
+std::unique_ptr<std::atomic<uint8_t>[]> signal_depths;
+std::atomic<size_t> signal_count{0};
+struct sigaction previous_action;
+
+// SIGPROF timer on the profiled thread's CPU clock, delivered to that thread
+// only (unlike ITIMER_PROF, which counts and signals the whole process)
+timer_t signal_timer;
+
+// Profiles stopped by ScopedProfile, written by FlushProfiles()
+std::mutex pending_mutex;
+std::vector<std::pair<std::string, Profile>> pending_profiles;
+
+uint64_t ProgramCounter(void *context) {
+  auto *user_context = static_cast<ucontext_t *>(context);
+#if defined(__x86_64__)
+  return static_cast<uint64_t>(user_context->uc_mcontext.gregs[REG_RIP]);
+#elif defined(__aarch64__)
+  return user_context->uc_mcontext.pc;
+#else
+  (void)user_context;
+  return 0;
+#endif
+}
+
+// backtrace() is used from the handler only after a warm-up call in Start()
+// has loaded the unwinder, so it doesn't allocate here
+void HandleProfSignal(int, siginfo_t *, void *context) {
+  int saved_errno = errno;
+  size_t index = signal_count.fetch_add(1, std::memory_order_relaxed);
+  if (index < kMaxSamples) {
+    uint64_t *frames = &signal_frames[index * kMaxFrames];
+    frames[0] = ProgramCounter(context);
+
+    void *trace[kMaxFrames + kHandlerFrames];
+    int depth = backtrace(trace, static_cast<int>(std::size(trace)));
+    int first_caller = kHandlerFrames;
+    for (int i = 0; i < depth; ++i) {
+      if (reinterpret_cast<uint64_t>(trace[i]) == frames[0]) {
+        first_caller = i + 1;
+        break;
+      }
+    }
+    size_t frame_count = 1;
+    for (int i = first_caller; i < depth && frame_count < kMaxFrames; ++i) {
+      frames[frame_count++] = reinterpret_cast<uint64_t>(trace[i]);
+    }
+    signal_depths[index].store(
+        static_cast<uint8_t>(frame_count),
+        std::memory_order_release
+    );
+  }
+  errno = saved_errno;
+}
+
+// Copies `size` bytes starting at `offset` out of the circular data area
+void CopyFromRing(
+    const char *data,
+    size_t ring_bytes,
+    uint64_t offset,
+    void *destination,
+    size_t size
+) {
+  size_t start = offset % ring_bytes;
+  size_t first = std::min(size, ring_bytes - start);
+  std::memcpy(destination, data + start, first);
+  std::memcpy(static_cast<char *>(destination) + first, data, size - first);
+}
+
+std::string FileStem(const std::string &label) {
+  std::string stem;
+  for (char c : label) {
+    if (std::isalnum(static_cast<unsigned char>(c))) {
+      stem += c;
+    } else if (!stem.empty() && stem.back() != '_') {
+      stem += '_';
+    }
+  }
+  while (!stem.empty() && stem.back() == '_') {
+    stem.pop_back();
+  }
+  return stem.empty() ? "profile" : stem;
+}
+
+std::string Basename(const std::string &path) {
+  size_t slash = path.find_last_of('/');
+  return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+// Symbolizes each frame address once. Callers are looked up one byte before
+// the return address so they resolve to the call instruction.
+class FrameResolver {
+public:
+  explicit FrameResolver(const Symbolizer &symbolizer)
+      : symbolizer_(symbolizer) {}
+
+  const SourceLocation &Resolve(uint64_t address, bool caller) {
+    uint64_t lookup = caller && address > 0 ? address - 1 : address;
+    auto it = cache_.find(lookup);
+    if (it == cache_.end()) {
+      it = cache_.emplace(lookup, symbolizer_.Resolve(lookup)).first;
+    }
+    return it->second;
+  }
+
+private:
+  const Symbolizer &symbolizer_;
+  std::unordered_map<uint64_t, SourceLocation> cache_;
+};
+
+// Minimal protobuf wire-format writer
+class ProtoWriter {
+public:
+  void Varint(uint64_t value) {
+    while (value >= 0x80) {
+      bytes_ += static_cast<char>((value & 0x7f) | 0x80);
+      value >>= 7;
+    }
+    bytes_ += static_cast<char>(value);
+  }
+
+  void Field(int field, uint64_t value) {
+    Varint(static_cast<uint64_t>(field) << 3); // wire type 0
+    Varint(value);
+  }
+
+  void Bytes(int field, const std::string &value) {
+    Varint(static_cast<uint64_t>(field) << 3 | 2); // wire type 2
+    Varint(value.size());
+    bytes_ += value;
+  }
+
+  void Packed(int field, const std::vector<uint64_t> &values) {
+    ProtoWriter packed;
+    for (uint64_t value : values) {
+      packed.Varint(value);
+    }
+    Bytes(field, packed.str());
+  }
+
+  const std::string &str() const { return bytes_; }
+
+private:
+  std::string bytes_;
+};
+
+class StringTable {
+public:
+  StringTable() { Index(""); } // index 0 must be the empty string
+
+  uint64_t Index(const std::string &value) {
+    auto [it, inserted] = indexes_.emplace(value, strings_.size());
+    if (inserted) {
+      strings_.push_back(value);
+    }
+    return it->second;
+  }
+
+  const std::vector<std::string> &strings() const { return strings_; }
+
+private:
+  std::unordered_map<std::string, uint64_t> indexes_;
+  std::vector<std::string> strings_;
+};
+
+ProtoWriter ValueType(StringTable &strings, const char *type, const char *unit) {
+  ProtoWriter value_type;
+  value_type.Field(1, strings.Index(type));
+  value_type.Field(2, strings.Index(unit));
+  return value_type;
+}
+
+} // namespace
+
+ProfilerOptions &GetProfilerOptions() {
+  static ProfilerOptions options;
+  return options;
+}
+
+std::string BackendName(Backend backend) {
+  switch (backend) {
+  case Backend::kPerfCycles:
+    return "perf_event cycles";
+  case Backend::kPerfCpuClock:
+    return "perf_event cpu-clock";
+  case Backend::kSignal:
+    return "SIGPROF timer";
+  }
+  return "unknown";
+}
+
+SamplingProfiler::SamplingProfiler(int frequency_hz, bool allow_perf_event)
+    : frequency_hz_(frequency_hz), allow_perf_event_(allow_perf_event) {}
+
+SamplingProfiler::~SamplingProfiler() {
+  if (running_) {
+    Stop();
+  }
+}
+
+bool SamplingProfiler::Start() {
+  if (running_ || frequency_hz_ <= 0 ||
+      profiler_running.exchange(true, std::memory_order_acq_rel)) {
+    return false;
+  }
+  profile_ = Profile{};
+  profile_.frequency_hz = frequency_hz_;
+
+  if (allow_perf_event_ &&
+      StartPerfEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES)) {
+    backend_ = Backend::kPerfCycles;
+  } else if (allow_perf_event_ &&
+             StartPerfEvent(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_CLOCK)) {
+    backend_ = Backend::kPerfCpuClock;
+  } else if (StartSignal()) {
+    backend_ = Backend::kSignal;
+  } else {
+    profiler_running.store(false, std::memory_order_release);
+    return false;
+  }
+  profile_.backend = backend_;
+  running_ = true;
+  return true;
+}
+
+bool SamplingProfiler::StartPerfEvent(uint32_t type, uint64_t config) {
+  size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  for (size_t pages : kRingPages) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.freq = 1;
+    attr.sample_freq = static_cast<uint64_t>(frequency_hz_);
+    attr.sample_type = PERF_SAMPLE_IP | PERF_SAMPLE_CALLCHAIN;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.exclude_callchain_kernel = 1;
+    attr.watermark = 1;
+    attr.wakeup_watermark = static_cast<uint32_t>(pages * page_size / 2);
+
+    // This thread, any CPU
+    int fd = static_cast<int>(
+        syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC)
+    );
+    if (fd < 0) {
+      return false;
+    }
+    // One metadata page followed by a power-of-two data area
+    void *ring = mmap(
+        nullptr,
+        (pages + 1) * page_size,
+        PROT_READ | PROT_WRITE,
+        MAP_SHARED,
+        fd,
+        0
+    );
+    if (ring == MAP_FAILED) {
+      close(fd);
+      continue;
+    }
+
+    perf_fd_ = fd;
+    ring_ = ring;
+    ring_bytes_ = pages * page_size;
+    stop_reader_.store(false, std::memory_order_relaxed);
+    reader_ = std::thread(&SamplingProfiler::ReadRingBufferLoop, this);
+    ioctl(perf_fd_, PERF_EVENT_IOC_RESET, 0);
+    ioctl(perf_fd_, PERF_EVENT_IOC_ENABLE, 0);
+    return true;
+  }
+  return false;
+}
+
+bool SamplingProfiler::StartSignal() {
+  if (!signal_frames) {
+    signal_frames = std::make_unique<uint64_t[]>(kMaxSamples * kMaxFrames);
+    signal_depths = std::make_unique<std::atomic<uint8_t>[]>(kMaxSamples);
+  }
+  for (size_t i = 0; i < kMaxSamples; ++i) {
+    signal_depths[i].store(0, std::memory_order_relaxed);
+  }
+  signal_count.store(0, std::memory_order_relaxed);
+
+  // Loads the unwinder now rather than inside the handler
+  void *warm_up[2];
+  backtrace(warm_up, 2);
+
+  struct sigaction action;
+  std::memset(&action, 0, sizeof(action));
+  action.sa_sigaction = &HandleProfSignal;
+  action.sa_flags = SA_SIGINFO | SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  if (sigaction(SIGPROF, &action, &previous_action) != 0) {
+    return false;
+  }
+
+  sigevent event;
+  std::memset(&event, 0, sizeof(event));
+  event.sigev_notify = SIGEV_THREAD_ID;
+  event.sigev_signo = SIGPROF;
+  event._sigev_un._tid = static_cast<pid_t>(syscall(SYS_gettid));
+  if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &signal_timer) != 0) {
+    sigaction(SIGPROF, &previous_action, nullptr);
+    return false;
+  }
+
+  long interval_ns = std::max(1'000'000'000L / frequency_hz_, 1L);
+  itimerspec timer;
+  timer.it_interval.tv_sec = interval_ns / 1'000'000'000;
+  timer.it_interval.tv_nsec = interval_ns % 1'000'000'000;
+  timer.it_value = timer.it_interval;
+  if (timer_settime(signal_timer, 0, &timer, nullptr) != 0) {
+    timer_delete(signal_timer);
+    sigaction(SIGPROF, &previous_action, nullptr);
+    return false;
+  }
+  return true;
+}
+
+Profile SamplingProfiler::Stop() {
+  if (!running_) {
+    return std::move(profile_);
+  }
+  running_ = false;
+
+  if (backend_ == Backend::kSignal) {
+    timer_delete(signal_timer);
+    sigaction(SIGPROF, &previous_action, nullptr);
+    size_t count = signal_count.load(std::memory_order_acquire);
+    size_t kept = std::min(count, kMaxSamples);
+    profile_.lost = count - kept;
+    for (size_t i = 0; i < kept; ++i) {
+      uint8_t depth = signal_depths[i].load(std::memory_order_acquire);
+      if (depth == 0) {
+        ++profile_.lost;
+        continue;
+      }
+      const uint64_t *frames = &signal_frames[i * kMaxFrames];
+      profile_.stacks.emplace_back(frames, frames + depth);
+    }
+  } else {
+    ioctl(perf_fd_, PERF_EVENT_IOC_DISABLE, 0);
+    stop_reader_.store(true, std::memory_order_release);
+    reader_.join();
+    DrainRingBuffer();
+    munmap(ring_, ring_bytes_ + static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+    close(perf_fd_);
+    ring_ = nullptr;
+    perf_fd_ = -1;
+  }
+
+  profiler_running.store(false, std::memory_order_release);
+  return std::move(profile_);
+}
+
+void SamplingProfiler::ReadRingBufferLoop() {
+  pollfd poll_fd{perf_fd_, POLLIN, 0};
+  while (!stop_reader_.load(std::memory_order_acquire)) {
+    poll(&poll_fd, 1, kReaderPollMs);
+    DrainRingBuffer();
+  }
+}
+
+void SamplingProfiler::DrainRingBuffer() {
+  auto *metadata = static_cast<perf_event_mmap_page *>(ring_);
+  const char *data = static_cast<const char *>(ring_) +
+                     static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  uint64_t head = __atomic_load_n(&metadata->data_head, __ATOMIC_ACQUIRE);
+  uint64_t tail = metadata->data_tail;
+
+  std::vector<uint64_t> record;
+  while (tail < head) {
+    perf_event_header header;
+    CopyFromRing(data, ring_bytes_, tail, &header, sizeof(header));
+    if (header.size < sizeof(header) || tail + header.size > head) {
+      break;
+    }
+    // Payload is 8-byte aligned
+    record.resize((header.size - sizeof(header)) / sizeof(uint64_t));
+    CopyFromRing(
+        data,
+        ring_bytes_,
+        tail + sizeof(header),
+        record.data(),
+        record.size() * sizeof(uint64_t)
+    );
+    tail += header.size;
+
+    if (header.type == PERF_RECORD_LOST && record.size() >= 2) {
+      profile_.lost += record[1]; // id, lost
+    } else if (header.type == PERF_RECORD_SAMPLE && record.size() >= 2) {
+      // ip, nr, ips[nr] (context markers, then ip again, then callers)
+      if (profile_.stacks.size() >= kMaxSamples) {
+        ++profile_.lost;
+        continue;
+      }
+      std::vector<uint64_t> stack = {record[0]};
+      size_t chain_length = std::min<size_t>(record[1], record.size() - 2);
+      bool skipped_ip = false;
+      for (size_t i = 0; i < chain_length && stack.size() < kMaxFrames;
+           ++i) {
+        uint64_t address = record[2 + i];
+        if (address >= PERF_CONTEXT_MAX) {
+          continue;
+        }
+        if (!skipped_ip && address == record[0]) {
+          skipped_ip = true;
+          continue;
+        }
+        skipped_ip = true;
+        stack.push_back(address);
+      }
+      profile_.stacks.push_back(std::move(stack));
+    }
+  }
+  __atomic_store_n(&metadata->data_tail, tail, __ATOMIC_RELEASE);
+}
+
+std::string EncodePprof(const Profile &profile, const Symbolizer &symbolizer) {
+  StringTable strings;
+  ProtoWriter out;
+  FrameResolver resolver(symbolizer);
+
+  out.Bytes(1, ValueType(strings, "samples", "count").str());
+  out.Bytes(1, ValueType(strings, "cpu", "nanoseconds").str());
+
+  // The executable is the only mapping; it's already symbolized
+  constexpr uint64_t kExecutableMapping = 1;
+  ProtoWriter mapping;
+  mapping.Field(1, kExecutableMapping);
+  mapping.Field(2, symbolizer.executable_start());
+  mapping.Field(3, symbolizer.executable_end());
+  mapping.Field(5, strings.Index(symbolizer.executable_path()));
+  mapping.Field(7, 1); // has_functions
+  mapping.Field(8, 1); // has_filenames
+  mapping.Field(9, symbolizer.has_line_info() ? 1 : 0);
+  out.Bytes(3, mapping.str());
+
+  // Locations are keyed by (address, caller); functions by (name, file)
+  std::map<std::pair<uint64_t, bool>, uint64_t> location_ids;
+  std::map<std::pair<std::string, std::string>, uint64_t> function_ids;
+  std::map<std::vector<uint64_t>, uint64_t> sample_counts;
+  for (const auto &stack : profile.stacks) {
+    std::vector<uint64_t> ids;
+    for (size_t i = 0; i < stack.size(); ++i) {
+      auto key = std::pair(stack[i], i > 0);
+      auto [location, inserted] =
+          location_ids.emplace(key, location_ids.size() + 1);
+      if (inserted) {
+        const SourceLocation &source = resolver.Resolve(stack[i], i > 0);
+        auto [function, new_function] = function_ids.emplace(
+            std::pair(source.function, source.file),
+            function_ids.size() + 1
+        );
+        if (new_function) {
+          ProtoWriter entry;
+          entry.Field(1, function->second);
+          entry.Field(2, strings.Index(source.function));
+          entry.Field(3, strings.Index(source.function));
+          entry.Field(4, strings.Index(source.file));
+          out.Bytes(5, entry.str());
+        }
+
+        ProtoWriter line;
+        line.Field(1, function->second);
+        line.Field(2, source.line);
+        ProtoWriter entry;
+        entry.Field(1, location->second);
+        if (symbolizer.InExecutable(stack[i])) {
+          entry.Field(2, kExecutableMapping);
+        }
+        entry.Field(3, stack[i]);
+        entry.Bytes(4, line.str());
+        out.Bytes(4, entry.str());
+      }
+      ids.push_back(location->second);
+    }
+    ++sample_counts[ids];
+  }
+
+  for (const auto &[ids, count] : sample_counts) {
+    ProtoWriter sample;
+    sample.Packed(1, ids);
+    sample.Packed(
+        2,
+        {count, count * static_cast<uint64_t>(profile.PeriodNs())}
+    );
+    out.Bytes(2, sample.str());
+  }
+
+  out.Bytes(11, ValueType(strings, "cpu", "nanoseconds").str());
+  out.Field(12, static_cast<uint64_t>(profile.PeriodNs()));
+  out.Field(13, strings.Index("backend: " + BackendName(profile.backend)));
+  for (const auto &value : strings.strings()) {
+    out.Bytes(6, value);
+  }
+  return out.str();
+}
+
+void WriteTopReport(
+    std::ostream &out,
+    const std::string &label,
+    const Profile &profile,
+    const Symbolizer &symbolizer,
+    size_t top
+) {
+  struct FunctionStats {
+    std::string name;
+    size_t self = 0;
+    size_t cumulative = 0;
+    std::map<std::pair<std::string, uint32_t>, size_t> lines;
+  };
+  std::unordered_map<std::string, FunctionStats> stats;
+  FrameResolver resolver(symbolizer);
+
+  for (const auto &stack : profile.stacks) {
+    std::set<std::string> seen;
+    for (size_t i = 0; i < stack.size(); ++i) {
+      const SourceLocation &source = resolver.Resolve(stack[i], i > 0);
+      FunctionStats &function = stats[source.function];
+      function.name = source.function;
+      if (i == 0) {
+        ++function.self;
+        if (source.line != 0) {
+          ++function.lines[{source.file, source.line}];
+        }
+      }
+      if (seen.insert(source.function).second) {
+        ++function.cumulative;
+      }
+    }
+  }
+
+  std::vector<const FunctionStats *> ranked;
+  for (const auto &[name, function] : stats) {
+    ranked.push_back(&function);
+  }
+  std::sort(
+      ranked.begin(),
+      ranked.end(),
+      [](const FunctionStats *a, const FunctionStats *b) {
+        return std::tie(b->self, b->cumulative, a->name) <
+               std::tie(a->self, a->cumulative, b->name);
+      }
+  );
+
+  size_t total = profile.stacks.size();
+  out << "Profile: " << label << " (" << total << " samples, "
+      << BackendName(profile.backend) << ", " << profile.frequency_hz
+      << " Hz";
+  if (profile.lost > 0) {
+    out << ", " << profile.lost << " lost";
+  }
+  out << ")\n\n";
+  if (total == 0) {
+    return;
+  }
+  out << "| Rank | Self (%) | Cumulative (%) | Function | Hottest Line |\n";
+  out << "|------|------|------|----------|------|\n";
+  for (size_t rank = 0; rank < std::min(top, ranked.size()); ++rank) {
+    const FunctionStats &function = *ranked[rank];
+    std::string name = function.name;
+    if (name.size() > kMaxReportedNameLength) {
+      name = name.substr(0, kMaxReportedNameLength - 3) + "...";
+    }
+    std::string hottest = "-";
+    auto line = std::max_element(
+        function.lines.begin(),
+        function.lines.end(),
+        [](const auto &a, const auto &b) { return a.second < b.second; }
+    );
+    if (line != function.lines.end()) {
+      hottest =
+          Basename(line->first.first) + ":" + std::to_string(line->first.second);
+    }
+
+    out << "| " << rank + 1 << " | " << std::fixed << std::setprecision(2)
+        << 100.0 * function.self / total << " | "
+        << 100.0 * function.cumulative / total << " | " << name << " | "
+        << hottest << " |\n";
+    out.unsetf(std::ios::fixed);
+  }
+}
+
+const Symbolizer &GetSymbolizer() {
+  static const Symbolizer symbolizer;
+  return symbolizer;
+}
+
+namespace {
+
+// Symbolizes a profile, writes <dir>/<label>.pb and <dir>/<label>.txt and
+// prints the report
+void WriteProfile(const std::string &label, const Profile &profile) {
+  const ProfilerOptions &options = GetProfilerOptions();
+  const Symbolizer &symbolizer = GetSymbolizer();
+
+  std::error_code error;
+  std::filesystem::create_directories(options.output_dir, error);
+  std::string base =
+      (std::filesystem::path(options.output_dir) / FileStem(label)).string();
+
+  std::ofstream pprof_file(base + ".pb", std::ios::binary);
+  pprof_file << EncodePprof(profile, symbolizer);
+  std::ofstream report_file(base + ".txt");
+  WriteTopReport(report_file, label, profile, symbolizer, options.top);
+  if (!pprof_file || !report_file) {
+    std::cerr << "Error: Unable to write profile: " << base << std::endl;
+    return;
+  }
+
+  WriteTopReport(std::cout, label, profile, symbolizer, options.top);
+  std::cout << "\nProfile saved to: " << base << ".pb" << std::endl
+            << std::endl;
+}
+
+} // namespace
+
+ScopedProfile::ScopedProfile(const std::string &label) : label_(label) {
+  const ProfilerOptions &options = GetProfilerOptions();
+  if (options.output_dir.empty()) {
+    return;
+  }
+  auto profiler = std::make_unique<SamplingProfiler>(options.frequency_hz);
+  if (profiler->Start()) {
+    profiler_ = std::move(profiler);
+  }
+}
+
+ScopedProfile::~ScopedProfile() {
+  if (!profiler_) {
+    return;
+  }
+  Profile profile = profiler_->Stop();
+  std::lock_guard<std::mutex> lock(pending_mutex);
+  pending_profiles.emplace_back(label_, std::move(profile));
+}
+
+size_t PendingProfileCount() {
+  std::lock_guard<std::mutex> lock(pending_mutex);
+  return pending_profiles.size();
+}
+
+void FlushProfiles() {
+  std::vector<std::pair<std::string, Profile>> profiles;
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex);
+    profiles.swap(pending_profiles);
+  }
+  for (const auto &[label, profile] : profiles) {
+    WriteProfile(label, profile);
+  }
+}
+
+} // namespace sampling_profiler
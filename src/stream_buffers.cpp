@@ -0,0 +1,76 @@
+#include "stream_buffers.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+StreamOptions &GetStreamOptions() {
+  static StreamOptions options;
+  return options;
+}
+
+bool IsPowerOfTwo(size_t value) {
+  return value != 0 && (value & (value - 1)) == 0;
+}
+
+StreamBuffers::StreamBuffers(const StreamOptions &options)
+    : options_(options),
+      a_(options.length * sizeof(double), options.huge_pages),
+      b_((options.length + 2) * sizeof(double), options.huge_pages),
+      c_(options.length * sizeof(double), options.huge_pages),
+      index_(options.length * sizeof(uint32_t), options.huge_pages) {
+  TRACE_SCOPE("StreamBuffers::StreamBuffers");
+  if (!IsPowerOfTwo(options.length)) {
+    throw std::invalid_argument("Stream length must be a power of two");
+  }
+
+  auto *a = a_.As<double>();
+  auto *b = b_.As<double>();
+  auto *c = c_.As<double>();
+  auto *index = index_.As<uint32_t>();
+
+  std::fill_n(a, options.length, 0.0);
+  for (size_t i = 0; i < options.length + 2; ++i) {
+    b[i] = 1.0 + static_cast<double>(i & 7) * 0.125;
+  }
+  std::fill_n(c, options.length, 2.0);
+
+  // Fixed seed keeps the gather pattern identical across dispatch models
+  std::iota(index, index + options.length, uint32_t{0});
+  std::shuffle(index, index + options.length, std::mt19937_64{42});
+
+  arrays_ = StreamArrays{
+      a,
+      b,
+      c,
+      index,
+      options.length - 1,
+      options.prefetch_distance
+  };
+}
+
+void PrintStreamBuffersInfo(const StreamBuffers &buffers) {
+  std::cout << "Stream Length: " << buffers.length() << " elements ("
+            << buffers.length() * sizeof(double) / (1024 * 1024)
+            << " MiB per array)" << std::endl;
+  std::cout << "Huge Pages: " << HugePageModeName(buffers.mode())
+            << ", Prefetch Distance: " << buffers.arrays().prefetch_distance
+            << std::endl;
+}
+
+const StreamBuffers &SharedStreamBuffers() {
+  static std::unique_ptr<StreamBuffers> buffers;
+  const StreamOptions &options = GetStreamOptions();
+  if (!buffers || buffers->options().length != options.length ||
+      buffers->options().huge_pages != options.huge_pages ||
+      buffers->options().prefetch_distance != options.prefetch_distance) {
+    buffers.reset();
+    buffers = std::make_unique<StreamBuffers>(options);
+  }
+  return *buffers;
+}
+
+void PrepareStreamBuffers() { SharedStreamBuffers(); }
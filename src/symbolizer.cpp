@@ -0,0 +1,631 @@
+#include "symbolizer.hpp"
+#include <algorithm>
+#include <cstring>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <elf.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <link.h>
+#include <memory>
+#include <sstream>
+
+namespace {
+
+// DWARF constants used by the line-number program (DWARF 2-5)
+constexpr uint8_t kLineCopy = 1;
+constexpr uint8_t kLineAdvancePc = 2;
+constexpr uint8_t kLineAdvanceLine = 3;
+constexpr uint8_t kLineSetFile = 4;
+constexpr uint8_t kLineConstAddPc = 8;
+constexpr uint8_t kLineFixedAdvancePc = 9;
+constexpr uint8_t kLineEndSequence = 1;
+constexpr uint8_t kLineSetAddress = 2;
+constexpr uint8_t kLineDefineFile = 3;
+
+constexpr uint64_t kPathContent = 1;           // DW_LNCT_path
+constexpr uint64_t kDirectoryIndexContent = 2; // DW_LNCT_directory_index
+
+constexpr uint64_t kFormBlock = 0x09;
+constexpr uint64_t kFormData1 = 0x0b;
+constexpr uint64_t kFormData2 = 0x05;
+constexpr uint64_t kFormData4 = 0x06;
+constexpr uint64_t kFormData8 = 0x07;
+constexpr uint64_t kFormData16 = 0x1e;
+constexpr uint64_t kFormString = 0x08;
+constexpr uint64_t kFormStrp = 0x0e;
+constexpr uint64_t kFormLineStrp = 0x1f;
+constexpr uint64_t kFormUdata = 0x0f;
+
+// Bounds-checked little-endian reader. Reads past the end return zeros and
+// set `failed`, so a malformed section stops parsing instead of crashing.
+class ByteReader {
+public:
+  ByteReader(const char *data, size_t size) : data_(data), size_(size) {}
+
+  bool failed() const { return failed_; }
+  bool AtEnd() const { return failed_ || offset_ >= size_; }
+  size_t offset() const { return offset_; }
+
+  void Skip(size_t bytes) {
+    if (bytes > size_ - offset_) {
+      failed_ = true;
+      offset_ = size_;
+      return;
+    }
+    offset_ += bytes;
+  }
+
+  uint64_t Fixed(size_t bytes) {
+    if (bytes > 8 || bytes > size_ - offset_) {
+      Skip(bytes);
+      return 0;
+    }
+    uint64_t value = 0;
+    std::memcpy(&value, data_ + offset_, bytes); // little-endian hosts
+    offset_ += bytes;
+    return value;
+  }
+
+  uint64_t Uleb() {
+    uint64_t value = 0;
+    for (int shift = 0; !AtEnd(); shift += 7) {
+      uint8_t byte = static_cast<uint8_t>(data_[offset_++]);
+      if (shift < 64) {
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      }
+      if ((byte & 0x80) == 0) {
+        return value;
+      }
+    }
+    failed_ = true;
+    return value;
+  }
+
+  int64_t Sleb() {
+    int64_t value = 0;
+    int shift = 0;
+    uint8_t byte = 0x80;
+    while ((byte & 0x80) != 0 && !AtEnd()) {
+      byte = static_cast<uint8_t>(data_[offset_++]);
+      if (shift < 64) {
+        value |= static_cast<int64_t>(byte & 0x7f) << shift;
+      }
+      shift += 7;
+    }
+    if (shift < 64 && (byte & 0x40) != 0) {
+      value |= -(int64_t{1} << shift);
+    }
+    return value;
+  }
+
+  std::string CString() {
+    const char *start = data_ + offset_;
+    size_t length = strnlen(start, size_ - offset_);
+    Skip(length + 1);
+    return std::string(start, length);
+  }
+
+private:
+  const char *data_;
+  size_t size_;
+  size_t offset_ = 0;
+  bool failed_ = false;
+};
+
+std::string StringAt(const char *section, size_t size, uint64_t offset) {
+  if (section == nullptr || offset >= size) {
+    return {};
+  }
+  return std::string(section + offset, strnlen(section + offset, size - offset));
+}
+
+std::string JoinPath(const std::string &directory, const std::string &name) {
+  if (directory.empty() || name.starts_with('/')) {
+    return name;
+  }
+  return directory + "/" + name;
+}
+
+std::string Demangle(const char *name) {
+  int status = 0;
+  std::unique_ptr<char, void (*)(void *)> demangled(
+      abi::__cxa_demangle(name, nullptr, nullptr, &status),
+      std::free
+  );
+  return status == 0 && demangled ? demangled.get() : name;
+}
+
+std::string Basename(const std::string &path) {
+  size_t slash = path.find_last_of('/');
+  return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+std::string HexOffset(const std::string &module, uint64_t offset) {
+  std::ostringstream out;
+  out << module << "+0x" << std::hex << offset;
+  return out.str();
+}
+
+// DWARF 5 directory and file entries are described by (content, form) pairs
+struct EntryFormat {
+  uint64_t content;
+  uint64_t form;
+};
+
+struct LineHeader {
+  uint16_t version = 0;
+  bool dwarf64 = false;
+  uint8_t min_instruction_length = 1;
+  int8_t line_base = 0;
+  uint8_t line_range = 1;
+  uint8_t opcode_base = 1;
+  std::vector<uint8_t> standard_opcode_lengths;
+};
+
+} // namespace
+
+Symbolizer::Symbolizer() {
+  // The main program is the first object reported, with an empty name
+  dl_iterate_phdr(
+      [](dl_phdr_info *info, size_t, void *data) {
+        auto *self = static_cast<Symbolizer *>(data);
+        self->load_bias_ = info->dlpi_addr;
+        for (int i = 0; i < info->dlpi_phnum; ++i) {
+          const auto &header = info->dlpi_phdr[i];
+          if (header.p_type != PT_LOAD) {
+            continue;
+          }
+          uint64_t start = info->dlpi_addr + header.p_vaddr;
+          uint64_t end = start + header.p_memsz;
+          if (self->executable_end_ == 0) {
+            self->executable_start_ = start;
+          }
+          self->executable_start_ = std::min(self->executable_start_, start);
+          self->executable_end_ = std::max(self->executable_end_, end);
+        }
+        return 1; // stop after the main program
+      },
+      this
+  );
+
+  std::error_code error;
+  executable_path_ =
+      std::filesystem::read_symlink("/proc/self/exe", error).string();
+  std::ifstream file("/proc/self/exe", std::ios::binary);
+  std::vector<char> image(
+      (std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>()
+  );
+  LoadElf(image);
+}
+
+void Symbolizer::LoadElf(const std::vector<char> &image) {
+  if (image.size() < sizeof(Elf64_Ehdr) ||
+      std::memcmp(image.data(), ELFMAG, SELFMAG) != 0 ||
+      image[EI_CLASS] != ELFCLASS64) {
+    return;
+  }
+  Elf64_Ehdr elf_header;
+  std::memcpy(&elf_header, image.data(), sizeof(elf_header));
+  if (elf_header.e_shoff == 0 ||
+      elf_header.e_shentsize != sizeof(Elf64_Shdr) ||
+      elf_header.e_shoff + elf_header.e_shnum * sizeof(Elf64_Shdr) >
+          image.size()) {
+    return;
+  }
+
+  std::vector<Elf64_Shdr> sections(elf_header.e_shnum);
+  std::memcpy(
+      sections.data(),
+      image.data() + elf_header.e_shoff,
+      sections.size() * sizeof(Elf64_Shdr)
+  );
+  auto contents = [&](const Elf64_Shdr &section) -> const char * {
+    if (section.sh_type == SHT_NOBITS ||
+        section.sh_offset + section.sh_size > image.size()) {
+      return nullptr;
+    }
+    return image.data() + section.sh_offset;
+  };
+  if (elf_header.e_shstrndx >= sections.size()) {
+    return;
+  }
+  const Elf64_Shdr &names = sections[elf_header.e_shstrndx];
+  const char *name_table = contents(names);
+
+  const Elf64_Shdr *symtab = nullptr;
+  const Elf64_Shdr *dynsym = nullptr;
+  const Elf64_Shdr *debug_line = nullptr;
+  const Elf64_Shdr *debug_line_str = nullptr;
+  const Elf64_Shdr *debug_str = nullptr;
+  for (const auto &section : sections) {
+    std::string name = StringAt(name_table, names.sh_size, section.sh_name);
+    if (section.sh_type == SHT_SYMTAB) {
+      symtab = &section;
+    } else if (section.sh_type == SHT_DYNSYM) {
+      dynsym = &section;
+    } else if ((section.sh_flags & SHF_COMPRESSED) != 0) {
+      continue; // compressed debug sections aren't supported
+    } else if (name == ".debug_line") {
+      debug_line = &section;
+    } else if (name == ".debug_line_str") {
+      debug_line_str = &section;
+    } else if (name == ".debug_str") {
+      debug_str = &section;
+    }
+  }
+
+  // Function symbols (the full table if not stripped)
+  const Elf64_Shdr *table = symtab != nullptr ? symtab : dynsym;
+  if (table != nullptr && table->sh_link < sections.size() &&
+      contents(*table) != nullptr) {
+    const Elf64_Shdr &strings = sections[table->sh_link];
+    const char *string_data = contents(strings);
+    size_t count = table->sh_size / sizeof(Elf64_Sym);
+    for (size_t i = 0; i < count; ++i) {
+      Elf64_Sym symbol;
+      std::memcpy(
+          &symbol,
+          contents(*table) + i * sizeof(Elf64_Sym),
+          sizeof(symbol)
+      );
+      if (ELF64_ST_TYPE(symbol.st_info) != STT_FUNC || symbol.st_value == 0) {
+        continue;
+      }
+      std::string name = StringAt(string_data, strings.sh_size, symbol.st_name);
+      symbols_.push_back(
+          {symbol.st_value,
+           symbol.st_value + std::max<uint64_t>(symbol.st_size, 1),
+           Demangle(name.c_str())}
+      );
+    }
+    std::sort(
+        symbols_.begin(),
+        symbols_.end(),
+        [](const Symbol &a, const Symbol &b) { return a.start < b.start; }
+    );
+  }
+
+  if (debug_line != nullptr && contents(*debug_line) != nullptr) {
+    auto data_of = [&](const Elf64_Shdr *section) -> const char * {
+      return section != nullptr ? contents(*section) : nullptr;
+    };
+    auto size_of = [&](const Elf64_Shdr *section) -> size_t {
+      return section != nullptr && contents(*section) != nullptr
+                 ? section->sh_size
+                 : 0;
+    };
+    LoadLineTable(
+        contents(*debug_line),
+        debug_line->sh_size,
+        data_of(debug_line_str),
+        size_of(debug_line_str),
+        data_of(debug_str),
+        size_of(debug_str)
+    );
+  }
+}
+
+void Symbolizer::LoadLineTable(
+    const char *data,
+    size_t size,
+    const char *line_strings,
+    size_t line_strings_size,
+    const char *strings,
+    size_t strings_size
+) {
+  ByteReader section(data, size);
+  while (!section.AtEnd()) {
+    // Unit header
+    LineHeader header;
+    uint64_t unit_length = section.Fixed(4);
+    if (unit_length == 0xffffffff) {
+      header.dwarf64 = true;
+      unit_length = section.Fixed(8);
+    }
+    size_t unit_start = section.offset();
+    if (section.failed() || unit_length > size - unit_start) {
+      break;
+    }
+    size_t unit_end = unit_start + unit_length;
+    ByteReader unit(data + unit_start, unit_length);
+    section.Skip(unit_length);
+
+    header.version = static_cast<uint16_t>(unit.Fixed(2));
+    if (header.version < 2 || header.version > 5) {
+      continue;
+    }
+    if (header.version >= 5) {
+      unit.Skip(2); // address and segment selector sizes
+    }
+    uint64_t header_length = unit.Fixed(header.dwarf64 ? 8 : 4);
+    size_t program_start = unit.offset() + header_length;
+    header.min_instruction_length = static_cast<uint8_t>(unit.Fixed(1));
+    if (header.version >= 4) {
+      unit.Skip(1); // maximum operations per instruction (VLIW only)
+    }
+    unit.Skip(1); // default is_stmt
+    header.line_base = static_cast<int8_t>(unit.Fixed(1));
+    header.line_range = static_cast<uint8_t>(unit.Fixed(1));
+    header.opcode_base = static_cast<uint8_t>(unit.Fixed(1));
+    for (int i = 1; i < header.opcode_base; ++i) {
+      header.standard_opcode_lengths.push_back(
+          static_cast<uint8_t>(unit.Fixed(1))
+      );
+    }
+    if (header.line_range == 0) {
+      continue;
+    }
+
+    // Directory and file tables, mapped to global indexes in files_
+    std::vector<std::string> directories;
+    std::vector<uint32_t> unit_files;
+    auto add_file = [&](const std::string &name, uint64_t directory) {
+      std::string path = directory < directories.size()
+                             ? JoinPath(directories[directory], name)
+                             : name;
+      unit_files.push_back(static_cast<uint32_t>(files_.size()));
+      files_.push_back(std::move(path));
+    };
+
+    if (header.version >= 5) {
+      auto read_formats = [&] {
+        std::vector<EntryFormat> formats(unit.Fixed(1));
+        for (auto &format : formats) {
+          format.content = unit.Uleb();
+          format.form = unit.Uleb();
+        }
+        return formats;
+      };
+      auto read_entry = [&](const std::vector<EntryFormat> &formats,
+                            std::string &path,
+                            uint64_t &directory) {
+        for (const auto &format : formats) {
+          std::string text;
+          uint64_t number = 0;
+          switch (format.form) {
+          case kFormString:
+            text = unit.CString();
+            break;
+          case kFormLineStrp:
+            text = StringAt(
+                line_strings,
+                line_strings_size,
+                unit.Fixed(header.dwarf64 ? 8 : 4)
+            );
+            break;
+          case kFormStrp:
+            text = StringAt(
+                strings,
+                strings_size,
+                unit.Fixed(header.dwarf64 ? 8 : 4)
+            );
+            break;
+          case kFormUdata:
+            number = unit.Uleb();
+            break;
+          case kFormData1:
+            number = unit.Fixed(1);
+            break;
+          case kFormData2:
+            number = unit.Fixed(2);
+            break;
+          case kFormData4:
+            number = unit.Fixed(4);
+            break;
+          case kFormData8:
+            number = unit.Fixed(8);
+            break;
+          case kFormData16:
+            unit.Skip(16);
+            break;
+          case kFormBlock:
+            unit.Skip(unit.Uleb());
+            break;
+          default:
+            return false; // can't size an unknown form
+          }
+          if (format.content == kPathContent) {
+            path = text;
+          } else if (format.content == kDirectoryIndexContent) {
+            directory = number;
+          }
+        }
+        return !unit.failed();
+      };
+
+      bool valid = true;
+      auto directory_formats = read_formats();
+      uint64_t directory_count = unit.Uleb();
+      for (uint64_t i = 0; valid && i < directory_count; ++i) {
+        std::string path;
+        uint64_t unused = 0;
+        valid = read_entry(directory_formats, path, unused);
+        directories.push_back(path);
+      }
+      auto file_formats = read_formats();
+      uint64_t file_count = unit.Uleb();
+      for (uint64_t i = 0; valid && i < file_count; ++i) {
+        std::string path;
+        uint64_t directory = 0;
+        valid = read_entry(file_formats, path, directory);
+        add_file(path, directory);
+      }
+      if (!valid) {
+        continue;
+      }
+    } else {
+      // Directory 0 is the compilation directory, which isn't listed here;
+      // file indexes start at 1
+      directories.emplace_back();
+      for (std::string directory = unit.CString(); !directory.empty();
+           directory = unit.CString()) {
+        directories.push_back(directory);
+      }
+      unit_files.push_back(static_cast<uint32_t>(files_.size()));
+      files_.emplace_back();
+      for (std::string name = unit.CString(); !name.empty();
+           name = unit.CString()) {
+        uint64_t directory = unit.Uleb();
+        unit.Uleb(); // modification time
+        unit.Uleb(); // length
+        add_file(name, directory);
+      }
+    }
+
+    // Line-number program
+    ByteReader program(data + unit_start, unit_end - unit_start);
+    program.Skip(program_start);
+    uint64_t address = 0;
+    uint64_t file = 1;
+    int64_t line = 1;
+    std::vector<LineRow> sequence;
+    auto emit = [&](bool end_sequence) {
+      uint32_t global_file = 0;
+      if (file < unit_files.size()) {
+        global_file = unit_files[file];
+      } else if (!unit_files.empty()) {
+        global_file = unit_files.front();
+      }
+      uint32_t row_line =
+          end_sequence ? 0 : static_cast<uint32_t>(std::max<int64_t>(line, 1));
+      sequence.push_back({address, global_file, row_line});
+    };
+    auto end_sequence = [&] {
+      emit(true);
+      // Sequences at address 0 belong to functions the linker discarded
+      if (!sequence.empty() && sequence.front().address != 0) {
+        rows_.insert(rows_.end(), sequence.begin(), sequence.end());
+      }
+      sequence.clear();
+      address = 0;
+      file = 1;
+      line = 1;
+    };
+
+    while (!program.AtEnd()) {
+      uint8_t opcode = static_cast<uint8_t>(program.Fixed(1));
+      if (opcode >= header.opcode_base) {
+        uint8_t adjusted = opcode - header.opcode_base;
+        address += static_cast<uint64_t>(adjusted / header.line_range) *
+                   header.min_instruction_length;
+        line += header.line_base + adjusted % header.line_range;
+        emit(false);
+        continue;
+      }
+      switch (opcode) {
+      case 0: {
+        uint64_t length = program.Uleb();
+        if (length == 0) {
+          break;
+        }
+        size_t next = program.offset() + length;
+        uint8_t extended = static_cast<uint8_t>(program.Fixed(1));
+        if (extended == kLineEndSequence) {
+          end_sequence();
+        } else if (extended == kLineSetAddress) {
+          address = program.Fixed(length - 1);
+        } else if (extended == kLineDefineFile) {
+          std::string name = program.CString();
+          uint64_t directory = program.Uleb();
+          add_file(name, directory);
+        }
+        if (next > program.offset()) {
+          program.Skip(next - program.offset());
+        }
+        break;
+      }
+      case kLineCopy:
+        emit(false);
+        break;
+      case kLineAdvancePc:
+        address += program.Uleb() * header.min_instruction_length;
+        break;
+      case kLineAdvanceLine:
+        line += program.Sleb();
+        break;
+      case kLineSetFile:
+        file = program.Uleb();
+        break;
+      case kLineConstAddPc:
+        address += static_cast<uint64_t>(
+                       (255 - header.opcode_base) / header.line_range
+                   ) *
+                   header.min_instruction_length;
+        break;
+      case kLineFixedAdvancePc:
+        address += program.Fixed(2);
+        break;
+      default:
+        // Standard opcodes without state we need (column, is_stmt, ...)
+        for (int i = 0; i < header.standard_opcode_lengths[opcode - 1]; ++i) {
+          program.Uleb();
+        }
+        break;
+      }
+    }
+  }
+
+  // A sequence may start where another ends; its first row must win
+  std::stable_sort(
+      rows_.begin(),
+      rows_.end(),
+      [](const LineRow &a, const LineRow &b) {
+        return std::pair(a.address, a.line != 0) <
+               std::pair(b.address, b.line != 0);
+      }
+  );
+}
+
+bool Symbolizer::InExecutable(uint64_t address) const {
+  return address >= executable_start_ && address < executable_end_;
+}
+
+SourceLocation Symbolizer::Resolve(uint64_t address) const {
+  SourceLocation location;
+  if (InExecutable(address)) {
+    uint64_t link_address = address - load_bias_;
+
+    auto symbol = std::upper_bound(
+        symbols_.begin(),
+        symbols_.end(),
+        link_address,
+        [](uint64_t value, const Symbol &s) { return value < s.start; }
+    );
+    if (symbol != symbols_.begin() && link_address < std::prev(symbol)->end) {
+      location.function = std::prev(symbol)->name;
+    } else {
+      location.function =
+          HexOffset(Basename(executable_path_), link_address);
+    }
+
+    auto row = std::upper_bound(
+        rows_.begin(),
+        rows_.end(),
+        link_address,
+        [](uint64_t value, const LineRow &r) { return value < r.address; }
+    );
+    if (row != rows_.begin() && std::prev(row)->line != 0) {
+      location.file = files_[std::prev(row)->file];
+      location.line = std::prev(row)->line;
+    }
+    return location;
+  }
+
+  Dl_info info;
+  if (dladdr(reinterpret_cast<void *>(address), &info) != 0) {
+    if (info.dli_sname != nullptr) {
+      location.function = Demangle(info.dli_sname);
+    } else {
+      location.function = HexOffset(
+          Basename(info.dli_fname != nullptr ? info.dli_fname : "?"),
+          address - reinterpret_cast<uint64_t>(info.dli_fbase)
+      );
+    }
+    return location;
+  }
+  location.function = HexOffset("?", address);
+  return location;
+}
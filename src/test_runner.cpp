@@ -1,7 +1,17 @@
 
 #include "test_runner.hpp"
+#include "adaptive_dispatch.hpp"
 #include "benchmark_utils.hpp"
+#include "calibration.hpp"
+#include "cold_start.hpp"
+#include "double_dispatch.hpp"
+#include "expression_interpreter.hpp"
+#include "footprint.hpp"
+#include "intensity_sweep.hpp"
+#include "object_layout.hpp"
+#include "parallel_dispatch.hpp"
 #include "polymorphism_tests.hpp"
+#include "stream_buffers.hpp"
 #include <chrono>
 #include <filesystem>
 #include <fstream>
@@ -31,21 +41,96 @@ const std::unordered_map<std::string, std::unordered_map<std::string, TestCase>>
                   polymorphism_tests::TestRuntimeFMA}},
                 {"expensive",
                  {"polymorphism_tests::TestRuntimeExpensive",
-                  polymorphism_tests::TestRuntimeExpensive}}}},
+                  polymorphism_tests::TestRuntimeExpensive}},
+                {"approx_low",
+                 {"polymorphism_tests::TestRuntimeExpensiveApprox<Accuracy::kLow>",
+                  polymorphism_tests::TestRuntimeExpensiveApprox<Accuracy::kLow>}},
+                {"approx_medium",
+                 {"polymorphism_tests::TestRuntimeExpensiveApprox<Accuracy::kMedium>",
+                  polymorphism_tests::TestRuntimeExpensiveApprox<Accuracy::kMedium>}},
+                {"approx_high",
+                 {"polymorphism_tests::TestRuntimeExpensiveApprox<Accuracy::kHigh>",
+                  polymorphism_tests::TestRuntimeExpensiveApprox<Accuracy::kHigh>}},
+                {"triad",
+                 {"polymorphism_tests::TestRuntimeTriad",
+                  polymorphism_tests::TestRuntimeTriad,
+                  PrepareStreamBuffers}},
+                {"dot",
+                 {"polymorphism_tests::TestRuntimeDot",
+                  polymorphism_tests::TestRuntimeDot,
+                  PrepareStreamBuffers}},
+                {"stencil",
+                 {"polymorphism_tests::TestRuntimeStencil",
+                  polymorphism_tests::TestRuntimeStencil,
+                  PrepareStreamBuffers}},
+                {"gather",
+                 {"polymorphism_tests::TestRuntimeGather",
+                  polymorphism_tests::TestRuntimeGather,
+                  PrepareStreamBuffers}}}},
               {"crtp",
                {{"fma",
                  {"polymorphism_tests::TestCRTPFMA",
                   polymorphism_tests::TestCRTPFMA}},
                 {"expensive",
                  {"polymorphism_tests::TestCRTPExpensive",
-                  polymorphism_tests::TestCRTPExpensive}}}},
+                  polymorphism_tests::TestCRTPExpensive}},
+                {"approx_low",
+                 {"polymorphism_tests::TestCRTPExpensiveApprox<Accuracy::kLow>",
+                  polymorphism_tests::TestCRTPExpensiveApprox<Accuracy::kLow>}},
+                {"approx_medium",
+                 {"polymorphism_tests::TestCRTPExpensiveApprox<Accuracy::kMedium>",
+                  polymorphism_tests::TestCRTPExpensiveApprox<Accuracy::kMedium>}},
+                {"approx_high",
+                 {"polymorphism_tests::TestCRTPExpensiveApprox<Accuracy::kHigh>",
+                  polymorphism_tests::TestCRTPExpensiveApprox<Accuracy::kHigh>}},
+                {"triad",
+                 {"polymorphism_tests::TestCRTPTriad",
+                  polymorphism_tests::TestCRTPTriad,
+                  PrepareStreamBuffers}},
+                {"dot",
+                 {"polymorphism_tests::TestCRTPDot",
+                  polymorphism_tests::TestCRTPDot,
+                  PrepareStreamBuffers}},
+                {"stencil",
+                 {"polymorphism_tests::TestCRTPStencil",
+                  polymorphism_tests::TestCRTPStencil,
+                  PrepareStreamBuffers}},
+                {"gather",
+                 {"polymorphism_tests::TestCRTPGather",
+                  polymorphism_tests::TestCRTPGather,
+                  PrepareStreamBuffers}}}},
               {"concepts",
                {{"fma",
                  {"polymorphism_tests::TestConceptsFMA",
                   polymorphism_tests::TestConceptsFMA}},
                 {"expensive",
                  {"polymorphism_tests::TestConceptsExpensive",
-                  polymorphism_tests::TestConceptsExpensive}}}}};
+                  polymorphism_tests::TestConceptsExpensive}},
+                {"approx_low",
+                 {"polymorphism_tests::TestConceptsExpensiveApprox<Accuracy::kLow>",
+                  polymorphism_tests::TestConceptsExpensiveApprox<Accuracy::kLow>}},
+                {"approx_medium",
+                 {"polymorphism_tests::TestConceptsExpensiveApprox<Accuracy::kMedium>",
+                  polymorphism_tests::TestConceptsExpensiveApprox<Accuracy::kMedium>}},
+                {"approx_high",
+                 {"polymorphism_tests::TestConceptsExpensiveApprox<Accuracy::kHigh>",
+                  polymorphism_tests::TestConceptsExpensiveApprox<Accuracy::kHigh>}},
+                {"triad",
+                 {"polymorphism_tests::TestConceptsTriad",
+                  polymorphism_tests::TestConceptsTriad,
+                  PrepareStreamBuffers}},
+                {"dot",
+                 {"polymorphism_tests::TestConceptsDot",
+                  polymorphism_tests::TestConceptsDot,
+                  PrepareStreamBuffers}},
+                {"stencil",
+                 {"polymorphism_tests::TestConceptsStencil",
+                  polymorphism_tests::TestConceptsStencil,
+                  PrepareStreamBuffers}},
+                {"gather",
+                 {"polymorphism_tests::TestConceptsGather",
+                  polymorphism_tests::TestConceptsGather,
+                  PrepareStreamBuffers}}}}};
 
   return test_case_map;
 }
@@ -71,6 +156,57 @@ const TestCase &GetSingleTestCase(
   return comp_it->second;
 }
 
+// Retrieve the scenario map
+const std::unordered_map<std::string, TestCase> &GetScenarioMap() {
+  static const std::unordered_map<std::string, TestCase> scenario_map = {
+      {"adaptive_dispatch",
+       {"adaptive_dispatch::RunAdaptiveDispatchBenchmark",
+        adaptive_dispatch::RunAdaptiveDispatchBenchmark}},
+      {"footprint",
+       {"footprint::RunFootprintBenchmark",
+        footprint::RunFootprintBenchmark}},
+      {"cold_start",
+       {"cold_start::RunColdStartBenchmark",
+        cold_start::RunColdStartBenchmark}},
+      {"parallel_dispatch",
+       {"parallel_dispatch::RunParallelDispatchBenchmark",
+        parallel_dispatch::RunParallelDispatchBenchmark}},
+      {"double_dispatch",
+       {"double_dispatch::RunDoubleDispatchBenchmark",
+        double_dispatch::RunDoubleDispatchBenchmark}},
+      {"intensity_sweep",
+       {"intensity_sweep::RunIntensitySweepBenchmark",
+        intensity_sweep::RunIntensitySweepBenchmark}},
+      {"expression_interpreter",
+       {"expression_interpreter::RunExpressionBenchmark",
+        expression_interpreter::RunExpressionBenchmark}},
+      {"calibration",
+       {"calibration::RunCalibrationBenchmark",
+        calibration::RunCalibrationBenchmark}},
+      {"object_layout",
+       {"object_layout::RunObjectLayoutBenchmark",
+        object_layout::RunObjectLayoutBenchmark}},
+  };
+  return scenario_map;
+}
+
+const TestCase &GetScenarioTestCase(const std::string &scenario) {
+  const auto &scenario_map = GetScenarioMap();
+
+  auto it = scenario_map.find(scenario);
+  if (it == scenario_map.end()) {
+    throw std::invalid_argument("Invalid scenario: " + scenario);
+  }
+  return it->second;
+}
+
+// Run a scenario
+std::chrono::duration<double>
+RunScenario(const std::string &scenario, size_t iterations) {
+  TRACE_SCOPE("RunScenario");
+  return RunTestCase(GetScenarioTestCase(scenario), iterations);
+}
+
 // Run a single test
 std::chrono::duration<double> RunSingleTest(
     const std::string &polymorphism_category,
@@ -78,6 +214,7 @@ std::chrono::duration<double> RunSingleTest(
     size_t iterations,
     bool write_to_file
 ) {
+  TRACE_SCOPE("RunSingleTest");
   const auto &test_case =
       GetSingleTestCase(polymorphism_category, computation_label);
 
@@ -99,6 +236,7 @@ std::chrono::duration<double> RunSingleTest(
 
 // Run all tests
 void RunAndSaveAllTests(size_t iterations) {
+  TRACE_SCOPE("RunAndSaveAllTests");
 
   // Define output directory
   std::string output_dir = "data/run_all_tests_results/";
@@ -133,6 +271,7 @@ void RunAndSaveAllTests(size_t iterations) {
 }
 
 void RunAllTestsWithoutSaving(size_t iterations) {
+  TRACE_SCOPE("RunAllTestsWithoutSaving");
   // For each inner entry in nested map, run test
   const auto &test_case_map = GetTestCaseMap();
   for (const auto &[polymorphism_type, inner_map] : test_case_map) {
@@ -0,0 +1,178 @@
+#include "thread_scaling.hpp"
+#include "thread_utils.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <latch>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace thread_scaling {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kSlotsPerLine = kCacheLineSize / sizeof(double);
+
+using SharedLine = CacheLinePadded<std::array<double, kSlotsPerLine>>;
+
+} // namespace
+
+std::string SinkLayoutName(SinkLayout layout) {
+  switch (layout) {
+  case SinkLayout::kPadded:
+    return "padded";
+  case SinkLayout::kShared:
+    return "shared";
+  }
+  return "unknown";
+}
+
+ThreadScalingOptions &GetThreadScalingOptions() {
+  static ThreadScalingOptions options;
+  return options;
+}
+
+bool SupportsThreadScaling(const TestCase &test_case) {
+  return test_case.prepare == nullptr;
+}
+
+ScalingResult RunConcurrently(
+    const TestCase &test_case,
+    size_t iterations,
+    size_t threads,
+    SinkLayout layout
+) {
+  TRACE_SCOPE("RunConcurrently");
+  if (!SupportsThreadScaling(test_case)) {
+    throw std::invalid_argument(
+        "Thread scaling doesn't support " + test_case.name
+    );
+  }
+  std::vector<CacheLinePadded<double>> padded_slots(threads);
+  std::vector<SharedLine> shared_lines(
+      (threads + kSlotsPerLine - 1) / kSlotsPerLine
+  );
+  auto slot = [&](size_t thread) -> volatile double * {
+    if (layout == SinkLayout::kShared) {
+      return &shared_lines[thread / kSlotsPerLine]
+                  .value[thread % kSlotsPerLine];
+    }
+    return &padded_slots[thread].value;
+  };
+
+  std::vector<CacheLinePadded<Clock::time_point>> finished(threads);
+  std::vector<CacheLinePadded<bool>> pinned(threads);
+  std::latch ready(static_cast<std::ptrdiff_t>(threads));
+  std::latch start(1);
+
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  for (size_t t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      pinned[t].value = PinCurrentThread(t);
+      BenchmarkSink &sink = GetThreadBenchmarkSink();
+      sink.target = slot(t);
+      sink.store_every_iteration = true;
+      sink.print_time = false;
+
+      ready.count_down();
+      start.wait();
+      test_case.function(iterations);
+      finished[t].value = Clock::now();
+    });
+  }
+
+  ready.wait();
+  Clock::time_point released = Clock::now();
+  start.count_down();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  ScalingResult result{};
+  result.threads = threads;
+  result.layout = layout;
+  result.calls = threads * iterations;
+  result.fastest_thread_seconds = std::numeric_limits<double>::max();
+  result.pinned = threads <= HardwareThreadCount();
+  for (size_t t = 0; t < threads; ++t) {
+    double seconds =
+        std::chrono::duration<double>(finished[t].value - released).count();
+    result.wall_seconds = std::max(result.wall_seconds, seconds);
+    result.fastest_thread_seconds =
+        std::min(result.fastest_thread_seconds, seconds);
+    result.pinned = result.pinned && pinned[t].value;
+  }
+  result.slowest_thread_seconds = result.wall_seconds;
+  return result;
+}
+
+void WriteScalingTable(
+    std::ostream &out,
+    const std::vector<ScalingResult> &results
+) {
+  out << "| Sink | Threads | Pinned | Wall (s) | Throughput (M calls/s) | "
+         "Efficiency (%) | Slowest / Fastest Thread |\n";
+  out << "|------|------|------|------|------|------|------|\n";
+  for (const auto &result : results) {
+    auto baseline = std::find_if(
+        results.begin(),
+        results.end(),
+        [&](const ScalingResult &other) {
+          return other.layout == result.layout && other.threads == 1;
+        }
+    );
+    double efficiency =
+        baseline != results.end()
+            ? result.CallsPerSecond() /
+                  (result.threads * baseline->CallsPerSecond())
+            : 0.0;
+
+    out << "| " << SinkLayoutName(result.layout) << " | " << result.threads
+        << " | " << (result.pinned ? "yes" : "no") << " | " << std::fixed
+        << std::setprecision(3) << result.wall_seconds << " | "
+        << std::setprecision(2) << result.CallsPerSecond() / 1e6 << " | "
+        << efficiency * 100 << " | "
+        << result.slowest_thread_seconds / result.fastest_thread_seconds
+        << " |\n";
+    out.unsetf(std::ios::fixed);
+  }
+}
+
+void RunThreadScaling(
+    const TestCase &test_case,
+    size_t iterations,
+    const ThreadScalingOptions &options
+) {
+  TRACE_SCOPE("RunThreadScaling");
+  std::cout << "Running: " << test_case.name << " on up to "
+            << options.threads << " threads" << std::endl;
+  std::cout << "Iteration Count: " << iterations << " per thread"
+            << std::endl;
+  std::cout << "Compiler Flags: " << COMPILER_FLAGS << std::endl;
+  std::cout << "Available CPUs: " << HardwareThreadCount() << std::endl
+            << std::endl;
+
+  std::vector<SinkLayout> layouts = {SinkLayout::kPadded};
+  if (options.shared_sink) {
+    layouts.push_back(SinkLayout::kShared);
+  }
+
+  std::vector<ScalingResult> results;
+  for (SinkLayout layout : layouts) {
+    for (size_t threads : ThreadCountSweep(options.threads)) {
+      results.push_back(
+          RunConcurrently(test_case, iterations, threads, layout)
+      );
+    }
+  }
+  WriteScalingTable(std::cout, results);
+  std::cout << std::endl;
+}
+
+} // namespace thread_scaling
@@ -0,0 +1,121 @@
+#include "thread_utils.hpp"
+#include <algorithm>
+#include <thread>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#ifdef __linux__
+namespace {
+
+std::vector<int> CurrentThreadCpus() {
+  std::vector<int> cpus;
+  cpu_set_t set;
+  if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+    return cpus;
+  }
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &set)) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+bool SetCurrentThreadCpus(const std::vector<int> &cpus) {
+  if (cpus.empty()) {
+    return false;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    CPU_SET(cpu, &set);
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+} // namespace
+#endif
+
+const std::vector<int> &ProcessCpus() {
+#ifdef __linux__
+  static const std::vector<int> cpus = [] {
+    std::vector<int> allowed;
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+      for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &set)) {
+          allowed.push_back(cpu);
+        }
+      }
+    }
+    return allowed;
+  }();
+#else
+  static const std::vector<int> cpus;
+#endif
+  return cpus;
+}
+
+size_t HardwareThreadCount() {
+  if (!ProcessCpus().empty()) {
+    return ProcessCpus().size();
+  }
+  return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+bool PinCurrentThread(size_t cpu_index) {
+#ifdef __linux__
+  const auto &cpus = ProcessCpus();
+  if (cpus.empty()) {
+    return false;
+  }
+  return SetCurrentThreadCpus({cpus[cpu_index % cpus.size()]});
+#else
+  (void)cpu_index;
+  return false;
+#endif
+}
+
+ScopedThreadPin::ScopedThreadPin(size_t cpu_index) {
+#ifdef __linux__
+  previous_cpus_ = CurrentThreadCpus();
+  if (previous_cpus_.empty()) {
+    return;
+  }
+#endif
+  pinned_ = PinCurrentThread(cpu_index);
+}
+
+ScopedThreadPin::~ScopedThreadPin() {
+#ifdef __linux__
+  if (pinned_) {
+    SetCurrentThreadCpus(previous_cpus_);
+  }
+#endif
+}
+
+ScopedProcessAffinity::ScopedProcessAffinity() {
+#ifdef __linux__
+  previous_cpus_ = CurrentThreadCpus();
+  widened_ = !previous_cpus_.empty() && SetCurrentThreadCpus(ProcessCpus());
+#endif
+}
+
+ScopedProcessAffinity::~ScopedProcessAffinity() {
+#ifdef __linux__
+  if (widened_) {
+    SetCurrentThreadCpus(previous_cpus_);
+  }
+#endif
+}
+
+std::vector<size_t> ThreadCountSweep(size_t max_threads) {
+  std::vector<size_t> counts;
+  for (size_t count = 1; count < max_threads; count *= 2) {
+    counts.push_back(count);
+  }
+  counts.push_back(std::max<size_t>(max_threads, 1));
+  return counts;
+}
@@ -0,0 +1,128 @@
+#include "trace.hpp"
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <unistd.h>
+#include <unordered_set>
+#include <vector>
+
+namespace trace {
+
+namespace {
+
+// Registry of all thread buffers. Only touched when a thread records its
+// first event and when the trace is written, never on the recording path.
+struct BufferRegistry {
+  std::mutex mutex;
+  std::vector<std::unique_ptr<ThreadTraceBuffer>> buffers;
+};
+
+BufferRegistry &GetRegistry() {
+  static BufferRegistry registry;
+  return registry;
+}
+
+void WriteJsonString(std::ofstream &outfile, const char *text) {
+  outfile << '"';
+  for (const char *c = text; *c != '\0'; ++c) {
+    switch (*c) {
+    case '"':
+      outfile << "\\\"";
+      break;
+    case '\\':
+      outfile << "\\\\";
+      break;
+    case '\n':
+      outfile << "\\n";
+      break;
+    default:
+      outfile << *c;
+    }
+  }
+  outfile << '"';
+}
+
+} // namespace
+
+uint64_t NowNs() {
+  static const auto epoch = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - epoch
+  )
+      .count();
+}
+
+const char *Intern(const std::string &name) {
+  static std::mutex mutex;
+  static std::unordered_set<std::string> names;
+  std::lock_guard<std::mutex> lock(mutex);
+  return names.insert(name).first->c_str();
+}
+
+ThreadTraceBuffer &GetThreadBuffer() {
+  thread_local ThreadTraceBuffer *buffer = [] {
+    auto &registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto thread_id = static_cast<uint32_t>(registry.buffers.size() + 1);
+    registry.buffers.push_back(std::make_unique<ThreadTraceBuffer>(thread_id));
+    return registry.buffers.back().get();
+  }();
+  return *buffer;
+}
+
+void ResetTrace() {
+  auto &registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  for (auto &buffer : registry.buffers) {
+    buffer->Clear();
+  }
+}
+
+bool WriteChromeTrace(const std::string &filepath) {
+  std::ofstream outfile(filepath);
+  if (!outfile) {
+    return false;
+  }
+
+  auto &registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  const auto pid = static_cast<long>(getpid());
+
+  outfile << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  auto separator = [&]() {
+    if (!first) {
+      outfile << ",";
+    }
+    first = false;
+    outfile << "\n";
+  };
+
+  outfile.setf(std::ios::fixed);
+  outfile.precision(3);
+  for (const auto &buffer : registry.buffers) {
+    separator();
+    outfile << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+            << ",\"tid\":" << buffer->thread_id()
+            << ",\"args\":{\"name\":\"thread " << buffer->thread_id()
+            << "\",\"dropped_events\":" << buffer->dropped() << "}}";
+
+    buffer->ForEach([&](const TraceEvent &event) {
+      separator();
+      outfile << "{\"name\":";
+      WriteJsonString(outfile, event.name);
+      outfile << ",\"cat\":\"benchmark\",\"ph\":\"X\",\"pid\":" << pid
+              << ",\"tid\":" << buffer->thread_id()
+              << ",\"ts\":" << static_cast<double>(event.start_ns) / 1000.0
+              << ",\"dur\":"
+              << static_cast<double>(event.end_ns - event.start_ns) / 1000.0
+              << "}";
+    });
+  }
+  outfile << "\n]}\n";
+
+  return static_cast<bool>(outfile);
+}
+
+} // namespace trace
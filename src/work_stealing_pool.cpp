@@ -0,0 +1,167 @@
+#include "work_stealing_pool.hpp"
+#include <algorithm>
+
+namespace {
+
+double ElapsedNs(
+    std::chrono::steady_clock::time_point start,
+    std::chrono::steady_clock::time_point end
+) {
+  return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(size_t num_threads, bool pin_threads)
+    : queues_(std::max<size_t>(num_threads, 1)), stats_(queues_.size()) {
+  for (size_t worker = 1; worker < queues_.size(); ++worker) {
+    threads_.emplace_back([this, worker, pin_threads] {
+      if (pin_threads) {
+        PinCurrentThread(worker);
+      }
+      WorkerLoop(worker);
+    });
+  }
+  // Last, so the workers are created with the caller's full mask
+  if (pin_threads) {
+    caller_pin_ = std::make_unique<ScopedThreadPin>(0);
+  }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  job_ready_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+ParallelForStats WorkStealingPool::ParallelFor(
+    size_t n,
+    size_t chunk_size,
+    Schedule schedule,
+    const Body &body
+) {
+  chunk_size = std::max<size_t>(chunk_size, 1);
+  size_t num_workers = queues_.size();
+  size_t num_chunks = (n + chunk_size - 1) / chunk_size;
+
+  // Contiguous block of chunks per worker, like schedule(static)
+  for (size_t worker = 0; worker < num_workers; ++worker) {
+    size_t first = num_chunks * worker / num_workers;
+    size_t last = num_chunks * (worker + 1) / num_workers;
+    auto &queue = queues_[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    for (size_t chunk = first; chunk < last; ++chunk) {
+      queue.ranges.push_back(
+          {chunk * chunk_size, std::min(n, (chunk + 1) * chunk_size)}
+      );
+    }
+  }
+  for (auto &stats : stats_) {
+    stats.value = WorkerStats{};
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    body_ = &body;
+    schedule_ = schedule;
+    workers_finished_ = 0;
+    job_start_ = std::chrono::steady_clock::now();
+    ++generation_;
+  }
+  job_ready_.notify_all();
+
+  RunWorker(0);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  job_done_.wait(lock, [&] { return workers_finished_ == num_workers - 1; });
+  auto job_end = std::chrono::steady_clock::now();
+  body_ = nullptr;
+
+  ParallelForStats result;
+  result.wall_ns = ElapsedNs(job_start_, job_end);
+  for (const auto &stats : stats_) {
+    result.workers.push_back(stats.value);
+  }
+  for (auto &worker : result.workers) {
+    worker.idle_ns = std::max(result.wall_ns - worker.busy_ns, 0.0);
+  }
+  return result;
+}
+
+void WorkStealingPool::WorkerLoop(size_t worker) {
+  size_t seen_generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      job_ready_.wait(lock, [&] {
+        return stopping_ || generation_ != seen_generation;
+      });
+      if (stopping_) {
+        return;
+      }
+      seen_generation = generation_;
+    }
+
+    RunWorker(worker);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++workers_finished_;
+    }
+    job_done_.notify_one();
+  }
+}
+
+void WorkStealingPool::RunWorker(size_t worker) {
+  auto &stats = stats_[worker].value;
+  Range range;
+  while (true) {
+    bool found = PopOwn(worker, range);
+    if (!found && schedule_ == Schedule::kWorkStealing) {
+      found = Steal(worker, range);
+      stats.steals += found ? 1 : 0;
+    }
+    if (!found) {
+      // Every chunk was queued before the job started, so empty queues
+      // everywhere mean this worker is done
+      return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    (*body_)(range.begin, range.end, worker);
+    stats.busy_ns += ElapsedNs(start, std::chrono::steady_clock::now());
+    ++stats.chunks;
+  }
+}
+
+// Owners work front to back through their block
+bool WorkStealingPool::PopOwn(size_t worker, Range &range) {
+  auto &queue = queues_[worker];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.ranges.empty()) {
+    return false;
+  }
+  range = queue.ranges.front();
+  queue.ranges.pop_front();
+  return true;
+}
+
+// Thieves take from the back, away from where the owner is working
+bool WorkStealingPool::Steal(size_t thief, Range &range) {
+  size_t num_workers = queues_.size();
+  for (size_t offset = 1; offset < num_workers; ++offset) {
+    auto &queue = queues_[(thief + offset) % num_workers];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.ranges.empty()) {
+      range = queue.ranges.back();
+      queue.ranges.pop_back();
+      return true;
+    }
+  }
+  return false;
+}
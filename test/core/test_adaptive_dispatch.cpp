@@ -0,0 +1,118 @@
+#include "adaptive_dispatch.hpp"
+#include <memory>
+#include <random>
+#include <vector>
+#include <gtest/gtest.h>
+
+using adaptive_dispatch::AdaptiveDispatcher;
+using adaptive_dispatch::DispatchItem;
+using adaptive_dispatch::Strategy;
+using runtime_polymorphism::PolyExpensive;
+using runtime_polymorphism::PolyFMA;
+
+class AdaptiveDispatchTest : public ::testing::Test {
+protected:
+  static constexpr size_t kNumItems = 1 << 15;
+
+  // Items where each object is a PolyFMA with probability fma_share
+  std::vector<DispatchItem> MakeItems(double fma_share) {
+    std::mt19937_64 rng{7};
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<DispatchItem> items;
+    for (size_t i = 0; i < kNumItems; ++i) {
+      const RuntimeBase *object = unit(rng) < fma_share
+                                      ? static_cast<const RuntimeBase *>(&fma_)
+                                      : &expensive_;
+      items.push_back({object, 1.0 + unit(rng)});
+    }
+    return items;
+  }
+
+  using RuntimeBase = runtime_polymorphism::RuntimeBase;
+  PolyFMA fma_;
+  PolyExpensive expensive_;
+};
+
+TEST_F(AdaptiveDispatchTest, TypeIndex_FindsListedTypes) {
+  EXPECT_EQ((adaptive_dispatch::TypeIndex<PolyFMA, PolyExpensive>(fma_)), 0);
+  EXPECT_EQ(
+      (adaptive_dispatch::TypeIndex<PolyFMA, PolyExpensive>(expensive_)),
+      1
+  );
+  EXPECT_EQ((adaptive_dispatch::TypeIndex<PolyFMA>(expensive_)), 1);
+}
+
+TEST_F(AdaptiveDispatchTest, VtableOf_MatchesObjectsOfThatTypeOnly) {
+  EXPECT_EQ(
+      adaptive_dispatch::VtableOf<PolyFMA>(),
+      adaptive_dispatch::VptrOf(fma_)
+  );
+  EXPECT_EQ(
+      adaptive_dispatch::VtableOf<PolyExpensive>(),
+      adaptive_dispatch::VptrOf(expensive_)
+  );
+  EXPECT_NE(
+      adaptive_dispatch::VtableOf<PolyFMA>(),
+      adaptive_dispatch::VptrOf(expensive_)
+  );
+}
+
+TEST_F(AdaptiveDispatchTest, AllStrategies_ProduceSameSum) {
+  auto items = MakeItems(0.5);
+  double expected = adaptive_dispatch::EvaluateVirtual(items);
+
+  EXPECT_DOUBLE_EQ(adaptive_dispatch::EvaluateGuarded<PolyFMA>(items), expected);
+  EXPECT_DOUBLE_EQ(
+      adaptive_dispatch::EvaluateGuarded<PolyExpensive>(items),
+      expected
+  );
+
+  adaptive_dispatch::SortedBatcher<PolyFMA, PolyExpensive> batcher;
+  EXPECT_NEAR(batcher.Evaluate(items), expected, 1e-9 * std::abs(expected));
+
+  // Types not listed in the batcher still go through the vtable
+  adaptive_dispatch::SortedBatcher<PolyFMA> partial_batcher;
+  EXPECT_NEAR(
+      partial_batcher.Evaluate(items),
+      expected,
+      1e-9 * std::abs(expected)
+  );
+}
+
+TEST_F(AdaptiveDispatchTest, DominantType_SelectsGuarded) {
+  auto items = MakeItems(0.97);
+  AdaptiveDispatcher<PolyFMA, PolyExpensive> dispatcher;
+  dispatcher.Evaluate(items);
+
+  EXPECT_EQ(dispatcher.strategy(), Strategy::kGuarded);
+  EXPECT_EQ(dispatcher.dominant_index(), 0);
+}
+
+TEST_F(AdaptiveDispatchTest, MixedTypes_SelectsSortedBatch) {
+  auto items = MakeItems(0.5);
+  AdaptiveDispatcher<PolyFMA, PolyExpensive> dispatcher;
+  dispatcher.Evaluate(items);
+
+  EXPECT_EQ(dispatcher.strategy(), Strategy::kSortedBatch);
+}
+
+TEST_F(AdaptiveDispatchTest, ShiftingMix_SwitchesStrategy) {
+  AdaptiveDispatcher<PolyFMA, PolyExpensive> dispatcher;
+  dispatcher.Evaluate(MakeItems(0.97));
+  ASSERT_EQ(dispatcher.strategy(), Strategy::kGuarded);
+
+  dispatcher.Evaluate(MakeItems(0.03));
+  EXPECT_EQ(dispatcher.strategy(), Strategy::kGuarded);
+  EXPECT_EQ(dispatcher.dominant_index(), 1);
+  EXPECT_EQ(dispatcher.num_switches(), 2);
+}
+
+TEST_F(AdaptiveDispatchTest, UnlistedTypes_SelectVirtual) {
+  auto items = MakeItems(0.5);
+  AdaptiveDispatcher<PolyFMA> dispatcher(
+      {.sample_stride = 1, .samples_per_decision = 64, .batch_threshold = 0.9}
+  );
+  dispatcher.Evaluate(items);
+
+  EXPECT_EQ(dispatcher.strategy(), Strategy::kVirtual);
+}
@@ -0,0 +1,90 @@
+#include "approx_math.hpp"
+#include "math_functions.hpp"
+#include <cmath>
+#include <sstream>
+#include <gtest/gtest.h>
+
+class ApproxMathTest : public ::testing::Test {
+protected:
+  static constexpr size_t kNumSamples = 100'000;
+  static constexpr double kTargetError = 1e-7;
+
+  static double LibmSin(double x) { return std::sin(x); }
+  static double LibmLog(double x) { return std::log(x); }
+  static double LibmSqrt(double x) { return std::sqrt(x); }
+};
+
+TEST_F(ApproxMathTest, HighAccuracy_MeetsTargetError) {
+  constexpr auto kHigh = Accuracy::kHigh;
+  EXPECT_LT(
+      MeasureAccuracy(ApproxSin<kHigh>, LibmSin, -100, 100, kNumSamples)
+          .max_error,
+      kTargetError
+  );
+  EXPECT_LT(
+      MeasureAccuracy(ApproxLog<kHigh>, LibmLog, 1e-3, 1e3, kNumSamples)
+          .max_error,
+      kTargetError
+  );
+  EXPECT_LT(
+      MeasureAccuracy(ApproxSqrt<kHigh>, LibmSqrt, 0, 1e3, kNumSamples)
+          .max_error,
+      kTargetError
+  );
+  EXPECT_LT(
+      MeasureAccuracy(
+          ComputeExpensiveApprox<kHigh>,
+          ComputeExpensive,
+          0,
+          100,
+          kNumSamples
+      )
+          .max_error,
+      kTargetError
+  );
+}
+
+TEST_F(ApproxMathTest, AccuracyLevels_AreOrdered) {
+  auto low = MeasureAccuracy(
+      ComputeExpensiveApprox<Accuracy::kLow>,
+      ComputeExpensive,
+      0,
+      100,
+      kNumSamples
+  );
+  auto medium = MeasureAccuracy(
+      ComputeExpensiveApprox<Accuracy::kMedium>,
+      ComputeExpensive,
+      0,
+      100,
+      kNumSamples
+  );
+  auto high = MeasureAccuracy(
+      ComputeExpensiveApprox<Accuracy::kHigh>,
+      ComputeExpensive,
+      0,
+      100,
+      kNumSamples
+  );
+  EXPECT_GT(low.max_error, medium.max_error);
+  EXPECT_GT(medium.max_error, high.max_error);
+}
+
+TEST_F(ApproxMathTest, ExactInputs) {
+  EXPECT_EQ(ApproxSqrt<Accuracy::kHigh>(0.0), 0.0);
+  EXPECT_NEAR(ApproxLog<Accuracy::kHigh>(1.0), 0.0, kTargetError);
+  EXPECT_NEAR(ApproxSin<Accuracy::kHigh>(0.0), 0.0, kTargetError);
+}
+
+TEST_F(ApproxMathTest, PrintAccuracyReport_ListsAllLevels) {
+  std::ostringstream report;
+  PrintAccuracyReport(report);
+  EXPECT_TRUE(report.str().find("| low | sin |") != std::string::npos);
+  EXPECT_TRUE(report.str().find("| medium | log |") != std::string::npos);
+  EXPECT_TRUE(report.str().find("| high | expensive |") != std::string::npos);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,206 @@
+#include "benchmark_server.hpp"
+#include "benchmark_utils.hpp"
+#include "perf_counters.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <gtest/gtest.h>
+
+using benchmark_server::JobSpec;
+using benchmark_server::ParseJobSpec;
+
+class BenchmarkServerTest : public ::testing::Test {
+protected:
+  static constexpr size_t kDefaultIterations = 1000;
+
+  // Feeds `input` to a session through a pipe and returns everything it
+  // wrote back
+  static std::string Serve(const std::string &input, bool *quit = nullptr) {
+    int input_pipe[2];
+    int output_pipe[2];
+    EXPECT_EQ(pipe(input_pipe), 0);
+    EXPECT_EQ(pipe(output_pipe), 0);
+    EXPECT_EQ(
+        write(input_pipe[1], input.data(), input.size()),
+        static_cast<ssize_t>(input.size())
+    );
+    close(input_pipe[1]);
+
+    bool ended_with_quit = benchmark_server::ServeSession(
+        input_pipe[0],
+        output_pipe[1],
+        kDefaultIterations
+    );
+    close(input_pipe[0]);
+    close(output_pipe[1]);
+    if (quit != nullptr) {
+      *quit = ended_with_quit;
+    }
+
+    std::string output;
+    char buffer[4096];
+    ssize_t count;
+    while ((count = read(output_pipe[0], buffer, sizeof(buffer))) > 0) {
+      output.append(buffer, static_cast<size_t>(count));
+    }
+    close(output_pipe[0]);
+    return output;
+  }
+
+  static size_t CountLines(const std::string &text) {
+    return static_cast<size_t>(std::count(text.begin(), text.end(), '\n'));
+  }
+};
+
+TEST_F(BenchmarkServerTest, ParseJobSpec_ReadsAllKeys) {
+  JobSpec job = ParseJobSpec(
+      "id=3 mode=run category=crtp kernel=fma iterations=500 run=2",
+      kDefaultIterations
+  );
+  EXPECT_EQ(job.id, "3");
+  EXPECT_EQ(job.mode, "run");
+  EXPECT_EQ(job.category, "crtp");
+  EXPECT_EQ(job.computation, "fma");
+  EXPECT_EQ(job.iterations, 500);
+  EXPECT_EQ(job.run, 2);
+}
+
+TEST_F(BenchmarkServerTest, ParseJobSpec_DefaultsModeAndIterations) {
+  JobSpec job = ParseJobSpec("category=runtime computation=expensive", 42);
+  EXPECT_EQ(job.mode, "run");
+  EXPECT_EQ(job.iterations, 42);
+  EXPECT_EQ(job.run, 1);
+}
+
+TEST_F(BenchmarkServerTest, ParseJobSpec_InvalidSpecs_Throw) {
+  for (const auto &line : {
+           "category=runtime",
+           "category=runtime computation=nope",
+           "category=runtime computation=fma iterations=0",
+           "category=runtime computation=fma run=0",
+           "category=runtime computation=fma colour=blue",
+           "category=runtime computation=fma stray",
+           "mode=scenario scenario=nope",
+           "mode=sprint category=runtime computation=fma",
+       }) {
+    EXPECT_THROW(ParseJobSpec(line, kDefaultIterations), std::invalid_argument)
+        << line;
+  }
+}
+
+TEST_F(BenchmarkServerTest, ServeSession_StreamsOneResultPerJob) {
+  bool quit = false;
+  std::string output = Serve(
+      "# comment\n"
+      "id=a category=runtime computation=fma\n"
+      "\n"
+      "id=b category=concepts computation=nope\n"
+      "id=c category=crtp computation=expensive iterations=10",
+      &quit
+  );
+
+  EXPECT_FALSE(quit);
+  EXPECT_EQ(CountLines(output), 4); // ready + 3 jobs
+  EXPECT_NE(output.find("\"status\":\"ready\""), std::string::npos);
+  EXPECT_NE(
+      output.find("{\"id\":\"a\",\"status\":\"ok\",\"mode\":\"run\""),
+      std::string::npos
+  );
+  EXPECT_NE(
+      output.find("{\"id\":\"b\",\"status\":\"error\""),
+      std::string::npos
+  );
+  EXPECT_NE(output.find("\"iterations\":10,"), std::string::npos);
+}
+
+TEST_F(BenchmarkServerTest, ServeSession_StopsAtQuit) {
+  bool quit = false;
+  std::string output = Serve(
+      "id=a category=runtime computation=fma\n"
+      "quit\n"
+      "id=b category=runtime computation=fma\n",
+      &quit
+  );
+
+  EXPECT_TRUE(quit);
+  EXPECT_EQ(CountLines(output), 2);
+  EXPECT_EQ(output.find("\"id\":\"b\""), std::string::npos);
+}
+
+TEST_F(BenchmarkServerTest, PerfCounters_CountOnlyTheWindow) {
+  PerfCounters counters;
+  for (const auto &reading : counters.Read()) {
+    EXPECT_EQ(reading.value, 0u) << reading.name;
+  }
+  if (!counters.available()) {
+    GTEST_SKIP() << "perf events aren't available";
+  }
+
+  auto instructions = [&] {
+    for (const auto &reading : counters.Read()) {
+      if (reading.name == "instructions") {
+        return reading.value;
+      }
+    }
+    return uint64_t{0};
+  };
+  volatile double sink = 0.0;
+  counters.Start();
+  for (int i = 0; i < 10'000'000; ++i) {
+    sink = sink + 1.0;
+  }
+  counters.Stop();
+  uint64_t busy = instructions();
+
+  // An empty window doesn't carry over the previous one
+  counters.Start();
+  counters.Stop();
+  EXPECT_GT(busy, 10'000'000u);
+  EXPECT_LT(instructions(), busy / 100);
+}
+
+namespace {
+
+volatile double counted_sink = 0.0;
+
+void CountedSpin(size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    counted_sink = counted_sink + 1.0;
+  }
+}
+
+uint64_t Instructions(const PerfCounters &counters) {
+  for (const auto &reading : counters.Read()) {
+    if (reading.name == "instructions") {
+      return reading.value;
+    }
+  }
+  return 0;
+}
+
+} // namespace
+
+TEST_F(BenchmarkServerTest, RunTestCase_CountsOnlyTheTimedRegion) {
+  PerfCounters counters;
+  if (!counters.available()) {
+    GTEST_SKIP() << "perf events aren't available";
+  }
+  TestCase test_case{"counted", CountedSpin, [] { CountedSpin(10'000'000); }};
+  RunTestCase(test_case, 1'000, &counters);
+  EXPECT_LT(Instructions(counters), 1'000'000u);
+}
+
+TEST_F(BenchmarkServerTest, PerfCounters_CountThreadsStartedLater) {
+  PerfCounters counters;
+  if (!counters.available()) {
+    GTEST_SKIP() << "perf events aren't available";
+  }
+  counters.Start();
+  std::thread worker(CountedSpin, 10'000'000);
+  worker.join();
+  counters.Stop();
+  EXPECT_GT(Instructions(counters), 10'000'000u);
+}
@@ -0,0 +1,108 @@
+#include "calibration.hpp"
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <gtest/gtest.h>
+
+using namespace calibration;
+
+TEST(CalibrationTest, FromSamples_MeanAndStandardError) {
+  Estimate estimate = FromSamples({1.0, 2.0, 3.0, 4.0});
+  EXPECT_DOUBLE_EQ(estimate.value, 2.5);
+  // Sample stddev sqrt(5/3), over sqrt(4)
+  EXPECT_DOUBLE_EQ(estimate.uncertainty, std::sqrt(5.0 / 3.0) / 2.0);
+
+  EXPECT_DOUBLE_EQ(FromSamples({7.0}).uncertainty, 0.0);
+  EXPECT_DOUBLE_EQ(FromSamples({}).value, 0.0);
+}
+
+TEST(CalibrationTest, PropagatesUncertainty) {
+  Estimate difference = Difference({10.0, 3.0}, {4.0, 4.0});
+  EXPECT_DOUBLE_EQ(difference.value, 6.0);
+  EXPECT_DOUBLE_EQ(difference.uncertainty, 5.0);
+
+  // 10% and 5% relative errors
+  Estimate product = Product({2.0, 0.2}, {3.0, 0.15});
+  EXPECT_DOUBLE_EQ(product.value, 6.0);
+  EXPECT_NEAR(product.uncertainty, 6.0 * std::hypot(0.1, 0.05), 1e-12);
+}
+
+TEST(CalibrationTest, MeasureNetCost_SubtractsBaselines) {
+  Calibration calibration = Calibrate(10000);
+  EXPECT_GT(calibration.empty_ns.value, 0.0);
+  EXPECT_EQ(calibration.inline_ns.size(), CalibratedComputations().size());
+  EXPECT_FALSE(calibration.clock_source.empty());
+
+  NetCost cost = MeasureNetCost(calibration, "runtime", "fma");
+  EXPECT_GT(cost.raw_ns.value, 0.0);
+  EXPECT_DOUBLE_EQ(
+      cost.net_ns.value,
+      cost.raw_ns.value - calibration.empty_ns.value
+  );
+  EXPECT_DOUBLE_EQ(
+      cost.dispatch_ns.value,
+      cost.raw_ns.value - calibration.inline_ns.at("fma").value
+  );
+  EXPECT_GE(cost.net_ns.uncertainty, calibration.empty_ns.uncertainty);
+  EXPECT_EQ(cost.net_cycles.has_value(), calibration.cycles_per_ns.has_value());
+}
+
+TEST(CalibrationTest, InlineBaselines_AreNotFolded) {
+  // With a foldable argument every inline kernel costs as much as the empty
+  // one
+  Estimate empty = MeasureEmptyKernel(100000);
+  Estimate expensive = MeasureInlineKernel("expensive", 100000);
+  EXPECT_GT(expensive.value, 3.0 * empty.value)
+      << "empty " << empty.value << " ns, expensive " << expensive.value
+      << " ns";
+
+  Calibration calibration;
+  calibration.calls = 100000;
+  calibration.empty_ns = empty;
+  calibration.inline_ns["expensive"] = expensive;
+  NetCost cost = MeasureNetCost(calibration, "crtp", "expensive");
+  EXPECT_GT(cost.raw_ns.value, 3.0 * empty.value);
+}
+
+TEST(CalibrationTest, RejectsUnknownCases) {
+  Calibration calibration;
+  calibration.calls = 10;
+  calibration.inline_ns["fma"] = {1.0, 0.0};
+  EXPECT_THROW(
+      MeasureNetCost(calibration, "runtime", "triad"),
+      std::invalid_argument
+  );
+  EXPECT_THROW(
+      MeasureNetCost(calibration, "unknown", "fma"),
+      std::invalid_argument
+  );
+  EXPECT_THROW(MeasureInlineKernel("triad", 10), std::invalid_argument);
+  EXPECT_THROW(MeasureEmptyKernel(0), std::invalid_argument);
+}
+
+TEST(CalibrationTest, WriteNetCostTable_ShowsErrors) {
+  Calibration calibration;
+  calibration.calls = 1000;
+  calibration.empty_ns = {0.5, 0.01};
+  calibration.inline_ns["fma"] = {0.6, 0.02};
+  calibration.clock_source = "unavailable";
+
+  NetCost cost;
+  cost.category = "runtime";
+  cost.computation = "fma";
+  cost.raw_ns = {2.0, 0.1};
+  cost.net_ns = {1.5, 0.1};
+  cost.dispatch_ns = {1.4, 0.1};
+
+  std::ostringstream out;
+  WriteNetCostTable(out, calibration, {cost});
+  std::string text = out.str();
+  EXPECT_NE(text.find("- Empty kernel: 0.50 ± 0.01"), std::string::npos)
+      << text;
+  EXPECT_NE(text.find("- Inline fma: 0.60 ± 0.02"), std::string::npos);
+  EXPECT_NE(
+      text.find("| runtime | fma | 2.00 ± 0.10 | 1.50 ± 0.10 | n/a | "
+                "1.40 ± 0.10 | n/a |"),
+      std::string::npos
+  ) << text;
+}
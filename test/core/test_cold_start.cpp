@@ -0,0 +1,72 @@
+#include "cold_start.hpp"
+#include <sstream>
+#include <stdexcept>
+#include <gtest/gtest.h>
+
+using namespace cold_start;
+
+class ColdStartTest : public ::testing::Test {
+protected:
+  // Small enough to keep the tests fast; still beyond L2 on most CPUs
+  static ColdStartOptions SmallOptions() {
+    return ColdStartOptions{.samples = 20, .batch = 2, .evict_bytes = 4 << 20};
+  }
+};
+
+TEST_F(ColdStartTest, LastLevelCacheSize_IsPositive) {
+  EXPECT_GT(LastLevelCacheSize(), 0);
+}
+
+TEST_F(ColdStartTest, Percentile_UsesNearestRank) {
+  std::vector<double> values = {5, 1, 4, 2, 3};
+  EXPECT_DOUBLE_EQ(Percentile(values, 0.0), 1);
+  EXPECT_DOUBLE_EQ(Percentile(values, 0.5), 3);
+  EXPECT_DOUBLE_EQ(Percentile(values, 1.0), 5);
+  EXPECT_DOUBLE_EQ(Percentile({}, 0.5), 0);
+}
+
+TEST_F(ColdStartTest, EvictCaches_TouchesEveryLine) {
+  std::vector<uint64_t> buffer(1024, 0);
+  EvictCaches(buffer);
+  for (size_t i = 0; i < buffer.size(); i += 8) {
+    EXPECT_EQ(buffer[i], 1);
+  }
+}
+
+TEST_F(ColdStartTest, ScrambleBranchHistory_AdvancesState) {
+  uint64_t state = 1;
+  ScrambleBranchHistory(state);
+  EXPECT_NE(state, 1);
+}
+
+TEST_F(ColdStartTest, MeasureColdStart_ReportsAllCategories) {
+  for (const auto &category : {"runtime", "crtp", "concepts"}) {
+    auto result = MeasureColdStart(category, "fma", SmallOptions());
+    EXPECT_EQ(result.category, category);
+    EXPECT_GE(result.cold_median_ns, 0.0);
+    EXPECT_GE(result.cold_p90_ns, result.cold_median_ns);
+  }
+}
+
+TEST_F(ColdStartTest, MeasureColdStart_InvalidArguments_Throw) {
+  EXPECT_THROW(
+      MeasureColdStart("unknown", "fma", SmallOptions()),
+      std::invalid_argument
+  );
+  EXPECT_THROW(
+      MeasureColdStart("runtime", "unknown", SmallOptions()),
+      std::invalid_argument
+  );
+}
+
+TEST_F(ColdStartTest, WriteColdStartTable_HasRowPerResult) {
+  std::vector<ColdStartResult> results = {
+      {"runtime", "fma", 100.0, 150.0, 300.0, 2.0},
+      {"crtp", "expensive", 80.0, 120.0, 240.0, 10.0},
+  };
+  std::ostringstream out;
+  WriteColdStartTable(out, results);
+
+  EXPECT_NE(out.str().find("| runtime | fma | 100.0 |"), std::string::npos);
+  EXPECT_NE(out.str().find("| crtp | expensive | 80.0 |"), std::string::npos);
+}
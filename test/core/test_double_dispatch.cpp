@@ -0,0 +1,94 @@
+#include "double_dispatch.hpp"
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <gtest/gtest.h>
+
+using namespace double_dispatch;
+
+TEST(DoubleDispatchTest, EveryApproachCallsThePairKernel) {
+  VisitorLeftImpl<3, 2> left;
+  VisitorRightImpl<3, 1> right;
+  const VisitorLeft<3> &left_base = left;
+  EXPECT_DOUBLE_EQ(left_base.Accept(right, 0.5), (Interact<2, 1>(0.5)));
+
+  LeftVariant<3> left_value(std::in_place_index<2>);
+  RightVariant<4> right_value(std::in_place_index<1>);
+  EXPECT_DOUBLE_EQ(
+      (VisitPair<3, 4>(left_value, right_value, 0.5)),
+      (Interact<2, 1>(0.5))
+  );
+
+  constexpr auto kTable = MakeInteractionTable<3, 4>();
+  EXPECT_DOUBLE_EQ(kTable[2][1](0.5), (Interact<2, 1>(0.5)));
+
+  EXPECT_DOUBLE_EQ(
+      StaticLeft<2>{}.Collide(StaticRight<1>{}, 0.5),
+      (Interact<2, 1>(0.5))
+  );
+}
+
+TEST(DoubleDispatchTest, MakePairSequence_StaysInsideMatrix) {
+  auto calls = MakePairSequence(10'000, 3, 5, 7);
+  ASSERT_EQ(calls.size(), 10'000);
+  std::vector<int> seen(15, 0);
+  for (const auto &call : calls) {
+    ASSERT_LT(call.left, 3);
+    ASSERT_LT(call.right, 5);
+    ASSERT_GE(call.x, 0.0);
+    ASSERT_LT(call.x, 1.0);
+    ++seen[call.left * 5 + call.right];
+  }
+  for (int count : seen) {
+    EXPECT_GT(count, 0);
+  }
+}
+
+TEST(DoubleDispatchTest, MeasureDoubleDispatch_ApproachesAgree) {
+  for (const auto &[num_left, num_right] : MatrixSizes()) {
+    auto calls = MakePairSequence(4096, num_left, num_right, 1);
+    double expected =
+        MeasureDoubleDispatch(
+            num_left,
+            num_right,
+            Approach::kVirtualVisitor,
+            calls,
+            1
+        )
+            .sum;
+    for (Approach approach : AllApproaches()) {
+      auto result =
+          MeasureDoubleDispatch(num_left, num_right, approach, calls, 2);
+      EXPECT_NEAR(result.sum, expected, 1e-9 * std::abs(expected))
+          << ApproachName(approach) << " " << num_left << "x" << num_right;
+      EXPECT_GT(result.ns_per_call, 0.0);
+    }
+  }
+}
+
+TEST(DoubleDispatchTest, MeasureDoubleDispatch_RejectsUnknownSizes) {
+  auto calls = MakePairSequence(16, 3, 3, 1);
+  EXPECT_THROW(
+      MeasureDoubleDispatch(3, 3, Approach::kFunctionTable, calls, 1),
+      std::invalid_argument
+  );
+
+  auto too_wide = MakePairSequence(16, 4, 4, 1);
+  EXPECT_THROW(
+      MeasureDoubleDispatch(2, 2, Approach::kFunctionTable, too_wide, 1),
+      std::invalid_argument
+  );
+}
+
+TEST(DoubleDispatchTest, WriteDoubleDispatchTable_ScalesAgainstSmallest) {
+  std::vector<DoubleDispatchResult> results = {
+      {2, 2, Approach::kFunctionTable, 2.0, 0.0},
+      {8, 8, Approach::kFunctionTable, 5.0, 0.0},
+  };
+  std::ostringstream out;
+  WriteDoubleDispatchTable(out, results);
+  EXPECT_NE(
+      out.str().find("| 8 x 8 | function table | 5.00 | 2.50 |"),
+      std::string::npos
+  ) << out.str();
+}
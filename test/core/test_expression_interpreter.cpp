@@ -0,0 +1,128 @@
+#include "expression_interpreter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <gtest/gtest.h>
+
+using namespace expression_interpreter;
+
+namespace {
+
+// Checks post-order layout and returns the depth of the tree
+uint32_t CheckedDepth(const ExprTree &tree) {
+  std::vector<uint32_t> depths(tree.size);
+  for (uint32_t i = 0; i < tree.size; ++i) {
+    const ExprNode &node = tree.nodes[i];
+    if (IsLeaf(node.op)) {
+      depths[i] = 1;
+      continue;
+    }
+    EXPECT_LT(node.left, i);
+    depths[i] = depths[node.left] + 1;
+    if (!IsUnary(node.op)) {
+      EXPECT_LT(node.left, node.right);
+      EXPECT_LT(node.right, i);
+      depths[i] = std::max(depths[i], depths[node.right] + 1);
+    }
+  }
+  return depths[tree.root()];
+}
+
+} // namespace
+
+TEST(TreeBuilderTest, BuildsExactSizeAndDepth) {
+  static_assert(MakeRandomTree(31, 7, 1).size == 31);
+
+  std::vector<TreeShape> shapes = {{1, 1}, {6, 6}, {7, 3}, {40, 9}};
+  shapes.insert(shapes.end(), kTreeShapes.begin(), kTreeShapes.end());
+  for (const TreeShape &shape : shapes) {
+    for (uint64_t seed : {1, 2, 3}) {
+      ExprTree tree = MakeRandomTree(shape.size, shape.depth, seed);
+      EXPECT_EQ(tree.size, shape.size);
+      EXPECT_EQ(tree.depth, shape.depth);
+      EXPECT_EQ(CheckedDepth(tree), shape.depth)
+          << shape.size << " nodes, seed " << seed;
+    }
+  }
+}
+
+TEST(TreeBuilderTest, RejectsImpossibleShapes) {
+  EXPECT_THROW(MakeRandomTree(8, 3, 1), std::invalid_argument);
+  EXPECT_THROW(MakeRandomTree(3, 4, 1), std::invalid_argument);
+  EXPECT_THROW(MakeRandomTree(1, 0, 1), std::invalid_argument);
+  EXPECT_THROW(
+      MakeRandomTree(kMaxTreeNodes + 1, 64, 1),
+      std::invalid_argument
+  );
+}
+
+TEST(BytecodeTest, CompilesToPostfix) {
+  // A full binary tree needs one stack slot per level; a chain needs one
+  Bytecode full(MakeRandomTree(15, 4, 1));
+  EXPECT_EQ(full.code().size(), 16u);
+  EXPECT_EQ(full.code().back().opcode, Opcode::kReturn);
+  EXPECT_EQ(full.max_stack(), 4u);
+
+  Bytecode chain(MakeRandomTree(5, 5, 1));
+  EXPECT_EQ(chain.max_stack(), 1u);
+}
+
+TEST(ExpressionInterpreterTest, InterpretersMatchReference) {
+  std::vector<double> inputs = MakeInputs(32, 5);
+  for (size_t shape = 0; shape < kTreeShapes.size(); ++shape) {
+    const ExprTree &tree = ShapeTree(shape);
+    auto virtual_root = BuildVirtualTree(tree);
+    VariantArena arena(tree);
+    Bytecode bytecode(tree);
+    for (double x : inputs) {
+      double expected = EvaluateReference(tree, x);
+      EXPECT_DOUBLE_EQ(virtual_root->Evaluate(x), expected);
+      EXPECT_DOUBLE_EQ(arena.Evaluate(x), expected);
+      EXPECT_DOUBLE_EQ(bytecode.RunSwitch(x), expected);
+      EXPECT_DOUBLE_EQ(bytecode.RunThreaded(x), expected);
+    }
+  }
+}
+
+TEST(ExpressionInterpreterTest, MeasureExpression_ApproachesAgree) {
+  std::vector<double> inputs = MakeInputs(16, 9);
+  for (size_t shape = 0; shape < kTreeShapes.size(); ++shape) {
+    const ExprTree &tree = ShapeTree(shape);
+    double expected = 0.0;
+    for (double x : inputs) {
+      expected += EvaluateReference(tree, x);
+    }
+    expected *= 2.0; // two passes
+    for (Approach approach : AllApproaches()) {
+      auto result = MeasureExpression(shape, approach, inputs, 2);
+      EXPECT_EQ(result.size, tree.size);
+      EXPECT_EQ(result.evaluations, 32u);
+      EXPECT_GT(result.ns_per_evaluation, 0.0);
+      EXPECT_NEAR(result.sum, expected, 1e-9 * (1.0 + std::fabs(expected)))
+          << ApproachName(approach) << ", shape " << shape;
+    }
+  }
+  EXPECT_THROW(
+      MeasureExpression(kTreeShapes.size(), Approach::kVirtualNodes, inputs, 1),
+      std::invalid_argument
+  );
+}
+
+TEST(ExpressionInterpreterTest, WriteExpressionTable_ReportsSpeedup) {
+  std::vector<ExpressionResult> results = {
+      {31, 7, Approach::kVirtualNodes, 100, 40.0, 0.0},
+      {31, 7, Approach::kBytecodeThreaded, 100, 20.0, 0.0},
+  };
+  std::ostringstream out;
+  WriteExpressionTable(out, results);
+  std::string table = out.str();
+  EXPECT_NE(
+      table.find("| 31 | 7 | virtual nodes | 25.00 | 1.29 | 1.00x |"),
+      std::string::npos
+  ) << table;
+  EXPECT_NE(
+      table.find("| 31 | 7 | bytecode (threaded) | 50.00 | 0.65 | 2.00x |"),
+      std::string::npos
+  ) << table;
+}
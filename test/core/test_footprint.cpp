@@ -0,0 +1,138 @@
+#include "allocation_counter.hpp"
+#include "footprint.hpp"
+#include "runtime_polymorphism.hpp"
+#include "value_polymorphism.hpp"
+#include <array>
+#include <cmath>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <gtest/gtest.h>
+
+using namespace footprint;
+using value_polymorphism::PolyAny;
+using value_polymorphism::PolyVariant;
+
+namespace {
+
+// Too large for PolyAny's inline buffer
+struct LargeFMA {
+  std::array<double, 8> padding{};
+  double Compute(double x) const { return ComputeFMA(x); }
+};
+
+} // namespace
+
+TEST(AllocationCounterTest, CountsOperatorNew) {
+  ScopedAllocationCounting counting;
+  auto before = GetAllocationCounters();
+  auto value = std::make_unique<std::array<char, 100>>();
+  auto after = GetAllocationCounters();
+
+  EXPECT_EQ(after.allocations - before.allocations, 1);
+  EXPECT_EQ(after.bytes_requested - before.bytes_requested, 100);
+}
+
+TEST(AllocationCounterTest, CountsOnlyInsideScope) {
+  // Direct calls, since an unused new-expression may be elided
+  auto allocate = [](size_t size) {
+    ::operator delete(::operator new(size));
+    return GetAllocationCounters();
+  };
+
+  auto before = allocate(100);
+  AllocationCounters inside{};
+  {
+    ScopedAllocationCounting counting;
+    {
+      ScopedAllocationCounting nested;
+    }
+    // Still counting after the nested scope
+    inside = allocate(10);
+  }
+  auto after = allocate(100);
+
+  EXPECT_EQ(inside.allocations - before.allocations, 1);
+  EXPECT_EQ(inside.bytes_requested - before.bytes_requested, 10);
+  EXPECT_EQ(after.allocations, inside.allocations);
+}
+
+TEST(ValuePolymorphismTest, Variant_DispatchesToHeldType) {
+  PolyVariant fma = crtp_polymorphism::PolyFMA{};
+  PolyVariant expensive = crtp_polymorphism::PolyExpensive{};
+
+  EXPECT_DOUBLE_EQ(value_polymorphism::Compute(fma, 1.5), ComputeFMA(1.5));
+  EXPECT_DOUBLE_EQ(
+      value_polymorphism::Compute(expensive, 1.5),
+      ComputeExpensive(1.5)
+  );
+}
+
+TEST(ValuePolymorphismTest, PolyAny_SmallTypesStayInline) {
+  ScopedAllocationCounting counting;
+  auto before = GetAllocationCounters();
+  PolyAny fma(concepts_polymorphism::PolyFMA{});
+  auto after = GetAllocationCounters();
+
+  EXPECT_TRUE(fma.is_inline());
+  EXPECT_EQ(after.allocations, before.allocations);
+  EXPECT_DOUBLE_EQ(fma.Compute(1.5), ComputeFMA(1.5));
+}
+
+TEST(ValuePolymorphismTest, PolyAny_LargeTypesUseHeap) {
+  ScopedAllocationCounting counting;
+  auto before = GetAllocationCounters();
+  PolyAny large(LargeFMA{});
+  auto after = GetAllocationCounters();
+
+  EXPECT_FALSE(large.is_inline());
+  EXPECT_EQ(after.allocations - before.allocations, 1);
+
+  PolyAny moved(std::move(large));
+  EXPECT_DOUBLE_EQ(moved.Compute(1.5), ComputeFMA(1.5));
+}
+
+TEST(FootprintTest, ReadMemoryUsage_ReportsResidentSet) {
+  auto usage = ReadMemoryUsage();
+  EXPECT_GT(usage.peak_rss_bytes, 0);
+  EXPECT_GE(usage.peak_rss_bytes, usage.rss_bytes);
+}
+
+TEST(FootprintTest, RuntimeModel_AllocatesOncePerObject) {
+  constexpr size_t kPopulation = 10'000;
+  auto result = MeasureFootprint("runtime", kPopulation, 1);
+
+  // One allocation per object plus the vector of pointers
+  EXPECT_EQ(result.allocations, kPopulation + 1);
+  EXPECT_DOUBLE_EQ(
+      result.requested_bytes_per_object,
+      sizeof(runtime_polymorphism::PolyFMA) +
+          sizeof(std::unique_ptr<runtime_polymorphism::RuntimeBase>)
+  );
+}
+
+TEST(FootprintTest, ValueModels_AvoidPerObjectAllocations) {
+  constexpr size_t kPopulation = 10'000;
+  for (const auto &model : {"crtp", "concepts", "variant", "type_erased"}) {
+    auto result = MeasureFootprint(model, kPopulation, 1);
+    EXPECT_LE(result.allocations, 2) << model;
+    EXPECT_LE(result.requested_bytes_per_object, sizeof(PolyAny)) << model;
+  }
+}
+
+TEST(FootprintTest, UnknownModel_Throws) {
+  EXPECT_THROW(MeasureFootprint("unknown", 10, 1), std::invalid_argument);
+}
+
+TEST(FootprintTest, WriteFootprintTable_HasRowPerModel) {
+  std::vector<FootprintResult> results;
+  for (const auto &model : FootprintModels()) {
+    results.push_back(MeasureFootprint(model, 1'000, 1));
+  }
+  std::ostringstream out;
+  WriteFootprintTable(out, results);
+
+  for (const auto &model : FootprintModels()) {
+    EXPECT_NE(out.str().find("| " + model + " |"), std::string::npos);
+  }
+}
@@ -0,0 +1,77 @@
+#include "concepts_polymorphism.hpp"
+#include "crtp_polymorphism.hpp"
+#include "intensity_sweep.hpp"
+#include "runtime_polymorphism.hpp"
+#include <sstream>
+#include <stdexcept>
+#include <gtest/gtest.h>
+
+using intensity_sweep::SweepResult;
+
+TEST(ComputeChainTest, AppliesKDependentSteps) {
+  EXPECT_DOUBLE_EQ(ComputeChain<1>(2.0), 2.0 * 0.999 + 0.001);
+  double x = 2.0;
+  for (int k = 0; k < 8; ++k) {
+    x = x * 0.999 + 0.001;
+  }
+  EXPECT_DOUBLE_EQ(ComputeChain<8>(2.0), x);
+  EXPECT_TRUE(std::isfinite(ComputeChain<256>(1e300)));
+}
+
+TEST(ComputeChainTest, ModelsAgree) {
+  runtime_polymorphism::PolyChain<16> runtime_chain;
+  const runtime_polymorphism::RuntimeBase &runtime_base = runtime_chain;
+  crtp_polymorphism::PolyChain<16> crtp_chain;
+  concepts_polymorphism::PolyChain<16> concepts_chain;
+
+  EXPECT_DOUBLE_EQ(runtime_base.Compute(3.0), ComputeChain<16>(3.0));
+  EXPECT_DOUBLE_EQ(crtp_chain.Compute(3.0), ComputeChain<16>(3.0));
+  EXPECT_DOUBLE_EQ(concepts_chain.Compute(3.0), ComputeChain<16>(3.0));
+}
+
+TEST(IntensitySweepTest, MeasureChain_RunsEveryModel) {
+  for (const auto &model : intensity_sweep::SweepModels()) {
+    auto result = intensity_sweep::MeasureChain(model, 4, 1000);
+    EXPECT_EQ(result.model, model);
+    EXPECT_EQ(result.chain_length, 4);
+    EXPECT_EQ(result.calls, 1000);
+    EXPECT_GT(result.ns_per_call, 0.0);
+  }
+}
+
+TEST(IntensitySweepTest, MeasureChain_RejectsUnknownArguments) {
+  EXPECT_THROW(
+      intensity_sweep::MeasureChain("vtable", 4, 10),
+      std::invalid_argument
+  );
+  EXPECT_THROW(
+      intensity_sweep::MeasureChain("runtime", 3, 10),
+      std::invalid_argument
+  );
+}
+
+TEST(IntensitySweepTest, CrossoverChainLength_NeedsOverheadToStayLow) {
+  // runtime overhead falls 100%, 50%, 20%, 4%, 2% over K = 1..16. variant
+  // has no overhead except a blip at K = 4, which rules out 4 and below.
+  std::vector<SweepResult> results;
+  double runtime_ns[] = {2.0, 1.5, 1.2, 1.04, 1.02};
+  double variant_ns[] = {1.0, 1.0, 1.5, 1.0, 1.0};
+  size_t lengths[] = {1, 2, 4, 8, 16};
+  for (size_t i = 0; i < 5; ++i) {
+    results.push_back({"crtp", lengths[i], 1, 1.0});
+    results.push_back({"runtime", lengths[i], 1, runtime_ns[i]});
+    results.push_back({"variant", lengths[i], 1, variant_ns[i]});
+  }
+
+  using intensity_sweep::CrossoverChainLength;
+  EXPECT_EQ(CrossoverChainLength(results, "runtime", 0.25), 4);
+  EXPECT_EQ(CrossoverChainLength(results, "runtime", 0.05), 8);
+  EXPECT_EQ(CrossoverChainLength(results, "runtime", 0.01), std::nullopt);
+  EXPECT_EQ(CrossoverChainLength(results, "variant", 0.05), 8);
+
+  std::ostringstream out;
+  intensity_sweep::WriteCrossoverReport(out, results);
+  EXPECT_NE(out.str().find("| runtime | 4 FMAs (1.00 ns) |"),
+            std::string::npos)
+      << out.str();
+}
@@ -0,0 +1,113 @@
+#include "object_layout.hpp"
+#include <sstream>
+#include <stdexcept>
+#include <gtest/gtest.h>
+
+using namespace object_layout;
+
+TEST(ObjectLayoutTest, LinesTouched_CountsDistinctLines) {
+  EXPECT_EQ(LinesTouched(0, {0}), 1u);
+  EXPECT_EQ(LinesTouched(0, {0, 56}), 1u);
+  // The hot field moves onto the next line
+  EXPECT_EQ(LinesTouched(32, {0, 56}), 2u);
+  // One field straddling a line boundary
+  EXPECT_EQ(LinesTouched(60, {0}), 2u);
+  EXPECT_EQ(LinesTouched(128, {0, 8, 16}), 1u);
+}
+
+TEST(ObjectLayoutTest, MeasureLayout_ReportsLayout) {
+  auto measure = [](const std::string &model, size_t payload,
+                    size_t alignment, Placement placement) {
+    return MeasureLayout(
+        {model, payload, alignment, placement, Order::kShuffled},
+        64,
+        100
+    );
+  };
+
+  // vptr, hot field, payload
+  LayoutResult runtime = measure("runtime", 16, 8, Placement::kHotFirst);
+  EXPECT_EQ(runtime.object_size, 32u);
+  EXPECT_EQ(runtime.hot_offset, 8u);
+  EXPECT_EQ(runtime.calls, 128u); // whole sweeps
+  EXPECT_GT(runtime.ns_per_call, 0.0);
+
+  // No vptr without virtual dispatch
+  LayoutResult crtp = measure("crtp", 16, 8, Placement::kHotFirst);
+  EXPECT_EQ(crtp.object_size, 24u);
+  EXPECT_EQ(crtp.hot_offset, 0u);
+  EXPECT_EQ(measure("concepts", 16, 8, Placement::kHotLast).hot_offset, 16u);
+
+  // The hot field behind the payload: on the vptr's line in a 64-byte
+  // object, on the next line in a 128-byte one
+  LayoutResult hot_last = measure("runtime", 48, 64, Placement::kHotLast);
+  EXPECT_EQ(hot_last.object_size, 64u);
+  EXPECT_EQ(hot_last.hot_offset, 56u);
+  EXPECT_DOUBLE_EQ(hot_last.lines_per_call, 1.0);
+  EXPECT_DOUBLE_EQ(
+      measure("runtime", 112, 64, Placement::kHotLast).lines_per_call,
+      2.0
+  );
+
+  // The split keeps only a pointer to the payload
+  LayoutResult split = measure("runtime", 240, 8, Placement::kSplit);
+  EXPECT_EQ(split.object_size, 24u);
+  EXPECT_EQ(measure("crtp", 240, 64, Placement::kSplit).object_size, 64u);
+}
+
+TEST(ObjectLayoutTest, MeasureLayout_EveryVariantRuns) {
+  for (const auto &model : LayoutModels()) {
+    for (size_t payload : kPayloadSizes) {
+      for (size_t alignment : kAlignments) {
+        for (Placement placement : AllPlacements()) {
+          auto result = MeasureLayout(
+              {model, payload, alignment, placement, Order::kSequential},
+              16,
+              16
+          );
+          EXPECT_EQ(result.object_size % alignment, 0u);
+          EXPECT_GE(result.lines_per_call, 1.0);
+          // Fields are 8-byte aligned, so only the vptr and the hot field
+          // landing on different lines costs a second one
+          EXPECT_LE(result.lines_per_call, model == "runtime" ? 2.0 : 1.0);
+          if (alignment == kCacheLineSize && placement != Placement::kHotLast) {
+            EXPECT_DOUBLE_EQ(result.lines_per_call, 1.0)
+                << model << " " << payload << " " << PlacementName(placement);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(ObjectLayoutTest, MeasureLayout_RejectsUnknownVariants) {
+  EXPECT_THROW(MeasureLayout({"variant"}, 16, 16), std::invalid_argument);
+  EXPECT_THROW(
+      MeasureLayout({"runtime", 17, 8, Placement::kHotFirst}, 16, 16),
+      std::invalid_argument
+  );
+  EXPECT_THROW(
+      MeasureLayout({"runtime", 16, 32, Placement::kHotFirst}, 16, 16),
+      std::invalid_argument
+  );
+  EXPECT_THROW(MeasureLayout({"crtp"}, 1, 16), std::invalid_argument);
+}
+
+TEST(ObjectLayoutTest, WriteLayoutTable_FormatsRows) {
+  LayoutResult result{
+      {"runtime", 48, 64, Placement::kSplit, Order::kShuffled},
+      64,
+      8,
+      1.0,
+      1000,
+      12.5,
+      {},
+  };
+  std::ostringstream out;
+  WriteLayoutTable(out, {result});
+  EXPECT_NE(
+      out.str().find("| shuffled | 48 | 64 | hot/cold split | runtime | 64 | "
+                     "8 | 1.00 | n/a | 12.50 |"),
+      std::string::npos
+  ) << out.str();
+}
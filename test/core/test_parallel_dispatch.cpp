@@ -0,0 +1,177 @@
+#include "parallel_dispatch.hpp"
+#include "work_stealing_pool.hpp"
+#include <atomic>
+#include <numeric>
+#include <sched.h>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <gtest/gtest.h>
+
+using parallel_dispatch::Executor;
+
+TEST(ThreadUtilsTest, ThreadCountSweep_DoublesUpToMax) {
+  EXPECT_EQ(ThreadCountSweep(1), std::vector<size_t>({1}));
+  EXPECT_EQ(ThreadCountSweep(6), std::vector<size_t>({1, 2, 4, 6}));
+  EXPECT_EQ(ThreadCountSweep(8), std::vector<size_t>({1, 2, 4, 8}));
+}
+
+TEST(ThreadUtilsTest, CacheLinePadded_FillsWholeLines) {
+  EXPECT_EQ(sizeof(CacheLinePadded<double>), kCacheLineSize);
+  EXPECT_EQ(alignof(CacheLinePadded<double>), kCacheLineSize);
+}
+
+TEST(ThreadUtilsTest, ProcessCpus_SurvivesCallerPin) {
+  size_t cpus = ProcessCpus().size();
+  if (cpus < 2) {
+    GTEST_SKIP() << "needs more than one CPU";
+  }
+  ScopedThreadPin pin(0);
+  ASSERT_TRUE(pin.pinned());
+  EXPECT_EQ(HardwareThreadCount(), cpus);
+
+  // A thread created by the pinned caller can still be pinned elsewhere
+  int cpu = -1;
+  std::thread([&] {
+    if (PinCurrentThread(1)) {
+      cpu = sched_getcpu();
+    }
+  }).join();
+  EXPECT_EQ(cpu, ProcessCpus()[1]);
+}
+
+TEST(WorkStealingPoolPinningTest, PinnedWorkers_RunOnDistinctCpus) {
+  size_t threads = std::min<size_t>(HardwareThreadCount(), 4);
+  if (threads < 2) {
+    GTEST_SKIP() << "needs more than one CPU";
+  }
+  WorkStealingPool pool(threads);
+  std::vector<CacheLinePadded<int>> cpus(threads);
+  pool.ParallelFor(
+      threads,
+      1,
+      Schedule::kStatic,
+      [&](size_t, size_t, size_t worker) {
+        cpus[worker].value = sched_getcpu();
+      }
+  );
+  std::set<int> distinct;
+  for (const auto &cpu : cpus) {
+    distinct.insert(cpu.value);
+  }
+  EXPECT_EQ(distinct.size(), threads);
+}
+
+class WorkStealingPoolTest : public ::testing::TestWithParam<Schedule> {};
+
+TEST_P(WorkStealingPoolTest, ParallelFor_VisitsEveryIndexOnce) {
+  constexpr size_t kN = 10'007;
+  WorkStealingPool pool(4, false);
+  std::vector<std::atomic<int>> visits(kN);
+
+  for (int pass = 0; pass < 3; ++pass) {
+    auto stats = pool.ParallelFor(
+        kN,
+        64,
+        GetParam(),
+        [&](size_t begin, size_t end, size_t) {
+          for (size_t i = begin; i < end; ++i) {
+            visits[i].fetch_add(1, std::memory_order_relaxed);
+          }
+        }
+    );
+    ASSERT_EQ(stats.workers.size(), 4);
+    size_t chunks = 0;
+    for (const auto &worker : stats.workers) {
+      chunks += worker.chunks;
+    }
+    EXPECT_EQ(chunks, (kN + 63) / 64);
+  }
+
+  for (size_t i = 0; i < kN; ++i) {
+    ASSERT_EQ(visits[i].load(), 3) << "index " << i;
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Schedules,
+    WorkStealingPoolTest,
+    ::testing::Values(Schedule::kStatic, Schedule::kWorkStealing)
+);
+
+TEST(WorkStealingTest, WorkStealing_RebalancesSlowBlock) {
+  WorkStealingPool pool(2, false);
+
+  // Worker 0's block is slow, so worker 1 should finish early and steal
+  auto stats = pool.ParallelFor(
+      64,
+      1,
+      Schedule::kWorkStealing,
+      [](size_t begin, size_t, size_t) {
+        if (begin < 32) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+      }
+  );
+  EXPECT_GT(stats.workers[1].steals, 0);
+  EXPECT_GT(stats.workers[1].chunks, 32);
+
+  auto static_stats = pool.ParallelFor(
+      64,
+      1,
+      Schedule::kStatic,
+      [](size_t, size_t, size_t) {}
+  );
+  EXPECT_EQ(static_stats.workers[0].chunks, 32);
+  EXPECT_EQ(static_stats.workers[1].steals, 0);
+}
+
+TEST(ParallelDispatchTest, MakeExpensiveMask_RampsUp) {
+  auto mask = parallel_dispatch::MakeExpensiveMask(10'000, 1);
+  size_t first_quarter = std::accumulate(mask.begin(), mask.begin() + 2500, 0);
+  size_t last_quarter = std::accumulate(mask.end() - 2500, mask.end(), 0);
+  EXPECT_LT(first_quarter, 500);
+  EXPECT_GT(last_quarter, 2000);
+}
+
+TEST(ParallelDispatchTest, AllModelsAndExecutors_AgreeOnSum) {
+  auto mask = parallel_dispatch::MakeExpensiveMask(4096, 1);
+  WorkStealingPool pool(3, false);
+
+  auto reference =
+      parallel_dispatch::MeasureParallel("runtime", Executor::kStatic, pool, mask, 1);
+  for (const auto &model : parallel_dispatch::ParallelModels()) {
+    for (Executor executor :
+         {Executor::kStatic, Executor::kWorkStealing, Executor::kStdPar}) {
+      auto result =
+          parallel_dispatch::MeasureParallel(model, executor, pool, mask, 1);
+      EXPECT_NEAR(result.sum, reference.sum, 1e-9 * std::abs(reference.sum))
+          << model << " " << parallel_dispatch::ExecutorName(executor);
+      EXPECT_EQ(result.threads, 3);
+      EXPECT_GT(result.calls_per_second, 0.0);
+    }
+  }
+}
+
+TEST(ParallelDispatchTest, UnknownModel_Throws) {
+  WorkStealingPool pool(1, false);
+  std::vector<uint8_t> mask(16, 0);
+  EXPECT_THROW(
+      parallel_dispatch::MeasureParallel("unknown", Executor::kStatic, pool, mask, 1),
+      std::invalid_argument
+  );
+}
+
+TEST(ParallelDispatchTest, WriteParallelTable_ComputesSpeedup) {
+  std::vector<parallel_dispatch::ParallelResult> results = {
+      {"runtime", Executor::kStatic, 1, 1e6, 0.0, 0.0, 0, 0.0},
+      {"runtime", Executor::kStatic, 2, 1.5e6, 0.2, 0.4, 0, 0.0},
+  };
+  std::ostringstream out;
+  parallel_dispatch::WriteParallelTable(out, results);
+  EXPECT_NE(
+      out.str().find("| runtime | static | 2 | 1.50 | 1.50 | 20.00 | 40.00 |"),
+      std::string::npos
+  );
+}
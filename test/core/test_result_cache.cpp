@@ -0,0 +1,126 @@
+#include "benchmark_server.hpp"
+#include "result_cache.hpp"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <gtest/gtest.h>
+
+using namespace result_cache;
+
+namespace fs = std::filesystem;
+
+class ResultCacheTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    dir_ = fs::temp_directory_path() /
+           ("result_cache_test_" + std::to_string(getpid()));
+    fs::remove_all(dir_);
+  }
+
+  void TearDown() override {
+    GetResultCacheOptions() = ResultCacheOptions{};
+    fs::remove_all(dir_);
+  }
+
+  fs::path dir_;
+};
+
+TEST_F(ResultCacheTest, Fnv1a_KnownVectors) {
+  static_assert(Fnv1a("") == kFnvOffset);
+  EXPECT_EQ(ToHex(Fnv1a("a")), "af63dc4c8601ec8c");
+  EXPECT_EQ(ToHex(Fnv1a("foobar")), "85944171f73967e8");
+  // Hashing in pieces matches hashing at once
+  EXPECT_EQ(Fnv1a("bar", Fnv1a("foo")), Fnv1a("foobar"));
+}
+
+TEST_F(ResultCacheTest, MakeKey_CoversIdentityAndJob) {
+  Identity identity{"0123", "-O3 -march=native", "Some CPU"};
+  std::string key = MakeKey(identity, "mode=run category=crtp");
+  EXPECT_EQ(
+      key,
+      "v1\t0123\t-O3 -march=native\tSome CPU\tmode=run category=crtp"
+  );
+
+  Identity rebuilt = identity;
+  rebuilt.binary_hash = "4567";
+  EXPECT_NE(Digest(MakeKey(rebuilt, "job")), Digest(MakeKey(identity, "job")));
+  EXPECT_NE(Digest(MakeKey(identity, "a")), Digest(MakeKey(identity, "b")));
+
+  // Separators in a field can't shift it into the next one
+  EXPECT_EQ(MakeKey(identity, "a\tb\nc").find('\n'), std::string::npos);
+}
+
+TEST_F(ResultCacheTest, StoreThenLookup_WithinWindow) {
+  ResultCache cache(dir_.string(), 3600);
+  EXPECT_FALSE(cache.Lookup("key").has_value());
+
+  ASSERT_TRUE(cache.Store("key", "{\"seconds\":1.5}\nsecond line"));
+  EXPECT_TRUE(fs::exists(cache.EntryPath("key")));
+  EXPECT_EQ(cache.Lookup("key").value_or(""), "{\"seconds\":1.5}\nsecond line");
+  EXPECT_FALSE(cache.Lookup("other key").has_value());
+
+  // Entries are overwritten in place
+  ASSERT_TRUE(cache.Store("key", "new"));
+  EXPECT_EQ(cache.Lookup("key").value_or(""), "new");
+}
+
+TEST_F(ResultCacheTest, Lookup_StaleOrMismatchedEntriesMiss) {
+  ResultCache cache(dir_.string(), 3600);
+  ASSERT_TRUE(cache.Store("key", "payload"));
+  fs::last_write_time(
+      cache.EntryPath("key"),
+      fs::file_time_type::clock::now() - std::chrono::hours(2)
+  );
+  EXPECT_FALSE(cache.Lookup("key").has_value());
+  EXPECT_TRUE(ResultCache(dir_.string(), 3 * 3600).Lookup("key").has_value());
+
+  // A different key stored under the same file name (a hash collision)
+  std::ofstream(cache.EntryPath("key")) << "another key\npayload";
+  EXPECT_FALSE(cache.Lookup("key").has_value());
+
+  EXPECT_THROW(ResultCache("", 1), std::invalid_argument);
+  EXPECT_THROW(ResultCache(dir_.string(), -1), std::invalid_argument);
+}
+
+TEST_F(ResultCacheTest, Identity_HashesThisBinary) {
+  const Identity &identity = GetIdentity();
+  EXPECT_EQ(identity.binary_hash, HashFile("/proc/self/exe"));
+  EXPECT_EQ(identity.binary_hash.size(), 16u);
+  EXPECT_FALSE(identity.cpu_model.empty());
+  EXPECT_NE(
+      IdentityJson(identity).find("\"binary_hash\":\""),
+      std::string::npos
+  );
+  EXPECT_THROW(HashFile((dir_ / "missing").string()), std::runtime_error);
+}
+
+TEST_F(ResultCacheTest, RunJob_ReusesCachedResult) {
+  GetResultCacheOptions().dir = dir_.string();
+  PerfCounters counters;
+  auto job = benchmark_server::ParseJobSpec(
+      "id=1 category=runtime computation=fma iterations=1000",
+      1000
+  );
+
+  std::string measured = benchmark_server::RunJob(job, counters);
+  EXPECT_EQ(measured.find("\"cached\""), std::string::npos) << measured;
+
+  job.id = "2";
+  std::string cached = benchmark_server::RunJob(job, counters);
+  EXPECT_EQ(cached.rfind("{\"id\":\"2\",\"cached\":true,", 0), 0u) << cached;
+  EXPECT_EQ(
+      cached.substr(cached.find("\"status\"")),
+      measured.substr(measured.find("\"status\""))
+  );
+
+  // Another repetition or other parameters are measured from scratch
+  job.run = 2;
+  std::string repeated = benchmark_server::RunJob(job, counters);
+  EXPECT_EQ(repeated.find("\"cached\""), std::string::npos) << repeated;
+  job.iterations = 2000;
+  std::string other = benchmark_server::RunJob(job, counters);
+  EXPECT_EQ(other.find("\"cached\""), std::string::npos) << other;
+}
@@ -0,0 +1,166 @@
+#include "sampling_profiler.hpp"
+#include "symbolizer.hpp"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <thread>
+#include <gtest/gtest.h>
+
+using namespace sampling_profiler;
+
+namespace {
+
+volatile double spin_sink = 0.0;
+
+// Busy work with a name the symbolizer has to find
+__attribute__((noinline)) void ProfilerTestSpin(size_t n) {
+  double x = spin_sink + 2.0; // not a compile-time constant
+  for (size_t i = 0; i < n; ++i) {
+    x = x * 0.999999 + 0.000001;
+  }
+  spin_sink = x;
+}
+
+void SpinFor(std::chrono::milliseconds duration) {
+  auto end = std::chrono::steady_clock::now() + duration;
+  while (std::chrono::steady_clock::now() < end) {
+    ProfilerTestSpin(100'000);
+  }
+}
+
+uint64_t SpinAddress() {
+  return reinterpret_cast<uint64_t>(&ProfilerTestSpin);
+}
+
+} // namespace
+
+TEST(SymbolizerTest, ResolvesFunctionsInTheExecutable) {
+  const Symbolizer &symbolizer = GetSymbolizer();
+  ASSERT_TRUE(symbolizer.has_symbols());
+  ASSERT_TRUE(symbolizer.InExecutable(SpinAddress()));
+
+  SourceLocation location = symbolizer.Resolve(SpinAddress() + 4);
+  EXPECT_NE(location.function.find("ProfilerTestSpin"), std::string::npos)
+      << location.function;
+  if (symbolizer.has_line_info()) {
+    EXPECT_NE(
+        location.file.find("test_sampling_profiler.cpp"),
+        std::string::npos
+    ) << location.file;
+    EXPECT_GT(location.line, 0u);
+  }
+}
+
+TEST(SymbolizerTest, FallsBackToSharedLibrarySymbols) {
+  const Symbolizer &symbolizer = GetSymbolizer();
+  auto address = reinterpret_cast<uint64_t>(&std::memcpy);
+  EXPECT_FALSE(symbolizer.InExecutable(address));
+  EXPECT_FALSE(symbolizer.Resolve(address).function.empty());
+}
+
+class SamplingBackendTest : public ::testing::TestWithParam<bool> {};
+
+TEST_P(SamplingBackendTest, SamplesABusyLoop) {
+  SamplingProfiler profiler(1000, GetParam());
+  ASSERT_TRUE(profiler.Start());
+  if (!GetParam()) {
+    EXPECT_EQ(profiler.backend(), Backend::kSignal);
+  }
+  SamplingProfiler second(1000, GetParam());
+  EXPECT_FALSE(second.Start()); // one profiler at a time
+
+  SpinFor(std::chrono::milliseconds(300));
+  Profile profile = profiler.Stop();
+
+  ASSERT_GT(profile.stacks.size(), 20u) << BackendName(profile.backend);
+  std::ostringstream report;
+  WriteTopReport(report, "spin", profile, GetSymbolizer(), 5);
+  EXPECT_NE(report.str().find("| 1 |"), std::string::npos) << report.str();
+  EXPECT_NE(report.str().find("ProfilerTestSpin"), std::string::npos)
+      << report.str();
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Backends,
+    SamplingBackendTest,
+    ::testing::Values(true, false),
+    [](const auto &info) { return info.param ? "PerfEvent" : "Signal"; }
+);
+
+TEST(SamplingProfilerTest, WriteTopReport_RanksBySelfSamples) {
+  // Spin is the leaf in 3 of 4 samples and on every stack
+  uint64_t spin = SpinAddress() + 4;
+  uint64_t caller = reinterpret_cast<uint64_t>(&SpinFor) + 8;
+  Profile profile;
+  profile.frequency_hz = 1000;
+  profile.stacks = {{spin, caller}, {spin, caller}, {spin}, {caller, spin}};
+
+  std::ostringstream report;
+  WriteTopReport(report, "synthetic", profile, GetSymbolizer(), 10);
+  std::string text = report.str();
+  EXPECT_NE(
+      text.find("(4 samples, SIGPROF timer, 1000 Hz)"),
+      std::string::npos
+  ) << text;
+  size_t first = text.find("| 1 | 75.00 | 100.00 |");
+  size_t second = text.find("| 2 | 25.00 | 75.00 |");
+  ASSERT_NE(first, std::string::npos) << text;
+  ASSERT_NE(second, std::string::npos) << text;
+  EXPECT_NE(text.find("ProfilerTestSpin", first), std::string::npos);
+  EXPECT_NE(text.find("SpinFor", second), std::string::npos);
+}
+
+TEST(SamplingProfilerTest, EncodePprof_WritesStringsAndPeriod) {
+  Profile profile;
+  profile.frequency_hz = 1000;
+  profile.stacks = {{SpinAddress() + 4}, {SpinAddress() + 4}};
+
+  std::string encoded = EncodePprof(profile, GetSymbolizer());
+  ASSERT_FALSE(encoded.empty());
+  EXPECT_EQ(encoded[0], '\x0a'); // field 1 (sample_type), length-delimited
+  for (const char *text : {"samples", "count", "cpu", "nanoseconds",
+                           "ProfilerTestSpin", "backend: SIGPROF timer"}) {
+    EXPECT_NE(encoded.find(text), std::string::npos) << text;
+  }
+  // One aggregated sample: location 1, count 2, 2 x 1'000'000 ns
+  const std::string sample = "\x12\x09\x0a\x01\x01\x12\x04\x02\x80\x89\x7a";
+  EXPECT_NE(encoded.find(sample), std::string::npos);
+}
+
+TEST(SamplingProfilerTest, SignalBackend_SamplesOnlyTheCallingThread) {
+  SamplingProfiler profiler(1000, false);
+  ASSERT_TRUE(profiler.Start());
+  std::thread other([] { SpinFor(std::chrono::milliseconds(300)); });
+  other.join();
+  Profile profile = profiler.Stop();
+
+  // The caller was blocked in join() the whole time
+  EXPECT_LT(profile.stacks.size(), 5u);
+}
+
+TEST(SamplingProfilerTest, ScopedProfile_WritesOnlyOnFlush) {
+  auto dir = std::filesystem::temp_directory_path() / "scoped_profile_test";
+  std::filesystem::remove_all(dir);
+  ProfilerOptions &options = GetProfilerOptions();
+  ProfilerOptions saved = options;
+  options.output_dir = dir.string();
+
+  {
+    ScopedProfile scope("deferred");
+    SpinFor(std::chrono::milliseconds(50));
+  }
+  EXPECT_EQ(PendingProfileCount(), 1u);
+  EXPECT_FALSE(std::filesystem::exists(dir / "deferred.pb"));
+
+  testing::internal::CaptureStdout();
+  FlushProfiles();
+  std::string printed = testing::internal::GetCapturedStdout();
+  options = saved;
+
+  EXPECT_EQ(PendingProfileCount(), 0u);
+  EXPECT_TRUE(std::filesystem::exists(dir / "deferred.pb"));
+  EXPECT_TRUE(std::filesystem::exists(dir / "deferred.txt"));
+  EXPECT_NE(printed.find("Profile: deferred"), std::string::npos) << printed;
+  std::filesystem::remove_all(dir);
+}
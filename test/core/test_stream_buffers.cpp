@@ -0,0 +1,123 @@
+#include "benchmark_utils.hpp"
+#include "huge_page_buffer.hpp"
+#include "math_functions.hpp"
+#include "stream_buffers.hpp"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+class StreamBuffersTest : public ::testing::Test {
+protected:
+  StreamOptions small_options;
+
+  void SetUp() override {
+    small_options.length = 1 << 12;
+    small_options.huge_pages = HugePageMode::kNone;
+    small_options.prefetch_distance = 0;
+  }
+};
+
+TEST_F(StreamBuffersTest, ParseHugePageMode) {
+  EXPECT_EQ(ParseHugePageMode("none"), HugePageMode::kNone);
+  EXPECT_EQ(ParseHugePageMode("thp"), HugePageMode::kTransparent);
+  EXPECT_EQ(ParseHugePageMode("explicit"), HugePageMode::kExplicit);
+  EXPECT_FALSE(ParseHugePageMode("not_a_mode").has_value());
+  EXPECT_EQ(HugePageModeName(HugePageMode::kTransparent), "thp");
+}
+
+TEST_F(StreamBuffersTest, HugePageBuffer_IsAlignedAndWritable) {
+  HugePageBuffer buffer(3 * kHugePageSize + 1, HugePageMode::kTransparent);
+  ASSERT_NE(buffer.data(), nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer.data()) % kHugePageSize, 0u);
+
+  auto *bytes = buffer.As<unsigned char>();
+  std::fill_n(bytes, buffer.size_bytes(), 0xAB);
+  EXPECT_EQ(bytes[buffer.size_bytes() - 1], 0xAB);
+}
+
+TEST_F(StreamBuffersTest, HugePageBuffer_ExplicitFallsBackWhenUnavailable) {
+  HugePageBuffer buffer(kHugePageSize, HugePageMode::kExplicit);
+  ASSERT_NE(buffer.data(), nullptr);
+  EXPECT_NE(buffer.mode(), HugePageMode::kNone);
+}
+
+TEST_F(StreamBuffersTest, HugePageBuffer_MoveTransfersOwnership) {
+  HugePageBuffer source(kHugePageSize, HugePageMode::kNone);
+  void *data = source.data();
+  HugePageBuffer destination(std::move(source));
+  EXPECT_EQ(destination.data(), data);
+  EXPECT_EQ(source.data(), nullptr);
+}
+
+TEST_F(StreamBuffersTest, StreamBuffers_IndexIsPermutation) {
+  StreamBuffers buffers(small_options);
+  const auto &arrays = buffers.arrays();
+  EXPECT_EQ(arrays.mask, small_options.length - 1);
+
+  std::vector<uint32_t> index(arrays.index, arrays.index + buffers.length());
+  std::sort(index.begin(), index.end());
+  for (size_t i = 0; i < index.size(); ++i) {
+    ASSERT_EQ(index[i], i);
+  }
+}
+
+TEST_F(StreamBuffersTest, StreamBuffers_RejectsNonPowerOfTwoLength) {
+  small_options.length = 1000;
+  EXPECT_THROW(StreamBuffers buffers(small_options), std::invalid_argument);
+}
+
+TEST_F(StreamBuffersTest, StreamingKernels_ComputeExpectedValues) {
+  small_options.prefetch_distance = 16;
+  StreamBuffers buffers(small_options);
+  const auto &arrays = buffers.arrays();
+
+  EXPECT_DOUBLE_EQ(ComputeTriad(arrays, 3), arrays.b[3] + kTriadScalar * 2.0);
+  EXPECT_DOUBLE_EQ(arrays.a[3], arrays.b[3] + kTriadScalar * 2.0);
+  EXPECT_DOUBLE_EQ(ComputeDot(arrays, 5), arrays.b[5] * 2.0);
+  EXPECT_DOUBLE_EQ(
+      ComputeStencil(arrays, arrays.mask),
+      0.25 * arrays.b[arrays.mask] + 0.5 * arrays.b[arrays.mask + 1] +
+          0.25 * arrays.b[arrays.mask + 2]
+  );
+  EXPECT_DOUBLE_EQ(ComputeGather(arrays, 7), arrays.b[arrays.index[7]]);
+}
+
+TEST_F(StreamBuffersTest, SharedStreamBuffers_RebuiltOnlyOnNewOptions) {
+  StreamOptions saved = GetStreamOptions();
+  GetStreamOptions() = small_options;
+
+  const StreamBuffers *first = &SharedStreamBuffers();
+  EXPECT_EQ(first->length(), small_options.length);
+  PrepareStreamBuffers();
+  EXPECT_EQ(&SharedStreamBuffers(), first);
+
+  GetStreamOptions().length = small_options.length * 2;
+  const StreamBuffers &rebuilt = SharedStreamBuffers();
+  EXPECT_EQ(rebuilt.length(), small_options.length * 2);
+
+  GetStreamOptions() = saved;
+}
+
+TEST_F(StreamBuffersTest, RunTestCase_PreparesOutsideTheClock) {
+  static bool prepared = false;
+  static bool prepared_first = false;
+  prepared = false;
+  TestCase test_case{
+      "stream_buffers_test::Prepared",
+      [](size_t) { prepared_first = prepared; },
+      [] {
+        prepared = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+      },
+  };
+  auto elapsed = RunTestCase(test_case, 1);
+  EXPECT_TRUE(prepared_first);
+  EXPECT_LT(elapsed.count(), 0.1);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
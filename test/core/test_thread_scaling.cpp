@@ -0,0 +1,111 @@
+#include "benchmark_utils.hpp"
+#include "test_runner.hpp"
+#include "thread_scaling.hpp"
+#include <atomic>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <gtest/gtest.h>
+
+using thread_scaling::RunConcurrently;
+using thread_scaling::ScalingResult;
+using thread_scaling::SinkLayout;
+
+namespace {
+
+std::atomic<size_t> g_calls{0};
+std::atomic<size_t> g_redirected_threads{0};
+
+void CountingTestCase(size_t iterations) {
+  if (GetThreadBenchmarkSink().target != &prevent_optimization) {
+    g_redirected_threads.fetch_add(1);
+  }
+  RunBenchmark("Counting", iterations, [](double x) {
+    g_calls.fetch_add(1, std::memory_order_relaxed);
+    return x;
+  });
+}
+
+} // namespace
+
+TEST(BenchmarkSinkTest, DefaultSinkPublishesFinalSum) {
+  const auto &sink = GetThreadBenchmarkSink();
+  EXPECT_EQ(sink.target, &prevent_optimization);
+  EXPECT_FALSE(sink.store_every_iteration);
+
+  RunBenchmark("Sum", 10, [](double x) { return x; });
+  EXPECT_DOUBLE_EQ(prevent_optimization, 20.0);
+}
+
+TEST(BenchmarkSinkTest, RedirectedSinkIsThreadLocal) {
+  volatile double slot = 0.0;
+  std::thread worker([&] {
+    auto &sink = GetThreadBenchmarkSink();
+    sink.target = &slot;
+    sink.store_every_iteration = true;
+    sink.print_time = false;
+    RunStreamBenchmark("Indices", 4, 3, [](size_t i) {
+      return static_cast<double>(i);
+    });
+  });
+  worker.join();
+
+  EXPECT_DOUBLE_EQ(slot, 6.0);
+  EXPECT_EQ(GetThreadBenchmarkSink().target, &prevent_optimization);
+}
+
+class RunConcurrentlyTest : public ::testing::TestWithParam<SinkLayout> {};
+
+TEST_P(RunConcurrentlyTest, EveryThreadRunsTheTestCase) {
+  g_calls = 0;
+  g_redirected_threads = 0;
+  TestCase test_case{"counting", CountingTestCase};
+
+  ScalingResult result = RunConcurrently(test_case, 1000, 3, GetParam());
+
+  EXPECT_EQ(g_calls.load(), 3000);
+  EXPECT_EQ(g_redirected_threads.load(), 3);
+  EXPECT_EQ(result.threads, 3);
+  EXPECT_EQ(result.calls, 3000);
+  EXPECT_GT(result.wall_seconds, 0.0);
+  EXPECT_LE(result.fastest_thread_seconds, result.slowest_thread_seconds);
+  EXPECT_DOUBLE_EQ(result.slowest_thread_seconds, result.wall_seconds);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Layouts,
+    RunConcurrentlyTest,
+    ::testing::Values(SinkLayout::kPadded, SinkLayout::kShared)
+);
+
+TEST(ThreadScalingTest, StreamingKernels_AreExcluded) {
+  EXPECT_TRUE(thread_scaling::SupportsThreadScaling(
+      test_runner::GetSingleTestCase("runtime", "fma")
+  ));
+  const TestCase &triad = test_runner::GetSingleTestCase("crtp", "triad");
+  EXPECT_FALSE(thread_scaling::SupportsThreadScaling(triad));
+  EXPECT_THROW(
+      RunConcurrently(triad, 1, 2, SinkLayout::kPadded),
+      std::invalid_argument
+  );
+}
+
+TEST(ThreadScalingTest, WriteScalingTable_EfficiencyAgainstOneThread) {
+  std::vector<ScalingResult> results = {
+      {1, SinkLayout::kPadded, 100, 1.0, 1.0, 1.0, true},
+      {2, SinkLayout::kPadded, 200, 2.0, 1.5, 2.0, true},
+      {1, SinkLayout::kShared, 100, 1.0, 1.0, 1.0, true},
+      {2, SinkLayout::kShared, 200, 1.0, 1.0, 1.0, false},
+  };
+  std::ostringstream out;
+  thread_scaling::WriteScalingTable(out, results);
+  std::string table = out.str();
+
+  // 2 threads at the 1-thread rate overall = 50%, at twice the rate = 100%
+  EXPECT_NE(table.find("| padded | 2 | yes | 2.000 | 0.00 | 50.00 | 1.33 |"),
+            std::string::npos)
+      << table;
+  EXPECT_NE(table.find("| shared | 2 | no | 1.000 | 0.00 | 100.00 | 1.00 |"),
+            std::string::npos)
+      << table;
+}
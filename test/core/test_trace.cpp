@@ -0,0 +1,86 @@
+#include "trace.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <gtest/gtest.h>
+
+class TraceTest : public ::testing::Test {
+protected:
+  std::string temp_dir;
+  std::string trace_file;
+
+  void SetUp() override {
+    temp_dir = std::filesystem::temp_directory_path() / "test_trace";
+    std::filesystem::create_directories(temp_dir);
+    trace_file = temp_dir + "/trace.json";
+    trace::ResetTrace();
+  }
+
+  void TearDown() override { std::filesystem::remove_all(temp_dir); }
+
+  std::string ReadFileContents(const std::string &filepath) {
+    std::ifstream file(filepath);
+    std::ostringstream content;
+    content << file.rdbuf();
+    return content.str();
+  }
+};
+
+TEST_F(TraceTest, ScopedEvent_RecordsOrderedInterval) {
+  { trace::ScopedEvent event("scoped"); }
+
+  const auto &buffer = trace::GetThreadBuffer();
+  ASSERT_EQ(buffer.total_recorded(), 1u);
+  buffer.ForEach([](const trace::TraceEvent &event) {
+    EXPECT_STREQ(event.name, "scoped");
+    EXPECT_LE(event.start_ns, event.end_ns);
+  });
+}
+
+TEST_F(TraceTest, RingBuffer_KeepsNewestEventsWhenFull) {
+  auto &buffer = trace::GetThreadBuffer();
+  for (uint64_t i = 0; i < trace::kRingCapacity + 10; ++i) {
+    buffer.Record("event", i, i + 1);
+  }
+
+  EXPECT_EQ(buffer.dropped(), 10u);
+  uint64_t expected_start = 10;
+  size_t visited = 0;
+  buffer.ForEach([&](const trace::TraceEvent &event) {
+    EXPECT_EQ(event.start_ns, expected_start++);
+    ++visited;
+  });
+  EXPECT_EQ(visited, trace::kRingCapacity);
+}
+
+TEST_F(TraceTest, Intern_ReturnsStablePointer) {
+  std::string name = "polymorphism_tests::TestCRTPFMA";
+  const char *first = trace::Intern(name);
+  name = "changed";
+  EXPECT_STREQ(first, "polymorphism_tests::TestCRTPFMA");
+  EXPECT_EQ(first, trace::Intern("polymorphism_tests::TestCRTPFMA"));
+}
+
+TEST_F(TraceTest, WriteChromeTrace_WritesEventsFromAllThreads) {
+  { trace::ScopedEvent event("main_\"quoted\""); }
+  std::thread worker([] { trace::ScopedEvent event("worker"); });
+  worker.join();
+
+  ASSERT_TRUE(trace::WriteChromeTrace(trace_file));
+  std::string content = ReadFileContents(trace_file);
+
+  EXPECT_TRUE(content.find("\"traceEvents\"") != std::string::npos);
+  EXPECT_TRUE(content.find("\"main_\\\"quoted\\\"\"") != std::string::npos);
+  EXPECT_TRUE(content.find("\"worker\"") != std::string::npos);
+  EXPECT_TRUE(content.find("\"ph\":\"X\"") != std::string::npos);
+}
+
+TEST_F(TraceTest, WriteChromeTrace_FailsForUnwritablePath) {
+  EXPECT_FALSE(trace::WriteChromeTrace(temp_dir + "/missing/trace.json"));
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,209 @@
+// Performance invariants of the dispatch models. Short calibrated runs (see
+// calibration.hpp) compare the real test cases with a statistical tolerance,
+// so a compiler or flag change that stops CRTP/Concepts from inlining fails
+// here. Failures print the timings and, where perf events are allowed,
+// hardware counters per call for both sides.
+
+#include "benchmark_utils.hpp"
+#include "calibration.hpp"
+#include "perf_counters.hpp"
+#include "test_runner.hpp"
+#include <cmath>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <string>
+#include <gtest/gtest.h>
+
+#ifndef COMPILER_FLAGS
+#define COMPILER_FLAGS "Unknown"
+#endif
+
+using calibration::Estimate;
+using calibration::NetCost;
+
+namespace {
+
+// Calls per run (each estimate is calibration::kRepetitions runs)
+constexpr size_t kCalls = 2'000'000;
+
+// Static dispatch inlines ComputeFMA into the loop; a virtual call can't,
+// so runtime should be well over this factor slower
+constexpr double kMinStaticSpeedup = 1.5;
+
+// Concepts and CRTP compile to the same loop, within this relative band
+constexpr double kBand = 0.25;
+
+// Standard errors of slack before an invariant fails
+constexpr double kSigmas = 3.0;
+
+std::string Format(const Estimate &estimate) {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(3) << estimate.value << " ± "
+      << estimate.uncertainty;
+  return out.str();
+}
+
+// slow / fast, with relative errors in quadrature
+Estimate Ratio(const Estimate &slow, const Estimate &fast) {
+  double ratio = slow.value / fast.value;
+  return {
+      ratio,
+      ratio * std::hypot(
+                  slow.uncertainty / slow.value,
+                  fast.uncertainty / fast.value
+              ),
+  };
+}
+
+class DispatchPerformanceTest : public ::testing::Test {
+protected:
+  static void SetUpTestSuite() {
+    calibration_ = new calibration::Calibration(calibration::Calibrate(kCalls));
+  }
+
+  static void TearDownTestSuite() {
+    delete calibration_;
+    calibration_ = nullptr;
+    costs_.clear();
+  }
+
+  void SetUp() override {
+    std::string flags = COMPILER_FLAGS;
+    bool optimized = flags.find("-O2") != std::string::npos ||
+                     flags.find("-O3") != std::string::npos;
+    if (!optimized || flags.find("-fno-inline") != std::string::npos) {
+      GTEST_SKIP() << "Invariants assume an -O2/-O3 build with inlining ("
+                   << flags << ")";
+    }
+  }
+
+  // Measured once per suite
+  static const NetCost &
+  Cost(const std::string &category, const std::string &computation) {
+    auto key = category + "/" + computation;
+    auto it = costs_.find(key);
+    if (it == costs_.end()) {
+      it = costs_
+               .emplace(
+                   key,
+                   calibration::MeasureNetCost(
+                       *calibration_,
+                       category,
+                       computation
+                   )
+               )
+               .first;
+    }
+    return it->second;
+  }
+
+  // Timings and counters per call for one case, for failure messages
+  static std::string Evidence(const NetCost &cost) {
+    std::ostringstream out;
+    out << "\n  " << cost.category << "/" << cost.computation
+        << ": raw " << Format(cost.raw_ns) << " ns/call, net of harness "
+        << Format(cost.net_ns) << " ns/call, vs inline kernel "
+        << Format(cost.dispatch_ns) << " ns/call";
+    if (cost.net_cycles) {
+      out << ", net " << Format(*cost.net_cycles) << " cycles/call";
+    }
+
+    PerfCounters counters;
+    if (!counters.available()) {
+      out << "\n    counters: unavailable (perf events not permitted)";
+      return out.str();
+    }
+    const TestCase &test_case =
+        test_runner::GetSingleTestCase(cost.category, cost.computation);
+    BenchmarkSink &sink = GetThreadBenchmarkSink();
+    bool print_time = sink.print_time;
+    sink.print_time = false;
+    counters.Start();
+    test_case.function(kCalls);
+    counters.Stop();
+    sink.print_time = print_time;
+
+    out << "\n    counters per call:";
+    for (const auto &reading : counters.Read()) {
+      out << " " << reading.name << " " << std::fixed << std::setprecision(2)
+          << static_cast<double>(reading.value) / kCalls;
+    }
+    return out.str();
+  }
+
+  // Fails unless slow is at least `factor` times fast, within kSigmas
+  static void ExpectFasterBy(
+      const NetCost &slow,
+      const NetCost &fast,
+      double factor
+  ) {
+    Estimate ratio = Ratio(slow.raw_ns, fast.raw_ns);
+    if (ratio.value + kSigmas * ratio.uncertainty < factor) {
+      ADD_FAILURE() << fast.category << "/" << fast.computation
+                    << " should be at least " << factor << "x faster than "
+                    << slow.category << "/" << slow.computation
+                    << ", measured " << Format(ratio) << "x"
+                    << Evidence(slow) << Evidence(fast);
+    }
+  }
+
+  // Fails unless actual is within kBand of reference, within kSigmas
+  static void ExpectWithinBand(const NetCost &actual, const NetCost &reference) {
+    Estimate difference =
+        calibration::Difference(actual.raw_ns, reference.raw_ns);
+    double allowed = kBand * reference.raw_ns.value;
+    if (std::fabs(difference.value) - kSigmas * difference.uncertainty >
+        allowed) {
+      ADD_FAILURE() << actual.category << "/" << actual.computation
+                    << " should be within " << kBand * 100 << "% of "
+                    << reference.category << "/" << reference.computation
+                    << ", measured a difference of " << Format(difference)
+                    << " ns/call (" << allowed << " allowed)"
+                    << Evidence(actual) << Evidence(reference);
+    }
+  }
+
+  static calibration::Calibration *calibration_;
+  static std::map<std::string, NetCost> costs_;
+};
+
+calibration::Calibration *DispatchPerformanceTest::calibration_ = nullptr;
+std::map<std::string, NetCost> DispatchPerformanceTest::costs_;
+
+} // namespace
+
+TEST_F(DispatchPerformanceTest, CRTPInlinesFMA) {
+  ExpectFasterBy(Cost("runtime", "fma"), Cost("crtp", "fma"), kMinStaticSpeedup);
+}
+
+TEST_F(DispatchPerformanceTest, ConceptsInlinesFMA) {
+  ExpectFasterBy(
+      Cost("runtime", "fma"),
+      Cost("concepts", "fma"),
+      kMinStaticSpeedup
+  );
+}
+
+TEST_F(DispatchPerformanceTest, ConceptsMatchesCRTP) {
+  for (const auto &computation : calibration::CalibratedComputations()) {
+    SCOPED_TRACE(computation);
+    ExpectWithinBand(Cost("concepts", computation), Cost("crtp", computation));
+  }
+}
+
+TEST_F(DispatchPerformanceTest, StaticDispatchMatchesInlineKernel) {
+  // CRTP adds nothing over calling the kernel directly
+  for (const auto &computation : calibration::CalibratedComputations()) {
+    SCOPED_TRACE(computation);
+    const NetCost &crtp = Cost("crtp", computation);
+    double allowed = kBand * calibration_->inline_ns.at(computation).value;
+    if (crtp.dispatch_ns.value - kSigmas * crtp.dispatch_ns.uncertainty >
+        allowed) {
+      ADD_FAILURE() << "crtp/" << computation << " costs "
+                    << Format(crtp.dispatch_ns)
+                    << " ns/call more than the inline kernel (" << allowed
+                    << " allowed)" << Evidence(crtp);
+    }
+  }
+}
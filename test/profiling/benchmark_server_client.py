@@ -0,0 +1,89 @@
+import json
+import subprocess
+import threading
+from pathlib import Path
+from typing import Iterable, Iterator
+
+
+class BenchmarkServerClient:
+    """
+    Drives one `benchmark --server` process: jobs are written to its stdin as
+    key=value lines and results come back as one JSON object per line, so
+    hundreds of jobs run without respawning the binary. Hardware counters
+    are read by the server around each job.
+    """
+
+    def __init__(
+        self,
+        executable: Path = Path("./build/bin/benchmark"),
+        extra_args: list[str] = None,
+        stderr=subprocess.DEVNULL,
+    ):
+        self.executable = executable
+        self.extra_args = extra_args or []
+        self.stderr = stderr
+        self.process = None
+        self.ready = None
+
+    def start(self):
+        self.process = subprocess.Popen(
+            [str(self.executable), "--server", *self.extra_args],
+            stdin=subprocess.PIPE,
+            stdout=subprocess.PIPE,
+            stderr=self.stderr,
+            text=True,
+            bufsize=1,
+        )
+        self.ready = self._read_result()
+        if self.ready.get("status") != "ready":
+            raise RuntimeError(f"Unexpected server greeting: {self.ready}")
+
+    def close(self):
+        if self.process is None:
+            return
+        if self.process.stdin and not self.process.stdin.closed:
+            self.process.stdin.write("quit\n")
+            self.process.stdin.close()
+        self.process.wait()
+        self.process = None
+
+    def __enter__(self):
+        self.start()
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        self.close()
+
+    @staticmethod
+    def format_job(job: dict) -> str:
+        return " ".join(f"{key}={value}" for key, value in job.items())
+
+    def _read_result(self) -> dict:
+        line = self.process.stdout.readline()
+        if not line:
+            raise RuntimeError("Benchmark server exited unexpectedly")
+        return json.loads(line)
+
+    def run_jobs(self, jobs: Iterable[dict]) -> Iterator[dict]:
+        """
+        Queues every job up front (from a writer thread, so a full stdout
+        pipe can't deadlock us) and yields results in submission order as
+        they stream back.
+        """
+        jobs = list(jobs)
+
+        def submit_all():
+            for job in jobs:
+                self.process.stdin.write(self.format_job(job) + "\n")
+            self.process.stdin.flush()
+
+        writer = threading.Thread(target=submit_all)
+        writer.start()
+        try:
+            for _ in jobs:
+                yield self._read_result()
+        finally:
+            writer.join()
+
+    def run_job(self, job: dict) -> dict:
+        return next(self.run_jobs([job]))
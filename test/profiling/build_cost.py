@@ -0,0 +1,550 @@
+"""
+Build-cost benchmark for the dispatch models. For every model it generates a
+translation unit with K concrete types x M kernels (the same shapes as
+runtime_polymorphism, crtp_polymorphism, concepts_polymorphism and
+value_polymorphism, with methods Kernel0 ... Kernel{M-1}), compiles it, links
+it into an executable and records:
+
+- compile wall time, plus the compiler's own breakdown (GCC -ftime-report
+  phases, or the Clang -ftime-trace totals)
+- object and binary size, and their .text sizes
+- defined function symbols in the object and the binary
+
+Sizes and symbol counts are read straight from the ELF files, so no binutils
+are needed.
+"""
+
+import argparse
+import csv
+import json
+import re
+import struct
+import subprocess
+import tempfile
+import time
+from datetime import datetime
+from pathlib import Path
+
+MODELS = ["runtime", "crtp", "concepts", "variant", "type_erased"]
+DEFAULT_TYPES = [4, 16, 64]
+DEFAULT_KERNELS = [1, 4, 16]
+DEFAULT_OPTIMIZATION_LEVELS = ["O0", "O3"]
+DATA_DIR = Path("./data/build_cost")
+
+# Compile phases reported from GCC's -ftime-report, as (column, pattern)
+GCC_PHASES = [
+    ("parse_s", r"phase parsing"),
+    ("template_instantiation_s", r"template instantiation"),
+    ("opt_and_generate_s", r"phase opt and generate"),
+]
+
+# Top-level Clang -ftime-trace totals, as (column, event name)
+CLANG_PHASES = [
+    ("parse_s", "Total Frontend"),
+    ("template_instantiation_s", "Total InstantiateFunction"),
+    ("opt_and_generate_s", "Total Backend"),
+]
+
+FIELDS = [
+    "model",
+    "types",
+    "kernels",
+    "optimization",
+    "compile_s",
+    "parse_s",
+    "template_instantiation_s",
+    "opt_and_generate_s",
+    "link_s",
+    "object_bytes",
+    "object_text_bytes",
+    "object_functions",
+    "binary_bytes",
+    "binary_text_bytes",
+    "binary_functions",
+]
+
+
+# ===========================
+# SOURCE GENERATION
+# ===========================
+
+
+def kernel_body(type_index: int, kernel_index: int) -> str:
+    """Distinct constants per (type, kernel) so no two bodies fold together."""
+    scale = 1.0 + 0.001 * (type_index + 1)
+    offset = 0.01 * (kernel_index + 1)
+    return f"return x * {scale!r} + {offset!r};"
+
+
+def runtime_source(types: int, kernels: int) -> str:
+    lines = ["struct RuntimeBase {", "  virtual ~RuntimeBase() = default;"]
+    lines += [
+        f"  virtual double Kernel{j}(double x) const = 0;" for j in range(kernels)
+    ]
+    lines.append("};")
+    for i in range(types):
+        lines.append(f"struct Type{i} : RuntimeBase {{")
+        lines += [
+            f"  double Kernel{j}(double x) const override {{ {kernel_body(i, j)} }}"
+            for j in range(kernels)
+        ]
+        lines.append("};")
+
+    objects = ", ".join(f"new Type{i}()" for i in range(types))
+    calls = " + ".join(f"object->Kernel{j}(x)" for j in range(kernels))
+    lines += [
+        'extern "C" double RunAll(double x, int rounds) {',
+        f"  static const RuntimeBase *objects[] = {{{objects}}};",
+        "  double sum = 0.0;",
+        "  for (int round = 0; round < rounds; ++round) {",
+        "    for (const RuntimeBase *object : objects) {",
+        f"      sum += {calls};",
+        "    }",
+        "  }",
+        "  return sum;",
+        "}",
+    ]
+    return "\n".join(lines)
+
+
+def crtp_source(types: int, kernels: int) -> str:
+    lines = ["template <typename Derived>", "struct CRTPBase {"]
+    lines += [
+        f"  double Kernel{j}(double x) const {{\n"
+        f"    return static_cast<const Derived &>(*this).Kernel{j}Impl(x);\n"
+        "  }"
+        for j in range(kernels)
+    ]
+    lines.append("};")
+    for i in range(types):
+        lines.append(f"struct Type{i} : CRTPBase<Type{i}> {{")
+        lines += [
+            f"  double Kernel{j}Impl(double x) const {{ {kernel_body(i, j)} }}"
+            for j in range(kernels)
+        ]
+        lines.append("};")
+
+    calls = " + ".join(f"object.Kernel{j}(x)" for j in range(kernels))
+    lines += [
+        "template <typename Derived>",
+        "double Drive(const CRTPBase<Derived> &object, double x) {",
+        f"  return {calls};",
+        "}",
+    ]
+    lines += driver_over_types(types, "Drive(Type{i}{{}}, x)")
+    return "\n".join(lines)
+
+
+def concepts_source(types: int, kernels: int) -> str:
+    lines = ["#include <concepts>", "template <typename T>", "concept Computable ="]
+    requirements = " &&\n".join(
+        f"  requires(const T &t, double x) {{\n"
+        f"    {{ t.Kernel{j}(x) }} -> std::convertible_to<double>;\n"
+        "  }"
+        for j in range(kernels)
+    )
+    lines.append(requirements + ";")
+    for i in range(types):
+        lines.append(f"struct Type{i} {{")
+        lines += [
+            f"  double Kernel{j}(double x) const {{ {kernel_body(i, j)} }}"
+            for j in range(kernels)
+        ]
+        lines.append("};")
+
+    calls = " + ".join(f"object.Kernel{j}(x)" for j in range(kernels))
+    lines += [
+        "template <Computable T>",
+        "double Drive(const T &object, double x) {",
+        f"  return {calls};",
+        "}",
+    ]
+    lines += driver_over_types(types, "Drive(Type{i}{{}}, x)")
+    return "\n".join(lines)
+
+
+def variant_source(types: int, kernels: int) -> str:
+    lines = ["#include <variant>"]
+    for i in range(types):
+        lines.append(f"struct Type{i} {{")
+        lines += [
+            f"  double Kernel{j}(double x) const {{ {kernel_body(i, j)} }}"
+            for j in range(kernels)
+        ]
+        lines.append("};")
+
+    alternatives = ", ".join(f"Type{i}" for i in range(types))
+    objects = ", ".join(f"Poly(Type{i}{{}})" for i in range(types))
+    calls = " + ".join(
+        f"std::visit([x](const auto &held) {{ return held.Kernel{j}(x); }}, object)"
+        for j in range(kernels)
+    )
+    lines += [
+        f"using Poly = std::variant<{alternatives}>;",
+        'extern "C" double RunAll(double x, int rounds) {',
+        f"  static const Poly objects[] = {{{objects}}};",
+        "  double sum = 0.0;",
+        "  for (int round = 0; round < rounds; ++round) {",
+        "    for (const Poly &object : objects) {",
+        f"      sum += {calls};",
+        "    }",
+        "  }",
+        "  return sum;",
+        "}",
+    ]
+    return "\n".join(lines)
+
+
+def type_erased_source(types: int, kernels: int) -> str:
+    lines = ["#include <new>", "struct Ops {"]
+    lines += [f"  double (*kernel{j})(const void *, double);" for j in range(kernels)]
+    lines.append("};")
+    lines += [
+        "template <typename T>",
+        "inline constexpr Ops kOpsFor = {",
+    ]
+    lines += [
+        f"    [](const void *self, double x) {{\n"
+        f"      return static_cast<const T *>(self)->Kernel{j}(x);\n"
+        "    },"
+        for j in range(kernels)
+    ]
+    lines += [
+        "};",
+        "class PolyAny {",
+        "public:",
+        "  template <typename T>",
+        "  PolyAny(T value) : ops_(&kOpsFor<T>) { new (storage_) T(value); }",
+    ]
+    lines += [
+        f"  double Kernel{j}(double x) const {{ return ops_->kernel{j}(storage_, x); }}"
+        for j in range(kernels)
+    ]
+    lines += [
+        "private:",
+        "  const Ops *ops_;",
+        "  alignas(8) unsigned char storage_[16];",
+        "};",
+    ]
+    for i in range(types):
+        lines.append(f"struct Type{i} {{")
+        lines += [
+            f"  double Kernel{j}(double x) const {{ {kernel_body(i, j)} }}"
+            for j in range(kernels)
+        ]
+        lines.append("};")
+
+    objects = ", ".join(f"PolyAny(Type{i}{{}})" for i in range(types))
+    calls = " + ".join(f"object.Kernel{j}(x)" for j in range(kernels))
+    lines += [
+        'extern "C" double RunAll(double x, int rounds) {',
+        f"  static const PolyAny objects[] = {{{objects}}};",
+        "  double sum = 0.0;",
+        "  for (int round = 0; round < rounds; ++round) {",
+        "    for (const PolyAny &object : objects) {",
+        f"      sum += {calls};",
+        "    }",
+        "  }",
+        "  return sum;",
+        "}",
+    ]
+    return "\n".join(lines)
+
+
+def driver_over_types(types: int, call_pattern: str) -> list[str]:
+    """RunAll for the static models: one Drive<T> instantiation per type."""
+    calls = " +\n           ".join(
+        call_pattern.format(i=i) for i in range(types)
+    )
+    return [
+        'extern "C" double RunAll(double x, int rounds) {',
+        "  double sum = 0.0;",
+        "  for (int round = 0; round < rounds; ++round) {",
+        f"    sum += {calls};",
+        "    x = sum * 1e-9;",
+        "  }",
+        "  return sum;",
+        "}",
+    ]
+
+
+GENERATORS = {
+    "runtime": runtime_source,
+    "crtp": crtp_source,
+    "concepts": concepts_source,
+    "variant": variant_source,
+    "type_erased": type_erased_source,
+}
+
+MAIN_SOURCE = """#include <cstdio>
+#include <cstdlib>
+extern "C" double RunAll(double x, int rounds);
+int main(int argc, char **argv) {
+  int rounds = argc > 1 ? std::atoi(argv[1]) : 1;
+  std::printf("%f\\n", RunAll(1.0, rounds));
+}
+"""
+
+
+# ===========================
+# ELF INSPECTION
+# ===========================
+
+
+def elf_stats(path: Path) -> tuple[int, int]:
+    """
+    Returns (.text bytes, defined function symbols) of a 64-bit little-endian
+    ELF file, reading .symtab (or .dynsym if stripped).
+    """
+    data = path.read_bytes()
+    if data[:4] != b"\x7fELF" or data[4] != 2:
+        return 0, 0
+    section_offset = struct.unpack_from("<Q", data, 0x28)[0]
+    entry_size, count, names_index = struct.unpack_from("<HHH", data, 0x3A)
+    sections = [
+        struct.unpack_from("<IIQQQQIIQQ", data, section_offset + i * entry_size)
+        for i in range(count)
+    ]
+    names_offset = sections[names_index][4]
+
+    def section_name(section) -> bytes:
+        start = names_offset + section[0]
+        return data[start : data.index(b"\0", start)]
+
+    text_bytes = 0
+    symbol_table = None
+    for section in sections:
+        name, kind = section_name(section), section[1]
+        if name == b".text" or name.startswith(b".text."):
+            text_bytes += section[5]
+        if kind == 2 or (kind == 11 and symbol_table is None):  # SYMTAB, DYNSYM
+            symbol_table = section
+
+    functions = 0
+    if symbol_table is not None:
+        offset, size, symbol_size = symbol_table[4], symbol_table[5], symbol_table[9]
+        for start in range(offset, offset + size, symbol_size):
+            info, _, section_index = struct.unpack_from("<BBH", data, start + 4)
+            if info & 0xF == 2 and section_index != 0:  # STT_FUNC, defined
+                functions += 1
+    return text_bytes, functions
+
+
+# ===========================
+# COMPILE AND MEASURE
+# ===========================
+
+
+def is_clang(compiler: str) -> bool:
+    result = subprocess.run(
+        [compiler, "--version"], capture_output=True, text=True, check=True
+    )
+    return "clang" in result.stdout.lower()
+
+
+def parse_gcc_time_report(stderr: str) -> dict:
+    """
+    Wall seconds of the GCC phases of interest (usr, sys, wall columns).
+    GCC leaves out phases that took negligible time; those count as zero.
+    """
+    default = 0.0 if "TOTAL" in stderr else None
+    phases = {column: default for column, _ in GCC_PHASES}
+    for line in stderr.splitlines():
+        for column, pattern in GCC_PHASES:
+            if re.match(r"\s*" + pattern + r"\s*:", line):
+                times = re.findall(r"(\d+\.\d+)\s*\(\s*\d+%\)", line)
+                if len(times) >= 3:
+                    phases[column] = float(times[2])
+    return phases
+
+
+def parse_clang_time_trace(trace_path: Path) -> dict:
+    """Seconds of the top-level totals in a Clang -ftime-trace file."""
+    if not trace_path.exists():
+        return {column: None for column, _ in CLANG_PHASES}
+    events = json.loads(trace_path.read_text()).get("traceEvents", [])
+    durations = {event.get("name"): event.get("dur", 0) for event in events}
+    return {
+        column: durations[name] / 1e6 if name in durations else None
+        for column, name in CLANG_PHASES
+    }
+
+
+def measure_case(
+    compiler: str,
+    clang: bool,
+    model: str,
+    types: int,
+    kernels: int,
+    optimization: str,
+    work_dir: Path,
+) -> dict:
+    stem = f"{model}_k{types}_m{kernels}_{optimization.lower()}"
+    source = work_dir / f"{stem}.cpp"
+    obj = work_dir / f"{stem}.o"
+    binary = work_dir / stem
+    source.write_text(GENERATORS[model](types, kernels) + "\n")
+
+    flags = ["-std=c++20", f"-{optimization}", "-c"]
+    flags.append("-ftime-trace" if clang else "-ftime-report")
+    start = time.perf_counter()
+    result = subprocess.run(
+        [compiler, *flags, str(source), "-o", str(obj)],
+        capture_output=True,
+        text=True,
+        check=True,
+    )
+    compile_s = time.perf_counter() - start
+    phases = (
+        parse_clang_time_trace(obj.with_suffix(".json"))
+        if clang
+        else parse_gcc_time_report(result.stderr)
+    )
+
+    main_obj = work_dir / f"main_{optimization.lower()}.o"
+    if not main_obj.exists():
+        main_source = work_dir / "main.cpp"
+        main_source.write_text(MAIN_SOURCE)
+        subprocess.run(
+            [compiler, "-std=c++20", f"-{optimization}", "-c", str(main_source),
+             "-o", str(main_obj)],
+            check=True,
+        )
+    start = time.perf_counter()
+    subprocess.run(
+        [compiler, str(obj), str(main_obj), "-o", str(binary)], check=True
+    )
+    link_s = time.perf_counter() - start
+    subprocess.run([str(binary), "1"], check=True, capture_output=True)
+
+    object_text, object_functions = elf_stats(obj)
+    binary_text, binary_functions = elf_stats(binary)
+    return {
+        "model": model,
+        "types": types,
+        "kernels": kernels,
+        "optimization": optimization,
+        "compile_s": compile_s,
+        **phases,
+        "link_s": link_s,
+        "object_bytes": obj.stat().st_size,
+        "object_text_bytes": object_text,
+        "object_functions": object_functions,
+        "binary_bytes": binary.stat().st_size,
+        "binary_text_bytes": binary_text,
+        "binary_functions": binary_functions,
+    }
+
+
+def format_seconds(value) -> str:
+    return "n/a" if value is None else f"{value:.3f}"
+
+
+def print_markdown_table(rows: list[dict]):
+    print(
+        "| Opt | Model | K Types | M Kernels | Compile (s) | Templates (s) "
+        "| Object .text (B) | Binary (B) | Functions (obj / bin) |"
+    )
+    print("|-----|-------|------|------|------|------|------|------|------|")
+    for row in rows:
+        print(
+            f"| {row['optimization']} | {row['model']} | {row['types']} "
+            f"| {row['kernels']} | {row['compile_s']:.3f} "
+            f"| {format_seconds(row['template_instantiation_s'])} "
+            f"| {row['object_text_bytes']} | {row['binary_bytes']} "
+            f"| {row['object_functions']} / {row['binary_functions']} |"
+        )
+
+
+def run_build_cost(
+    compiler: str,
+    models: list[str],
+    types: list[int],
+    kernels: list[int],
+    optimization_levels: list[str],
+    output_dir: Path,
+    keep_sources: bool = False,
+) -> Path:
+    clang = is_clang(compiler)
+    rows = []
+    with tempfile.TemporaryDirectory(prefix="build_cost_") as temp_dir:
+        work_dir = output_dir / "generated" if keep_sources else Path(temp_dir)
+        work_dir.mkdir(parents=True, exist_ok=True)
+        for optimization in optimization_levels:
+            for model in models:
+                for type_count in types:
+                    for kernel_count in kernels:
+                        print(
+                            f"🔨 {model}: {type_count} types x {kernel_count} "
+                            f"kernels at -{optimization}",
+                            flush=True,
+                        )
+                        rows.append(
+                            measure_case(
+                                compiler,
+                                clang,
+                                model,
+                                type_count,
+                                kernel_count,
+                                optimization,
+                                work_dir,
+                            )
+                        )
+
+    output_dir.mkdir(parents=True, exist_ok=True)
+    csv_path = output_dir / f"{datetime.now():%Y-%m-%d-%H-%M-%S}.csv"
+    with csv_path.open("w", newline="") as csv_file:
+        writer = csv.DictWriter(csv_file, fieldnames=FIELDS)
+        writer.writeheader()
+        writer.writerows(rows)
+
+    print()
+    print_markdown_table(rows)
+    print(f"\n📄 Results saved to: {csv_path}")
+    return csv_path
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Measure compile time, code size and symbol counts of "
+        "generated K types x M kernels for each dispatch model."
+    )
+    parser.add_argument("--compiler", default="c++", help="C++ compiler to run")
+    parser.add_argument(
+        "--models", nargs="+", choices=MODELS, default=MODELS, help="Dispatch models"
+    )
+    parser.add_argument(
+        "--types", nargs="+", type=int, default=DEFAULT_TYPES,
+        help="Values of K (concrete types)",
+    )
+    parser.add_argument(
+        "--kernels", nargs="+", type=int, default=DEFAULT_KERNELS,
+        help="Values of M (kernels per type)",
+    )
+    parser.add_argument(
+        "--opt", nargs="+", choices=["O0", "O1", "O2", "O3"],
+        default=DEFAULT_OPTIMIZATION_LEVELS, help="Optimization levels",
+    )
+    parser.add_argument(
+        "--output-dir", type=Path, default=DATA_DIR,
+        help=f"Where the CSV goes (default {DATA_DIR})",
+    )
+    parser.add_argument(
+        "--keep-sources", action="store_true",
+        help="Keep the generated sources and objects under <output-dir>/generated",
+    )
+    args = parser.parse_args()
+
+    run_build_cost(
+        args.compiler,
+        args.models,
+        args.types,
+        args.kernels,
+        args.opt,
+        args.output_dir,
+        args.keep_sources,
+    )
+
+
+if __name__ == "__main__":
+    main()
@@ -1,46 +1,87 @@
 import subprocess
+from concurrent.futures import ThreadPoolExecutor, as_completed
 from pathlib import Path
 import argparse
+import os
 
 
-def convert_perf_data(perf_data_path: Path, executable_path: Path):
-    """Convert perf.data to pprof-compatible profile.pb.gz format."""
-    output_pprof_file = perf_data_path.with_suffix(".pb.gz")
+def convert_perf_data(perf_data_path: Path, executable_path: Path) -> bool:
+    """
+    Convert perf.data to pprof-compatible profile.pb.gz format.
 
-    perf_script_cmd = f"perf script -i {perf_data_path}"
-    pprof_cmd = f"pprof --symbolize --proto {executable_path}"
+    `perf script` output is piped straight into pprof, so the (potentially
+    multi-GB) text never lands on disk or in this process's memory.
+    """
+    output_pprof_file = perf_data_path.with_suffix(".pb.gz")
 
-    full_command = f"{perf_script_cmd} | {pprof_cmd} > {output_pprof_file}"
+    perf_script_cmd = ["perf", "script", "-i", str(perf_data_path)]
+    pprof_cmd = ["pprof", "--symbolize", "--proto", str(executable_path)]
 
     print(f"🔄 Converting: {perf_data_path.name} -> {output_pprof_file.name}")
 
-    try:
-        subprocess.run(
-            full_command, shell=True, check=True, executable="/bin/bash"
+    with output_pprof_file.open(mode="wb") as output_file:
+        perf_script = subprocess.Popen(perf_script_cmd, stdout=subprocess.PIPE)
+        pprof = subprocess.Popen(
+            pprof_cmd, stdin=perf_script.stdout, stdout=output_file
         )
-        print(f"✅ Successfully converted: {output_pprof_file}")
-    except subprocess.CalledProcessError as e:
-        print(f"❌ Error converting {perf_data_path.name}: {e}")
+        # Let perf script get SIGPIPE if pprof exits early
+        perf_script.stdout.close()
+        pprof_status = pprof.wait()
+        perf_script_status = perf_script.wait()
 
+    if perf_script_status != 0 or pprof_status != 0:
+        print(
+            f"❌ Error converting {perf_data_path.name}: perf script exited "
+            f"with {perf_script_status}, pprof exited with {pprof_status}"
+        )
+        return False
 
-def process_directory(directory: Path):
-    """Process all perf .data files in the given directory."""
+    print(f"✅ Successfully converted: {output_pprof_file}")
+    return True
+
+
+def find_conversion_jobs(directory: Path) -> list[tuple[Path, Path]]:
+    """Returns (perf .data file, benchmark executable) pairs in directory."""
     benchmark_executable = directory / "benchmark"
 
     # Ensure benchmark executable exists
     if not benchmark_executable.exists():
         print(f"⚠️ Benchmark executable not found in {directory}. Skipping.")
-        return
+        return []
 
     # Find all perf .data files
-    perf_data_files = list(directory.glob("perf_*.data"))
+    perf_data_files = sorted(directory.glob("perf_*.data"))
 
     if not perf_data_files:
         print(f"⚠️ No perf .data files found in {directory}.")
-        return
+        return []
+
+    return [
+        (perf_data_file, benchmark_executable)
+        for perf_data_file in perf_data_files
+    ]
+
+
+def process_directories(directories: list[Path], jobs: int):
+    """Converts all perf .data files in the given directories in parallel."""
+    conversion_jobs = [
+        job for directory in directories for job in find_conversion_jobs(directory)
+    ]
 
-    for perf_data_file in perf_data_files:
-        convert_perf_data(perf_data_file, benchmark_executable)
+    # Each conversion runs in its own subprocesses, so threads are enough
+    with ThreadPoolExecutor(max_workers=jobs) as executor:
+        futures = [
+            executor.submit(convert_perf_data, perf_data_path, executable_path)
+            for perf_data_path, executable_path in conversion_jobs
+        ]
+        num_converted = sum(future.result() for future in as_completed(futures))
+
+    print(f"Converted {num_converted} of {len(conversion_jobs)} perf .data files.")
+
+
+def process_directory(directory: Path, jobs: int = 1):
+    """Process all perf .data files in the given directory."""
+    process_directories([directory], jobs)
 
 
 def main():
@@ -48,21 +89,31 @@ def main():
         description="Convert perf .data files to pprof .pb.gz format."
     )
     parser.add_argument(
-        "directory",
+        "directories",
         type=str,
-        help="Path to the directory containing perf .data files and the benchmark executable.",
+        nargs="+",
+        help="Paths to directories containing perf .data files and the benchmark executable.",
+    )
+    parser.add_argument(
+        "-j",
+        "--jobs",
+        type=int,
+        default=os.cpu_count() or 1,
+        help="Number of conversions to run in parallel (default: number of CPUs)",
     )
     args = parser.parse_args()
 
-    target_directory = Path(args.directory)
-
-    if not target_directory.exists() or not target_directory.is_dir():
-        print(
-            f"❌ Error: Directory {target_directory} does not exist or is not a directory."
-        )
-        return
-
-    process_directory(target_directory)
+    target_directories = []
+    for directory in args.directories:
+        target_directory = Path(directory)
+        if not target_directory.exists() or not target_directory.is_dir():
+            print(
+                f"❌ Error: Directory {target_directory} does not exist or is not a directory."
+            )
+            return
+        target_directories.append(target_directory)
+
+    process_directories(target_directories, args.jobs)
 
 
 if __name__ == "__main__":
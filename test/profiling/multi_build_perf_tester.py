@@ -2,6 +2,7 @@ import argparse
 import project_builder as pb
 import perf_tests as pt
 import perf_data_cleaner as pdc
+import result_cache as rc
 
 
 def parse_arguments() -> argparse.Namespace:
@@ -29,8 +30,8 @@ def parse_arguments() -> argparse.Namespace:
         "--compute_functions",
         type=str,
         nargs="+",
-        default=["fma", "expensive"],
-        help="List of compute functions to test (default = fma, expensive).",
+        default=pt.load_test_categories()["compute_functions"],
+        help=pt.compute_functions_help(),
     )
     parser.add_argument(
         "-r",
@@ -46,6 +47,13 @@ def parse_arguments() -> argparse.Namespace:
         default=1000000000,
         help="Number of iterations per run (default = 1000000000).",
     )
+    parser.add_argument(
+        "-S",
+        "--server",
+        action="store_true",
+        help="Run each build's jobs in one `benchmark --server` process.",
+    )
+    pt.add_cache_arguments(parser)
     return parser.parse_args()
 
 
@@ -57,12 +65,16 @@ class MultiBuildPerfTester:
         compute_functions: list[str],
         num_runs_per_condition: int,
         num_iterations_per_run: int = 1000000000,
+        use_server: bool = False,
+        cache: rc.ResultCache = None,
     ):
         self.optimization_levels = optimization_levels
         self.polymorphism_types = polymorphism_types
         self.compute_functions = compute_functions
         self.num_runs_per_condition = num_runs_per_condition
         self.num_iterations_per_run = num_iterations_per_run
+        self.use_server = use_server
+        self.cache = cache
 
     def run_tests(self):
         for level in self.optimization_levels:
@@ -77,6 +89,7 @@ class MultiBuildPerfTester:
                 num_runs_per_condition=self.num_runs_per_condition,
                 dir_suffix=level,
                 num_iterations_per_run=self.num_iterations_per_run,
+                cache=self.cache,
             )
 
             if builder.binary_size is not None:
@@ -91,10 +104,13 @@ class MultiBuildPerfTester:
                         f"{builder.binary_size / 1024:.2f} KB"
                     )
 
-            multi_test_runner.run_tests()
-            pdc.build_detail_and_summary_dfs(
-                data_dir=multi_test_runner.output_dir
-            )
+            if self.use_server:
+                multi_test_runner.run_tests_with_server()
+            else:
+                multi_test_runner.run_tests()
+                pdc.build_detail_and_summary_dfs(
+                    data_dir=multi_test_runner.output_dir
+                )
 
 
 if __name__ == "__main__":
@@ -107,6 +123,8 @@ if __name__ == "__main__":
         compute_functions=args.compute_functions,
         num_runs_per_condition=args.num_runs_per_condition,
         num_iterations_per_run=args.num_iterations_per_run,
+        use_server=args.server,
+        cache=pt.cache_from_arguments(args),
     )
 
     mult_build_tester.run_tests()
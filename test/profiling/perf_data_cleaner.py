@@ -1,118 +1,297 @@
+from concurrent.futures import ProcessPoolExecutor
 from pathlib import Path
-import pandas as pd
-import pyarrow.feather as feather
+from typing import Iterable, Iterator
+import os
 import re
 
+import pandas as pd
+import pyarrow as pa
+import pyarrow.feather as feather
+import pyarrow.ipc as ipc
 
-def parse_benchmark_results(output):
-    benchmark_summary = {}
-
-    # Extract test name and iteration count from first part
-    benchmark_pattern = re.compile(
-        r"Running: (?P<test_name>.*?)\n"
-        r"Iteration Count: (?P<iteration_count>\d+)"
-    )
-    matches = benchmark_pattern.findall(output)
 
-    if matches:
-        test_name, iteration_count = matches[0]
-        benchmark_summary["Test Name"] = test_name
-        benchmark_summary["Mean Iteration Count"] = int(iteration_count)
+# Field separator passed to `perf stat -x`
+PERF_CSV_SEPARATOR = ","
 
-    # Extract mean time and error percentage from the last part
-    time_pattern = re.search(
-        r"(\d+\.\d+) \+\- (\d+\.\d+) seconds time elapsed  \( \+\-\s*(\d+\.\d+)% \)",
-        output,
-    )
-    if time_pattern:
-        benchmark_summary["Mean Time"] = float(time_pattern.group(1))
-        benchmark_summary["Mean Time (% error)"] = float(time_pattern.group(3))
+# Lines written by the benchmark executable itself
+RUNNING_PATTERN = re.compile(r"^Running: (?P<test_name>.*)$")
+ITERATION_PATTERN = re.compile(r"^Iteration Count: (?P<iteration_count>\d+)")
 
-    return benchmark_summary
+# Lines of the human-readable `perf stat` summary (legacy text dumps)
+TIME_PATTERN = re.compile(
+    r"(\d+\.\d+) \+\- (\d+\.\d+) seconds time elapsed  \( \+\-\s*(\d+\.\d+)% \)"
+)
+COUNTER_PATTERN = re.compile(
+    r"^\s*(?P<counts>[\d,]+)\s+(?P<metric>[\w\./_\-]+)\s+(?:\( \+\-\s*(?P<error>-?\d+\.\d+)% \))?"
+)
+COUNTER_SECTION_PATTERN = re.compile(r"Performance counter stats for .*:")
 
 
 def clean_metric_name(metric: str) -> str:
     return metric.replace("cpu_core/", "").rstrip("/")
 
 
-def parse_performance_counters(output):
+def iter_lines(file_path: Path) -> Iterator[str]:
+    """Yields lines one at a time so that large dumps are never fully loaded."""
+    with file_path.open(mode="r", encoding="utf-8", errors="ignore") as file:
+        for line in file:
+            yield line.rstrip("\n")
+
+
+def parse_csv_counter_line(line: str) -> tuple[str, int | None, float | None] | None:
+    """
+    Parses one `perf stat -x,` line:
+    value,unit,event,variance,run-time,enabled-pct[,metric-value,metric-unit]
+    Returns (metric, count, % error), or None if the line isn't a counter.
+    """
+    fields = line.split(PERF_CSV_SEPARATOR)
+    if len(fields) < 4 or not fields[2]:
+        return None
+    value, _unit, event, variance = fields[:4]
+    if not (value.replace(".", "", 1).isdigit() or value.startswith("<")):
+        return None
+
+    count = int(float(value)) if not value.startswith("<") else None
+    error = float(variance.rstrip("%")) if variance.endswith("%") else None
+    return clean_metric_name(event), count, error
+
+
+def parse_perf_output_stream(lines: Iterable[str]) -> dict:
+    """
+    Single pass over benchmark + `perf stat` output. Handles both the CSV
+    format produced with `-x,` and legacy human-readable dumps.
+    """
+    benchmark_summary = {}
     counts_results = {}
     errors_results = {}
-
-    # Extract the performance counter section only
-    perf_section_match = re.search(
-        r"Performance counter stats for .*?:\n(.*?)(?:\n\n|$)",
-        output,
-        re.DOTALL,
-    )
-    if not perf_section_match:
-        return {}, {}
-    perf_section = perf_section_match.group(1)
-
-    perf_pattern = re.compile(
-        r"(?P<counts>[\d,]+)\s+(?P<metric>[\w\./_\-]+)\s+(?:\( \+\-\s*(?P<error>-?\d+\.\d+)% \))?"
-    )
-
-    for match in perf_pattern.finditer(perf_section):
-        counts = match.group("counts").replace(",", "")
-        error = match.group("error")
-        metric_name = clean_metric_name(match.group("metric"))
-        counts_results[metric_name] = int(counts) if counts.isdigit() else None
-        errors_results[f"{metric_name} (% error)"] = (
-            float(error) if error is not None else None
+    in_text_counter_section = False
+
+    for line in lines:
+        if "Test Name" not in benchmark_summary:
+            match = RUNNING_PATTERN.match(line)
+            if match:
+                benchmark_summary["Test Name"] = match.group("test_name")
+                continue
+        if "Mean Iteration Count" not in benchmark_summary:
+            match = ITERATION_PATTERN.match(line)
+            if match:
+                benchmark_summary["Mean Iteration Count"] = int(
+                    match.group("iteration_count")
+                )
+                continue
+
+        csv_counter = parse_csv_counter_line(line)
+        if csv_counter is not None:
+            metric_name, count, error = csv_counter
+            if metric_name == "duration_time":
+                # duration_time is reported in ns; keep the legacy columns
+                if count is not None:
+                    benchmark_summary["Mean Time"] = count / 1e9
+                benchmark_summary["Mean Time (% error)"] = error
+                continue
+            counts_results[metric_name] = count
+            errors_results[f"{metric_name} (% error)"] = error
+            continue
+
+        if COUNTER_SECTION_PATTERN.search(line):
+            in_text_counter_section = True
+            continue
+        if in_text_counter_section:
+            match = COUNTER_PATTERN.match(line)
+            if match:
+                counts = match.group("counts").replace(",", "")
+                error = match.group("error")
+                metric_name = clean_metric_name(match.group("metric"))
+                counts_results[metric_name] = (
+                    int(counts) if counts.isdigit() else None
+                )
+                errors_results[f"{metric_name} (% error)"] = (
+                    float(error) if error is not None else None
+                )
+                continue
+            if not line.strip() and counts_results:
+                in_text_counter_section = False
+
+        time_match = TIME_PATTERN.search(line)
+        if time_match:
+            benchmark_summary["Mean Time"] = float(time_match.group(1))
+            benchmark_summary["Mean Time (% error)"] = float(
+                time_match.group(3)
+            )
+
+    return {**benchmark_summary, **counts_results, **errors_results}
+
+
+def parse_perf_output_file(file_path: Path) -> dict:
+    row = parse_perf_output_stream(iter_lines(file_path))
+    row["File Path"] = str(file_path)  # Add file path to track source
+    return row
+
+
+def perf_output_to_series(file_path: Path) -> pd.Series:
+    return pd.Series(parse_perf_output_file(file_path))
+
+
+def order_columns(columns: Iterable[str]) -> list[str]:
+    """Counts first, then errors (with non-metric columns leading)."""
+    columns = list(columns)
+    count_cols = [col for col in columns if "(% error)" not in col]
+    error_cols = [col for col in columns if "(% error)" in col]
+    return count_cols + error_cols
+
+
+def column_type(column: str) -> pa.DataType:
+    if column in ("Test Name", "File Path"):
+        return pa.string()
+    if "(% error)" in column or column == "Mean Time":
+        return pa.float64()
+    return pa.int64()
+
+
+class FeatherAppender:
+    """
+    Appends rows to a Feather (Arrow IPC file) store one record batch at a
+    time, so memory stays flat however many dumps are ingested. The schema
+    is the union of the columns of every row, as pd.concat would give:
+    a row with new columns (e.g. after a failed or partial first dump)
+    starts a new temporary segment with the widened schema, and close()
+    merges the segments batch by batch, filling missing columns with null.
+    The store only appears at output_path on close(), atomically.
+    """
+
+    def __init__(self, output_path: Path):
+        self.output_path = output_path
+        self.temp_path = output_path.with_suffix(".tmp")
+        self.columns: list[str] = []
+        self.schema: pa.Schema | None = None
+        self.segments: list[Path] = []
+        self._writer = None
+        self._sink = None
+        self.num_rows = 0
+
+    def _open_segment(self):
+        self._close_segment()
+        self.schema = pa.schema(
+            [(col, column_type(col)) for col in order_columns(self.columns)]
+        )
+        path = self.temp_path.with_suffix(f".{len(self.segments)}.tmp")
+        self.segments.append(path)
+        self._sink = pa.OSFile(str(path), "wb")
+        self._writer = ipc.new_file(
+            self._sink,
+            self.schema,
+            options=ipc.IpcWriteOptions(compression="lz4"),
         )
 
-    return counts_results, errors_results
-
-
-def perf_output_to_series(file_path: Path):
-    with file_path.open(mode="r", encoding="utf-8", errors="ignore") as file:
-        output = file.read()
-
-    benchmark_summary = parse_benchmark_results(output)
-    counts_results, errors_results = parse_performance_counters(output)
-
-    combined_results = {
-        **benchmark_summary,
-        **counts_results,
-        **errors_results,
-    }
-    return pd.Series(combined_results)
+    def _close_segment(self):
+        if self._writer is not None:
+            self._writer.close()
+            self._sink.close()
+            self._writer = None
+            self._sink = None
+
+    def append(self, row: dict):
+        new_columns = [col for col in row if col not in self.columns]
+        if new_columns or self._writer is None:
+            self.columns.extend(new_columns)
+            self._open_segment()
+
+        batch = pa.record_batch(
+            [
+                pa.array([row.get(field.name)], type=field.type)
+                for field in self.schema
+            ],
+            schema=self.schema,
+        )
+        self._writer.write_batch(batch)
+        self.num_rows += 1
+
+    def _merge_segments(self):
+        """Rewrites every segment under the final (widest) schema."""
+        with pa.OSFile(str(self.temp_path), "wb") as sink:
+            with ipc.new_file(
+                sink,
+                self.schema,
+                options=ipc.IpcWriteOptions(compression="lz4"),
+            ) as writer:
+                for segment in self.segments:
+                    with pa.memory_map(str(segment)) as source:
+                        reader = ipc.open_file(source)
+                        for i in range(reader.num_record_batches):
+                            batch = reader.get_batch(i)
+                            writer.write_batch(
+                                pa.record_batch(
+                                    [
+                                        batch.column(field.name)
+                                        if field.name in batch.schema.names
+                                        else pa.nulls(
+                                            batch.num_rows, type=field.type
+                                        )
+                                        for field in self.schema
+                                    ],
+                                    schema=self.schema,
+                                )
+                            )
+
+    def _remove_segments(self):
+        for segment in self.segments:
+            segment.unlink(missing_ok=True)
+
+    def close(self):
+        if not self.segments:
+            return
+        self._close_segment()
+        if len(self.segments) == 1:
+            self.segments[0].replace(self.temp_path)
+        else:
+            self._merge_segments()
+        self._remove_segments()
+        self.temp_path.replace(self.output_path)  # Atomically replace
+        print(f"DataFrame saved to {self.output_path} ({self.num_rows} rows)")
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        if exc_type is None:
+            self.close()
+        else:
+            self._close_segment()
+            self._remove_segments()
+            self.temp_path.unlink(missing_ok=True)
+
+
+def default_num_workers() -> int:
+    return max(1, (os.cpu_count() or 1) - 1)
+
+
+def stream_perf_outputs_to_feather(
+    file_paths: list[Path],
+    output_path: Path,
+    max_workers: int | None = None,
+):
+    """
+    Parses perf dumps in parallel and writes each result to disk as soon as
+    it is available, in input order; output_path is complete on return.
+    """
+    file_paths = sorted(file_paths)
+    with FeatherAppender(output_path) as appender:
+        with ProcessPoolExecutor(
+            max_workers=max_workers or default_num_workers()
+        ) as executor:
+            for row in executor.map(parse_perf_output_file, file_paths):
+                appender.append(row)
 
 
 def stack_perf_outputs(file_paths: list[Path]) -> pd.DataFrame:
-    series_list = []
-    for file_path in file_paths:
-        perf_series = perf_output_to_series(file_path)
-        perf_series["File Path"] = str(
-            file_path
-        )  # Add file path to track source
-        series_list.append(perf_series)
-
-    df = pd.DataFrame(series_list)
-
-    # Reset index to ensure it's clean before writing
-    df = df.reset_index(drop=True)
-
-    # Reorder columns: counts first, then errors
-    count_cols = [col for col in df.columns if "(% error)" not in col]
-    error_cols = [col for col in df.columns if "(% error)" in col]
-    other_cols = [
-        col for col in df.columns if col not in count_cols + error_cols
-    ]
-
-    ordered_cols = other_cols + count_cols + error_cols
-    df = df[ordered_cols]
-
-    return df
+    rows = [parse_perf_output_file(file_path) for file_path in file_paths]
+    df = pd.DataFrame(rows).reset_index(drop=True)
+    return df[order_columns(df.columns)]
 
 
 def save_dataframe_to_feather(df: pd.DataFrame, output_path: Path):
     temp_path = output_path.with_suffix(".tmp")  # Create a temporary file
 
-    # print("\n🔍 DEBUG: DataFrame Before Writing to Feather:")
-    # print(df.head(), "\nTotal Rows:", len(df))  # Print first few rows for debugging
-
     df.reset_index(
         drop=True, inplace=True
     )  # Reset index to avoid index issues
@@ -122,40 +301,38 @@ def save_dataframe_to_feather(df: pd.DataFrame, output_path: Path):
     print(f"DataFrame saved to {output_path}")
 
 
-def build_detail_and_summary_dfs(data_dir: Path):
+def build_detail_and_summary_dfs(data_dir: Path, max_workers: int = None):
     print(f"Building Dataframe from detailed perf output...")
     detailed_perf_output_files = [
         path
-        for path in list(data_dir.iterdir())
+        for path in data_dir.iterdir()
         if path.suffix == ".txt" and "summary" not in path.name
     ]
-    detailed_feather_output_path = data_dir / "perf_detailed_runs.feather"
-    detailed_run_dataframe = stack_perf_outputs(detailed_perf_output_files)
-    save_dataframe_to_feather(
-        detailed_run_dataframe, detailed_feather_output_path
+    stream_perf_outputs_to_feather(
+        detailed_perf_output_files,
+        data_dir / "perf_detailed_runs.feather",
+        max_workers=max_workers,
     )
 
     print(f"Building Dataframe from summary perf output...")
     summary_perf_output_files = [
         path
-        for path in list(data_dir.iterdir())
+        for path in data_dir.iterdir()
         if path.suffix == ".txt" and "summary" in path.name
     ]
-    summary_feather_output_path = data_dir / "perf_summary_runs.feather"
-    summary_run_dataframe = stack_perf_outputs(summary_perf_output_files)
-    save_dataframe_to_feather(
-        summary_run_dataframe, summary_feather_output_path
+    stream_perf_outputs_to_feather(
+        summary_perf_output_files,
+        data_dir / "perf_summary_runs.feather",
+        max_workers=max_workers,
     )
 
 
-
 def load_dataframe_from_feather(input_path: Path) -> pd.DataFrame:
     df = feather.read_feather(input_path)
 
     return df
 
 
-
 if __name__ == "__main__":
     my_data_dir = (
         Path(__file__).parent.parent.parent / "data" / "perf" / "2025-03-19_12-29-06_O3"
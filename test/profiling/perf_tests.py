@@ -4,7 +4,30 @@ import json
 from dataclasses import dataclass
 from datetime import datetime
 from pathlib import Path
+import pandas as pd
 import perf_data_cleaner as pdc
+import result_cache as rc
+from benchmark_server_client import BenchmarkServerClient
+
+TEST_CATEGORIES_JSON = Path(__file__).parent / "test_categories.json"
+
+
+def load_test_categories(path: Path = TEST_CATEGORIES_JSON) -> dict:
+    with path.open() as f:
+        return json.load(f)
+
+
+def compute_functions_help() -> str:
+    """
+    Help for -c. The default matrix is "compute_functions"; the streaming
+    and approximate kernels are only run when listed explicitly.
+    """
+    categories = load_test_categories()
+    return (
+        "List of compute functions to test (default = "
+        f"{', '.join(categories['compute_functions'])}; opt-in: "
+        f"{', '.join(categories.get('opt_in_compute_functions', []))})."
+    )
 
 
 def parse_arguments():
@@ -25,8 +48,8 @@ def parse_arguments():
         "-c",
         "--compute_functions",
         nargs="+",
-        default=["fma", "expensive"],
-        help="List of compute functions to test (default: fma expensive)",
+        default=load_test_categories()["compute_functions"],
+        help=compute_functions_help(),
     )
     parser.add_argument(
         "-r",
@@ -49,9 +72,63 @@ def parse_arguments():
         default=None,
         help="Suffix to append to the output directory name (default: None)",
     )
+    parser.add_argument(
+        "-S",
+        "--server",
+        action="store_true",
+        help="Run every job in one `benchmark --server` process with "
+        "per-job hardware counters, instead of one `perf stat` launch per "
+        "condition",
+    )
+    add_cache_arguments(parser)
     return parser.parse_args()
 
 
+def add_cache_arguments(parser: argparse.ArgumentParser):
+    parser.add_argument(
+        "--cache_dir",
+        type=Path,
+        default=rc.DEFAULT_CACHE_DIR,
+        help="Result cache shared with `benchmark --cache` "
+        "(default: ./data/cache)",
+    )
+    parser.add_argument(
+        "--max_age_hours",
+        type=float,
+        default=rc.DEFAULT_MAX_AGE_SECONDS / 3600,
+        help="Reuse cached results up to this old (default: 168)",
+    )
+    parser.add_argument(
+        "--no_cache",
+        action="store_true",
+        help="Measure every condition from scratch",
+    )
+
+
+def cache_from_arguments(args: argparse.Namespace) -> rc.ResultCache | None:
+    if args.no_cache:
+        return None
+    return rc.ResultCache(
+        cache_dir=args.cache_dir, max_age_seconds=args.max_age_hours * 3600
+    )
+
+
+# Events `perf stat` reports by default, requested explicitly so that the
+# summary runs can also use CSV output. duration_time supplies wall time,
+# which `perf stat -x` otherwise omits.
+SUMMARY_PERF_EVENTS = [
+    "duration_time",
+    "task-clock",
+    "context-switches",
+    "cpu-migrations",
+    "page-faults",
+    "cycles",
+    "instructions",
+    "branches",
+    "branch-misses",
+]
+
+
 @dataclass
 class TestCondition:
     polymorphism_type: str
@@ -69,16 +146,19 @@ class PerfTestRunner:
         test_condition: TestCondition,
         perf_categories: list[str] = None,
         extra_perf_events: list[str] = None,
-        test_categories_json: Path = Path(__file__).parent
-        / "test_categories.json",
+        test_categories_json: Path = TEST_CATEGORIES_JSON,
         perf_events_json: Path = Path(__file__).parent / "perf_events.json",
         dir_suffix: str = None,
         output_dir: Path = None,
         seq_id: int = 1,
         output_filename: str = None,
         summary_output_filename: str = None,
+        cache: rc.ResultCache = None,
+        cache_identity: dict = None,
     ):
         self.test_condition = test_condition
+        self.cache = cache
+        self.cache_identity = cache_identity
         self.perf_events_json = perf_events_json
         self.perf_categories = perf_categories or [
             item
@@ -153,13 +233,14 @@ class PerfTestRunner:
         for category in self.perf_categories:
             events_to_run.extend(self.standard_perf_events.get(category, []))
         events_to_run.extend(self.extra_perf_events)
+        if "duration_time" not in events_to_run:
+            events_to_run.insert(0, "duration_time")
         return events_to_run
 
     @property
     def test_categories(self) -> dict:
         # Load test categories from JSON file
-        with self.test_categories_json.open() as f:
-            return json.load(f)
+        return load_test_categories(self.test_categories_json)
 
     @property
     def is_valid_polymorphism_type(self) -> bool:
@@ -169,9 +250,10 @@ class PerfTestRunner:
 
     @property
     def is_valid_compute_function(self) -> bool:
-        return self.compute_function in self.test_categories.get(
+        categories = self.test_categories
+        return self.compute_function in categories.get(
             "compute_functions", []
-        )
+        ) + categories.get("opt_in_compute_functions", [])
 
     @property
     def is_valid_test(self) -> bool:
@@ -187,6 +269,8 @@ class PerfTestRunner:
             "stat",
             "-r",
             str(self.num_runs),
+            "-x",
+            pdc.PERF_CSV_SEPARATOR,
             "-e",
             ",".join(self.perf_events_to_run),
             "./build/bin/benchmark",
@@ -205,6 +289,10 @@ class PerfTestRunner:
             "stat",
             "-r",
             str(self.num_runs),
+            "-x",
+            pdc.PERF_CSV_SEPARATOR,
+            "-e",
+            ",".join(SUMMARY_PERF_EVENTS),
             "./build/bin/benchmark",
             self.polymorphism_type,
             self.compute_function,
@@ -229,26 +317,44 @@ class PerfTestRunner:
         print(self.test_run_header)
 
         print("Running perf to collect detailed event data...")
-        with self.output_path.open(mode="w") as output_file:
-            process = subprocess.run(
-                self.command,
-                stdout=subprocess.PIPE,
-                stderr=subprocess.STDOUT,
-                text=True,
-            )
-            output_file.write(process.stdout)
+        self.run_perf(self.command, self.output_path)
         print(f"Results saved to: {self.output_path}")
 
         print("Re-running perf to collect summary data...")
-        with self.summary_output_path.open(mode="w") as summary_file:
-            process = subprocess.run(
-                self.summary_command,
-                stdout=subprocess.PIPE,
+        self.run_perf(self.summary_command, self.summary_output_path)
+        print(f"Results saved to: {self.summary_output_path}")
+
+    def cache_key(self, command: list[str]) -> str:
+        # The perf stat invocation (without sudo) is the job: events, runs,
+        # test and iterations
+        job = " ".join(command[1:] if command[0] == "sudo" else command)
+        return self.cache.make_key(self.cache_identity, job)
+
+    def run_perf(self, command: list[str], output_path: Path):
+        """
+        Writes perf's output to output_path, reusing a fresh cached copy if
+        the cache has one, and caches new output if perf succeeded.
+        """
+        key = None
+        if self.cache is not None:
+            if self.cache_identity is None:
+                self.cache_identity = rc.binary_identity()
+            key = self.cache_key(command)
+            payload = self.cache.lookup(key)
+            if payload is not None:
+                output_path.write_text(payload)
+                print("♻️  Reused cached results")
+                return
+
+        # Output goes straight to disk rather than being buffered in memory
+        with output_path.open(mode="w") as output_file:
+            completed = subprocess.run(
+                command,
+                stdout=output_file,
                 stderr=subprocess.STDOUT,
-                text=True,
             )
-            summary_file.write(process.stdout)
-        print(f"Results saved to: {self.summary_output_path}")
+        if key is not None and completed.returncode == 0:
+            self.cache.store(key, output_path.read_text())
 
 
 class MultiTestRunner:
@@ -259,12 +365,16 @@ class MultiTestRunner:
         num_runs_per_condition: int = 5,
         dir_suffix: str = None,
         num_iterations_per_run: int = 1000000000,
+        cache: rc.ResultCache = None,
     ):
         self.polymorphism_types = polymorphism_types
         self.compute_functions = compute_functions
         self.num_runs_per_condition = num_runs_per_condition
         self.num_iterations_per_run = num_iterations_per_run
         self.dir_suffix = dir_suffix
+        self.cache = cache
+        # Read once per runner, after the binary has been built
+        self.cache_identity = rc.binary_identity() if cache else None
         self.output_dir = PerfTestRunner.create_output_directory(
             dir_suffix=dir_suffix
         )
@@ -291,6 +401,8 @@ class MultiTestRunner:
                     test_condition=self.test_conditions[idx],
                     output_dir=self.output_dir,
                     seq_id=idx + 1,
+                    cache=self.cache,
+                    cache_identity=self.cache_identity,
                 )
             )
         return runner_list
@@ -299,6 +411,61 @@ class MultiTestRunner:
         for test_runner in self.test_runners:
             test_runner.run_tests()
 
+    @property
+    def server_jobs(self) -> list[dict]:
+        return [
+            {
+                "id": f"{idx + 1}.{run + 1}",
+                "mode": "run",
+                "category": condition.polymorphism_type,
+                "computation": condition.compute_function,
+                "iterations": condition.num_iterations_per_run,
+                "run": run + 1,
+            }
+            for idx, condition in enumerate(self.test_conditions)
+            for run in range(condition.num_runs)
+        ]
+
+    def run_tests_with_server(self) -> Path:
+        """
+        Runs all conditions in one warm benchmark process. Each result line
+        is appended to server_results.jsonl as it arrives, then the results
+        are flattened into perf_server_runs.feather (one row per run, one
+        column per counter).
+        """
+        jsonl_path = self.output_dir / "server_results.jsonl"
+        rows = []
+        cache_args = []
+        if self.cache is not None:
+            cache_args = [
+                "--cache",
+                str(self.cache.cache_dir),
+                "--cache-max-age",
+                str(int(self.cache.max_age_seconds)),
+            ]
+        client = BenchmarkServerClient(extra_args=cache_args)
+        with client, jsonl_path.open("w") as jsonl:
+            print(f"Benchmark server ready: {client.ready}")
+            for result in client.run_jobs(self.server_jobs):
+                jsonl.write(json.dumps(result) + "\n")
+                jsonl.flush()
+                if result.get("status") != "ok":
+                    print(f"❌ Job {result.get('id')} failed: {result.get('error')}")
+                    continue
+                cached = " (cached)" if result.get("cached") else ""
+                print(
+                    f"✅ {result['id']}: {result['category']} "
+                    f"{result['computation']} {result['seconds']:.4f} s{cached}"
+                )
+                counters = result.pop("counters", {})
+                rows.append({**result, **counters})
+        print(f"Results saved to: {jsonl_path}")
+
+        feather_path = self.output_dir / "perf_server_runs.feather"
+        if rows:
+            pdc.save_dataframe_to_feather(pd.DataFrame(rows), feather_path)
+        return feather_path
+
 
 if __name__ == "__main__":
     args = parse_arguments()
@@ -309,7 +476,10 @@ if __name__ == "__main__":
         num_runs_per_condition=args.runs_per_condition,
         num_iterations_per_run=args.iterations_per_run,
         dir_suffix=args.dir_suffix,
+        cache=cache_from_arguments(args),
     )
-    multi_test_runner.run_tests()
-
-    pdc.build_detail_and_summary_dfs(data_dir=multi_test_runner.output_dir)
+    if args.server:
+        multi_test_runner.run_tests_with_server()
+    else:
+        multi_test_runner.run_tests()
+        pdc.build_detail_and_summary_dfs(data_dir=multi_test_runner.output_dir)
@@ -37,6 +37,7 @@ class ProjectBuilder:
             "ENABLE_NO_INLINE": "OFF",
             "ENABLE_PROFILING": "OFF",
             "ENABLE_CONCEPT_ERROR_DETAIL": "OFF",
+            "ENABLE_TRACING": "OFF",
         }
 
     @property
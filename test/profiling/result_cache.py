@@ -0,0 +1,90 @@
+import json
+import os
+import subprocess
+import time
+from pathlib import Path
+
+DEFAULT_CACHE_DIR = Path(__file__).parent.parent.parent / "data" / "cache"
+DEFAULT_MAX_AGE_SECONDS = 7 * 24 * 60 * 60
+
+# Must match include/result_cache.hpp so both sides share entries
+KEY_VERSION = "v1"
+FNV_OFFSET = 0xCBF29CE484222325
+FNV_PRIME = 0x100000001B3
+
+
+def fnv1a(data: bytes) -> str:
+    """64-bit FNV-1a as 16 hex digits."""
+    value = FNV_OFFSET
+    for byte in data:
+        value = ((value ^ byte) * FNV_PRIME) & 0xFFFFFFFFFFFFFFFF
+    return f"{value:016x}"
+
+
+def binary_identity(executable: Path = Path("./build/bin/benchmark")) -> dict:
+    """
+    The binary hash, compiler flags and CPU model a result depends on, as
+    reported by `benchmark --cache-info`. Asking the binary keeps the hash
+    and flags in one place, and a rebuild changes them.
+    """
+    completed = subprocess.run(
+        [str(executable), "--cache-info"],
+        capture_output=True,
+        text=True,
+        check=True,
+    )
+    return json.loads(completed.stdout)
+
+
+class ResultCache:
+    """
+    Content-addressed results: each entry is <dir>/<digest>.entry, the key
+    on the first line and the payload after it. The key covers the binary
+    identity and the job, so a rebuild or a changed parameter misses, and
+    entries older than max_age_seconds are re-measured.
+    """
+
+    def __init__(
+        self,
+        cache_dir: Path = DEFAULT_CACHE_DIR,
+        max_age_seconds: float = DEFAULT_MAX_AGE_SECONDS,
+    ):
+        self.cache_dir = Path(cache_dir)
+        self.max_age_seconds = max_age_seconds
+
+    @staticmethod
+    def make_key(identity: dict, job: str) -> str:
+        """One line: version, identity fields and job, separated by tabs."""
+        fields = [
+            identity["binary_hash"],
+            identity["compiler_flags"],
+            identity["cpu_model"],
+            job,
+        ]
+        separators = str.maketrans("\t\n\r", "   ")
+        return "\t".join(
+            [KEY_VERSION, *(field.translate(separators) for field in fields)]
+        )
+
+    def entry_path(self, key: str) -> Path:
+        return self.cache_dir / f"{fnv1a(key.encode())}.entry"
+
+    def lookup(self, key: str) -> str | None:
+        path = self.entry_path(key)
+        try:
+            if time.time() - path.stat().st_mtime > self.max_age_seconds:
+                return None
+            stored_key, _, payload = path.read_bytes().partition(b"\n")
+        except FileNotFoundError:
+            return None
+        if stored_key.decode() != key:
+            return None
+        return payload.decode()
+
+    def store(self, key: str, payload: str):
+        """Writes through a temporary file so readers never see half an entry."""
+        self.cache_dir.mkdir(parents=True, exist_ok=True)
+        path = self.entry_path(key)
+        temporary = path.with_name(f"{path.name}.tmp.{os.getpid()}")
+        temporary.write_bytes(key.encode() + b"\n" + payload.encode())
+        temporary.replace(path)